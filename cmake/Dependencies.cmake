@@ -1,7 +1,7 @@
 # Dependencies configuration
 
 # Find Qt
-find_package(Qt6 REQUIRED COMPONENTS Core Quick QuickControls2 Widgets)
+find_package(Qt6 REQUIRED COMPONENTS Core Concurrent Quick QuickControls2 Widgets)
 
 # Qt specific settings
 if(Qt6_FOUND)
@@ -1,12 +1,170 @@
 #include "DataService.h"
-#include <QUuid>
 #include <QRegularExpression>
 #include <QVariant>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace {
+// Below this many items the serial path wins over task overhead.
+constexpr qsizetype kParallelThreshold = 8192;
+
+QList<int> taskIndexes(int count)
+{
+    QList<int> indexes(count);
+    std::iota(indexes.begin(), indexes.end(), 0);
+    return indexes;
+}
+
+// Split point for a stable merge of a[0, m) and b[0, n): the i, j with
+// i + j == k such that a[0, i) and b[0, j) are the first k merged elements.
+template <typename T, typename Compare>
+std::pair<qsizetype, qsizetype> coRank(qsizetype k, const T *a, qsizetype m, const T *b, qsizetype n, Compare lessThan)
+{
+    qsizetype i = qMin(k, m);
+    qsizetype j = k - i;
+    qsizetype iLow = qMax<qsizetype>(0, k - n);
+    qsizetype jLow = qMax<qsizetype>(0, k - m);
+
+    while (true) {
+        if (i > 0 && j < n && lessThan(b[j], a[i - 1])) {
+            // Took too many from a
+            const qsizetype delta = (i - iLow + 1) / 2;
+            jLow = j;
+            i -= delta;
+            j += delta;
+        } else if (j > 0 && i < m && !lessThan(b[j - 1], a[i])) {
+            // Took too many from b; equal elements of a go first
+            const qsizetype delta = (j - jLow + 1) / 2;
+            iLow = i;
+            i += delta;
+            j -= delta;
+        } else {
+            return {i, j};
+        }
+    }
+}
+
+// Stable parallel merge sort: sort one chunk per thread, then merge pairs of
+// runs, splitting every merge by co-rank so each round uses all threads.
+template <typename T, typename Compare>
+void parallelSort(QList<T> &items, Compare lessThan, QThreadPool *pool)
+{
+    const qsizetype n = items.size();
+    const int threads = qMax(1, pool->maxThreadCount());
+    if (threads == 1 || n < kParallelThreshold) {
+        std::stable_sort(items.begin(), items.end(), lessThan);
+        return;
+    }
+
+    const int chunks = threads;
+    QList<qsizetype> bounds;
+    bounds.reserve(chunks + 1);
+    for (int c = 0; c <= chunks; ++c) {
+        bounds.append(n * c / chunks);
+    }
+
+    T *data = items.data();
+    QtConcurrent::blockingMap(pool, taskIndexes(chunks), [&](int c) {
+        std::stable_sort(data + bounds[c], data + bounds[c + 1], lessThan);
+    });
+
+    QList<T> buffer(n);
+    T *source = data;
+    T *target = buffer.data();
+
+    for (int width = 1; width < chunks; width *= 2) {
+        struct Part {
+            qsizetype lo, mid, hi, outFirst, outLast;
+            std::pair<qsizetype, qsizetype> first, last;
+        };
+        QList<Part> parts;
+        const int merges = (chunks + 2 * width - 1) / (2 * width);
+        const int partsPerMerge = qMax(1, threads / merges);
+        for (int c = 0; c < chunks; c += 2 * width) {
+            const qsizetype lo = bounds[c];
+            const qsizetype mid = bounds[qMin(c + width, chunks)];
+            const qsizetype hi = bounds[qMin(c + 2 * width, chunks)];
+            for (int p = 0; p < partsPerMerge; ++p) {
+                parts.append({lo, mid, hi,
+                              (hi - lo) * p / partsPerMerge,
+                              (hi - lo) * (p + 1) / partsPerMerge});
+            }
+        }
+
+        // Every split point is found before any part starts moving elements
+        // out of the runs the other parts are still searching.
+        QtConcurrent::blockingMap(pool, parts, [&](Part &part) {
+            const T *a = source + part.lo;
+            const T *b = source + part.mid;
+            const qsizetype m = part.mid - part.lo;
+            const qsizetype nb = part.hi - part.mid;
+            part.first = coRank(part.outFirst, a, m, b, nb, lessThan);
+            part.last = coRank(part.outLast, a, m, b, nb, lessThan);
+        });
+
+        QtConcurrent::blockingMap(pool, parts, [&](const Part &part) {
+            std::merge(std::make_move_iterator(source + part.lo + part.first.first),
+                       std::make_move_iterator(source + part.lo + part.last.first),
+                       std::make_move_iterator(source + part.mid + part.first.second),
+                       std::make_move_iterator(source + part.mid + part.last.second),
+                       target + part.lo + part.outFirst, lessThan);
+        });
+        std::swap(source, target);
+    }
+
+    if (source != data) {
+        std::move(source, source + n, data);
+    }
+}
+
+template <typename Key>
+struct KeyedRow {
+    Key key;
+    int row;
+};
+
+template <typename Key, typename Extract>
+QList<int> sortRowsByKey(const QList<int> &rows, Extract extract, bool ascending, QThreadPool *pool)
+{
+    QList<KeyedRow<Key>> keyed(rows.size());
+    KeyedRow<Key> *out = keyed.data();
+    const int chunks = rows.size() < kParallelThreshold ? 1 : qMax(1, pool->maxThreadCount());
+    QtConcurrent::blockingMap(pool, taskIndexes(chunks), [&](int c) {
+        const qsizetype first = rows.size() * c / chunks;
+        const qsizetype last = rows.size() * (c + 1) / chunks;
+        for (qsizetype i = first; i < last; ++i) {
+            out[i] = {extract(rows[i]), rows[i]};
+        }
+    });
+
+    if (ascending) {
+        parallelSort(keyed, [](const KeyedRow<Key> &a, const KeyedRow<Key> &b) { return a.key < b.key; }, pool);
+    } else {
+        parallelSort(keyed, [](const KeyedRow<Key> &a, const KeyedRow<Key> &b) { return b.key < a.key; }, pool);
+    }
+
+    QList<int> sorted;
+    sorted.reserve(keyed.size());
+    for (const KeyedRow<Key> &entry : std::as_const(keyed)) {
+        sorted.append(entry.row);
+    }
+    return sorted;
+}
+}
 
 
 DataService::DataService(QObject *parent)
     : QObject(parent)
+    , m_idGenerator(new IdGenerator(IdGenerator::Snowflake))
+    , m_pool(new QThreadPool(this))
 {
+    m_itemValidator
+        .addTextRule("name", 2, 50, "[a-zA-Z0-9\\s\\-_.]+")
+        .addRangeRule("value", 0, 1000);
+
     qDebug() << "DataService initialized";
 }
 
@@ -17,32 +175,66 @@ DataService::~DataService()
 
 bool DataService::validateItemName(const QString &name) const
 {
-    if (name.isEmpty()) return false;
-    if (name.length() < 2 || name.length() > 50) return false;
-
-    // Check for valid characters (letters, numbers, spaces, basic punctuation)
-    QRegularExpression regex("^[a-zA-Z0-9\\s\\-_.]+$");
-    return regex.match(name).hasMatch();
+    return m_itemValidator.isValidText("name", name);
 }
 
 bool DataService::validateItemValue(int value) const
 {
-    return value >= 0 && value <= 1000; // Example validation rules
+    return m_itemValidator.isValidNumber("value", value);
 }
 
-QString DataService::generateItemId() const
+QBitArray DataService::validateItems(const QVariantList &items, int *invalidCount) const
 {
-    QString id;
-    do {
-        id = QUuid::createUuid().toString(QUuid::WithoutBraces).left(8);
-    } while (!isItemIdUnique(id));
+    return m_itemValidator.validateBatch(items, invalidCount);
+}
 
-    return id;
+const DataValidator &DataService::itemValidator() const
+{
+    return m_itemValidator;
+}
+
+QString DataService::generateItemId() const
+{
+    // Registered ids have been claimed by the generator, so no retry loop is needed.
+    return m_idGenerator->nextId();
 }
 
 bool DataService::isItemIdUnique(const QString &id) const
 {
-    return !m_existingIds.contains(id);
+    return !m_existingIds.contains(id) && !m_idGenerator->isTaken(id);
+}
+
+void DataService::registerItemId(const QString &id)
+{
+    m_existingIds.insert(id);
+    m_idGenerator->claim(id);
+}
+
+void DataService::registerItemIds(const QStringList &ids)
+{
+    m_existingIds.reserve(m_existingIds.size() + ids.size());
+    for (const QString &id : ids) {
+        registerItemId(id);
+    }
+}
+
+void DataService::setIdStrategy(IdGenerator::Strategy strategy)
+{
+    if (strategy == m_idGenerator->strategy()) {
+        return;
+    }
+    // The new generator must not hand out ids the old one already issued.
+    QScopedPointer<IdGenerator> generator(new IdGenerator(strategy));
+    generator->takeOver(*m_idGenerator);
+    for (const QString &id : std::as_const(m_existingIds)) {
+        generator->claim(id);
+    }
+    m_idGenerator.swap(generator);
+}
+
+IdGenerator::Strategy DataService::idStrategy() const
+{
+    return m_idGenerator->strategy();
 }
 
 QVariantMap DataService::processItemData(const QVariantMap &inputData) const
@@ -53,9 +245,7 @@ QVariantMap DataService::processItemData(const QVariantMap &inputData) const
     result["processedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
     // Add validation status
-    bool nameValid = validateItemName(inputData["name"].toString());
-    bool valueValid = validateItemValue(inputData["value"].toInt());
-    result["isValid"] = nameValid && valueValid;
+    result["isValid"] = m_itemValidator.isValid(inputData);
 
     return result;
 }
@@ -64,40 +254,119 @@ QVariantList DataService::filterItems(const QVariantList &items, const QString &
 {
     if (filter.isEmpty()) return items;
 
-    QVariantList filtered;
-    QString lowerFilter = filter.toLower();
+    auto matches = [&filter](const QVariant &item) {
+        const QVariantMap itemMap = item.toMap();
+        return itemMap["name"].toString().contains(filter, Qt::CaseInsensitive)
+            || itemMap["description"].toString().contains(filter, Qt::CaseInsensitive);
+    };
 
-    for (const QVariant &item : items) {
-        QVariantMap itemMap = item.toMap();
-        QString name = itemMap["name"].toString().toLower();
-        QString description = itemMap["description"].toString().toLower();
+    if (items.size() >= kParallelThreshold && m_pool->maxThreadCount() > 1) {
+        return QtConcurrent::blockingFiltered(m_pool, items, matches);
+    }
 
-        if (name.contains(lowerFilter) || description.contains(lowerFilter)) {
+    QVariantList filtered;
+    for (const QVariant &item : items) {
+        if (matches(item)) {
             filtered.append(item);
         }
     }
-
     return filtered;
 }
 
 QVariantList DataService::sortItems(const QVariantList &items, const QString &sortBy, bool ascending) const
 {
-    QVariantList sorted = items;
-
-    std::sort(sorted.begin(), sorted.end(),
-        [sortBy, ascending](const QVariant &a, const QVariant &b) {
-            QVariantMap aMap = a.toMap();
-            QVariantMap bMap = b.toMap();
+    // Extract each key once instead of converting both maps on every comparison.
+    QList<KeyedRow<QVariant>> keyed(items.size());
+    KeyedRow<QVariant> *out = keyed.data();
+    const int chunks = items.size() < kParallelThreshold ? 1 : qMax(1, m_pool->maxThreadCount());
+    QtConcurrent::blockingMap(m_pool, taskIndexes(chunks), [&](int c) {
+        const qsizetype first = items.size() * c / chunks;
+        const qsizetype last = items.size() * (c + 1) / chunks;
+        for (qsizetype i = first; i < last; ++i) {
+            out[i] = {items[i].toMap().value(sortBy), int(i)};
+        }
+    });
 
-            QVariant aValue = aMap[sortBy];
-            QVariant bValue = bMap[sortBy];
+    parallelSort(keyed,
+        [ascending](const KeyedRow<QVariant> &a, const KeyedRow<QVariant> &b) {
+            const QVariant &aValue = a.key;
+            const QVariant &bValue = b.key;
 
             if (aValue.userType() == QMetaType::Int && bValue.userType() == QMetaType::Int) {
                 return ascending ? aValue.toInt() < bValue.toInt() : aValue.toInt() > bValue.toInt();
             } else {
                 return ascending ? aValue.toString() < bValue.toString() : aValue.toString() > bValue.toString();
             }
-        });
+        }, m_pool);
 
+    QVariantList sorted;
+    sorted.reserve(items.size());
+    for (const auto &entry : std::as_const(keyed)) {
+        sorted.append(items[entry.row]);
+    }
     return sorted;
-}
\ No newline at end of file
+}
+
+QList<int> DataService::filterRows(const DataColumns &columns, const QString &filter) const
+{
+    const int rowCount = columns.size();
+    const int chunks = (filter.isEmpty() || rowCount < kParallelThreshold) ? 1 : qMax(1, m_pool->maxThreadCount()) * 4;
+
+    // Each chunk collects its own matches; concatenating in chunk order keeps row order.
+    QList<QList<int>> matches(chunks);
+    QList<int> *out = matches.data();
+    QtConcurrent::blockingMap(m_pool, taskIndexes(chunks), [&](int c) {
+        const int first = int(qint64(rowCount) * c / chunks);
+        const int last = int(qint64(rowCount) * (c + 1) / chunks);
+        QList<int> &chunkMatches = out[c];
+        for (int row = first; row < last; ++row) {
+            if (filter.isEmpty()
+                || columns.nameView(row).contains(filter, Qt::CaseInsensitive)
+                || columns.descriptionView(row).contains(filter, Qt::CaseInsensitive)) {
+                chunkMatches.append(row);
+            }
+        }
+    });
+
+    QList<int> rows;
+    if (chunks == 1) {
+        rows = std::move(matches[0]);
+        return rows;
+    }
+    qsizetype total = 0;
+    for (const QList<int> &chunkMatches : std::as_const(matches)) {
+        total += chunkMatches.size();
+    }
+    rows.reserve(total);
+    for (const QList<int> &chunkMatches : std::as_const(matches)) {
+        rows.append(chunkMatches);
+    }
+    return rows;
+}
+
+QList<int> DataService::sortRows(const DataColumns &columns, const QList<int> &rows, SortKey key, bool ascending) const
+{
+    switch (key) {
+    case SortByValue:
+        return sortRowsByKey<int>(rows, [&columns](int row) { return columns.value(row); }, ascending, m_pool);
+    case SortByDescription:
+        return sortRowsByKey<QString>(rows, [&columns](int row) {
+            return columns.descriptionView(row).toString().toCaseFolded();
+        }, ascending, m_pool);
+    case SortByName:
+    default:
+        return sortRowsByKey<QString>(rows, [&columns](int row) {
+            return columns.nameView(row).toString().toCaseFolded();
+        }, ascending, m_pool);
+    }
+}
+
+void DataService::setMaxThreads(int threads)
+{
+    m_pool->setMaxThreadCount(qMax(1, threads));
+}
+
+int DataService::maxThreads() const
+{
+    return m_pool->maxThreadCount();
+}
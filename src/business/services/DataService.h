@@ -4,6 +4,15 @@
 #include <QLoggingCategory>
 #include <QDateTime>
 #include <QMetaType>
+#include <QList>
+#include <QSet>
+#include <QScopedPointer>
+#include "../../data/models/DataColumns.h"
+#include "DataValidator.h"
+#include "IdGenerator.h"
+
+class QThreadPool;
+
 class DataService : public QObject
 {
     Q_OBJECT
@@ -15,18 +24,41 @@ public:
     // Business logic for data operations
     bool validateItemName(const QString &name) const;
     bool validateItemValue(int value) const;
+    // Bit i set when items[i] fails the item rules
+    QBitArray validateItems(const QVariantList &items, int *invalidCount = nullptr) const;
+    const DataValidator &itemValidator() const;
     QString generateItemId() const;
     bool isItemIdUnique(const QString &id) const;
+    // Ids created elsewhere (loaded data, other services) that must never be generated
+    void registerItemId(const QString &id);
+    void registerItemIds(const QStringList &ids);
+    void setIdStrategy(IdGenerator::Strategy strategy);
+    IdGenerator::Strategy idStrategy() const;
 
     // Data processing logic
     QVariantMap processItemData(const QVariantMap &inputData) const;
     QVariantList filterItems(const QVariantList &items, const QString &filter) const;
     QVariantList sortItems(const QVariantList &items, const QString &sortBy, bool ascending = true) const;
 
+    // Typed bulk queries over the model's column store, split across the worker pool
+    enum SortKey {
+        SortByName,
+        SortByDescription,
+        SortByValue
+    };
+    QList<int> filterRows(const DataColumns &columns, const QString &filter) const;
+    QList<int> sortRows(const DataColumns &columns, const QList<int> &rows, SortKey key, bool ascending = true) const;
+
+    void setMaxThreads(int threads);
+    int maxThreads() const;
+
 signals:
     void dataValidated(const QString &itemId, bool isValid);
     void dataProcessed(const QVariantMap &result);
 
 private:
-    QStringList m_existingIds;
+    QSet<QString> m_existingIds;
+    QScopedPointer<IdGenerator> m_idGenerator;
+    QThreadPool *m_pool;
+    DataValidator m_itemValidator;
 };
\ No newline at end of file
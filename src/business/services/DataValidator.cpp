@@ -0,0 +1,224 @@
+#include "DataValidator.h"
+#include "../../data/models/DataColumns.h"
+#include <QDebug>
+
+DataValidator &DataValidator::addTextRule(const QString &field, int minLength, int maxLength,
+                                          const QString &pattern)
+{
+    if (m_rules.size() >= kMaxRules) {
+        qWarning() << "Validation rule limit reached, ignoring text rule for" << field;
+        return *this;
+    }
+
+    Rule rule;
+    rule.kind = TextRule;
+    rule.column = columnFor(field);
+    rule.field = field;
+    rule.minLength = minLength;
+    rule.maxLength = maxLength;
+    if (!pattern.isEmpty()) {
+        rule.pattern.setPattern(QRegularExpression::anchoredPattern(pattern));
+        if (!rule.pattern.isValid()) {
+            qWarning() << "Invalid validation pattern for" << field << rule.pattern.errorString();
+        }
+        rule.pattern.optimize();
+    }
+    m_rules.append(rule);
+    return *this;
+}
+
+DataValidator &DataValidator::addRangeRule(const QString &field, qint64 minimum, qint64 maximum)
+{
+    if (m_rules.size() >= kMaxRules) {
+        qWarning() << "Validation rule limit reached, ignoring range rule for" << field;
+        return *this;
+    }
+
+    Rule rule;
+    rule.kind = RangeRule;
+    rule.column = columnFor(field);
+    rule.field = field;
+    rule.minimum = minimum;
+    rule.maximum = maximum;
+    m_rules.append(rule);
+    return *this;
+}
+
+int DataValidator::ruleCount() const
+{
+    return m_rules.size();
+}
+
+QString DataValidator::ruleDescription(int rule) const
+{
+    const Rule &r = m_rules.at(rule);
+    if (r.kind == RangeRule) {
+        return QStringLiteral("%1 must be between %2 and %3").arg(r.field).arg(r.minimum).arg(r.maximum);
+    }
+    QString description = QStringLiteral("%1 must be %2-%3 characters").arg(r.field).arg(r.minLength).arg(r.maxLength);
+    if (!r.pattern.pattern().isEmpty()) {
+        description += QStringLiteral(" matching ") + r.pattern.pattern();
+    }
+    return description;
+}
+
+quint64 DataValidator::validate(const QVariantMap &record) const
+{
+    quint64 failures = 0;
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const Rule &rule = m_rules[i];
+        const auto it = record.constFind(rule.field);
+        const bool ok = rule.kind == TextRule
+            ? checkText(rule, it == record.constEnd() ? QString() : it->toString())
+            : checkNumber(rule, it == record.constEnd() ? 0 : it->toLongLong());
+        if (!ok) {
+            failures |= quint64(1) << i;
+        }
+    }
+    return failures;
+}
+
+bool DataValidator::isValid(const QVariantMap &record) const
+{
+    return validate(record) == 0;
+}
+
+bool DataValidator::isValidText(const QString &field, const QString &text) const
+{
+    for (const Rule &rule : m_rules) {
+        if (rule.kind == TextRule && rule.field == field && !checkText(rule, text)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DataValidator::isValidNumber(const QString &field, qint64 number) const
+{
+    for (const Rule &rule : m_rules) {
+        if (rule.kind == RangeRule && rule.field == field && !checkNumber(rule, number)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QBitArray DataValidator::validateBatch(const QVariantList &records, int *invalidCount) const
+{
+    QBitArray invalid(records.size());
+    int count = 0;
+    for (int i = 0; i < records.size(); ++i) {
+        if (validate(records[i].toMap()) != 0) {
+            invalid.setBit(i);
+            ++count;
+        }
+    }
+    if (invalidCount) {
+        *invalidCount = count;
+    }
+    return invalid;
+}
+
+QBitArray DataValidator::validateColumns(const DataColumns &columns, int *invalidCount) const
+{
+    QBitArray invalid(columns.size());
+    int count = 0;
+    for (int row = 0; row < columns.size(); ++row) {
+        if (validateColumnRow(columns, row) != 0) {
+            invalid.setBit(row);
+            ++count;
+        }
+    }
+    if (invalidCount) {
+        *invalidCount = count;
+    }
+    return invalid;
+}
+
+bool DataValidator::checkText(const Rule &rule, const QString &text) const
+{
+    if (text.size() < rule.minLength || text.size() > rule.maxLength) {
+        return false;
+    }
+    return rule.pattern.pattern().isEmpty() || rule.pattern.match(text).hasMatch();
+}
+
+bool DataValidator::checkNumber(const Rule &rule, qint64 number) const
+{
+    return number >= rule.minimum && number <= rule.maximum;
+}
+
+quint64 DataValidator::validateColumnRow(const DataColumns &columns, int row) const
+{
+    quint64 failures = 0;
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const Rule &rule = m_rules[i];
+        const bool ok = rule.kind == TextRule
+            ? checkText(rule, columnText(columns, row, rule.column))
+            : checkNumber(rule, columnNumber(columns, row, rule.column));
+        if (!ok) {
+            failures |= quint64(1) << i;
+        }
+    }
+    return failures;
+}
+
+// A column read as validate() reads the same field of the row's record:
+// a missing field is an empty text or 0, and other types convert as QVariant does.
+QString DataValidator::columnText(const DataColumns &columns, int row, Column column)
+{
+    switch (column) {
+    case IdColumn:
+        return columns.id(row);
+    case NameColumn:
+        return columns.name(row);
+    case DescriptionColumn:
+        return columns.description(row);
+    case ValueColumn:
+        return QString::number(columns.value(row));
+    case EnabledColumn:
+        return QVariant(columns.enabled(row)).toString();
+    case NoColumn:
+        break;
+    }
+    return QString();
+}
+
+qint64 DataValidator::columnNumber(const DataColumns &columns, int row, Column column)
+{
+    switch (column) {
+    case IdColumn:
+        return QVariant(columns.id(row)).toLongLong();
+    case NameColumn:
+        return QVariant(columns.name(row)).toLongLong();
+    case DescriptionColumn:
+        return QVariant(columns.description(row)).toLongLong();
+    case ValueColumn:
+        return columns.value(row);
+    case EnabledColumn:
+        return columns.enabled(row) ? 1 : 0;
+    case NoColumn:
+        break;
+    }
+    return 0;
+}
+
+DataValidator::Column DataValidator::columnFor(const QString &field)
+{
+    if (field == QLatin1String("id")) {
+        return IdColumn;
+    }
+    if (field == QLatin1String("name")) {
+        return NameColumn;
+    }
+    if (field == QLatin1String("description")) {
+        return DescriptionColumn;
+    }
+    if (field == QLatin1String("value")) {
+        return ValueColumn;
+    }
+    if (field == QLatin1String("enabled")) {
+        return EnabledColumn;
+    }
+    return NoColumn;
+}
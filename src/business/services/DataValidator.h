@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QBitArray>
+#include <QVariantMap>
+#include <QVariantList>
+#include <QRegularExpression>
+
+class DataColumns;
+
+// Field rules declared once and checked many times. Patterns are compiled
+// (and JIT-optimized) when the rule is added, never per record.
+class DataValidator
+{
+public:
+    // Rules past this many are refused with a warning
+    static constexpr int kMaxRules = 64;
+
+    // Text field whose length lies in [minLength, maxLength] and, when a
+    // pattern is given, matches it in full
+    DataValidator &addTextRule(const QString &field, int minLength, int maxLength,
+                               const QString &pattern = QString());
+    // Numeric field in [minimum, maximum]; a missing field reads as 0
+    DataValidator &addRangeRule(const QString &field, qint64 minimum, qint64 maximum);
+
+    int ruleCount() const;
+    QString ruleDescription(int rule) const;
+
+    // Bit i of the result is set when rule i failed; 0 means valid
+    quint64 validate(const QVariantMap &record) const;
+    bool isValid(const QVariantMap &record) const;
+    bool isValidText(const QString &field, const QString &text) const;
+    bool isValidNumber(const QString &field, qint64 number) const;
+
+    // One bit per record, set when the record failed any rule
+    QBitArray validateBatch(const QVariantList &records, int *invalidCount = nullptr) const;
+    // Same result as validateBatch over the rows' id, name, description,
+    // value and enabled records
+    QBitArray validateColumns(const DataColumns &columns, int *invalidCount = nullptr) const;
+
+private:
+    enum RuleKind {
+        TextRule,
+        RangeRule
+    };
+
+    // DataColumns column a rule reads, resolved once when the rule is added
+    enum Column {
+        NoColumn,
+        IdColumn,
+        NameColumn,
+        DescriptionColumn,
+        ValueColumn,
+        EnabledColumn
+    };
+
+    struct Rule {
+        RuleKind kind;
+        Column column;
+        QString field;
+        int minLength = 0;
+        int maxLength = 0;
+        QRegularExpression pattern;
+        qint64 minimum = 0;
+        qint64 maximum = 0;
+    };
+
+    QList<Rule> m_rules;
+
+    bool checkText(const Rule &rule, const QString &text) const;
+    bool checkNumber(const Rule &rule, qint64 number) const;
+    quint64 validateColumnRow(const DataColumns &columns, int row) const;
+    static QString columnText(const DataColumns &columns, int row, Column column);
+    static qint64 columnNumber(const DataColumns &columns, int row, Column column);
+    static Column columnFor(const QString &field);
+};
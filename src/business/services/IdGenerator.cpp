@@ -0,0 +1,191 @@
+#include "IdGenerator.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QDebug>
+
+namespace {
+// 2024-01-01T00:00:00Z; 41 bits of milliseconds from here last until 2093.
+constexpr qint64 kSnowflakeEpochMs = 1704067200000;
+
+quint64 millisecondsSinceEpoch()
+{
+    return quint64(qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - kSnowflakeEpochMs));
+}
+}
+
+IdGenerator::IdGenerator(Strategy strategy, quint16 node)
+    : m_strategy(strategy)
+    , m_nodeBits(quint64(node & ((1u << kNodeBits) - 1)) << kSequenceBits)
+    , m_last(0)
+    , m_hasReserved(0)
+{
+}
+
+IdGenerator::Strategy IdGenerator::strategy() const
+{
+    return m_strategy;
+}
+
+quint64 IdGenerator::next()
+{
+    switch (m_strategy) {
+    case Counter:
+    case Snowflake:
+        return nextSequential();
+    case Random64:
+        return nextRandom();
+    }
+    return 0;
+}
+
+QString IdGenerator::nextId()
+{
+    return format(next());
+}
+
+bool IdGenerator::claim(const QString &id)
+{
+    quint64 value = 0;
+    if (!parse(id, &value)) {
+        // Not in our format, so no generated id can ever equal it.
+        return true;
+    }
+    if (m_strategy == Random64) {
+        return value > m_last.loadAcquire() && insertValue(value);
+    }
+    if (value <= m_last.loadAcquire() || (m_hasReserved.loadRelaxed() && containsValue(value))) {
+        return false;
+    }
+    if (value > ~quint64(0) - kClaimHeadroom) {
+        // Skipping past it would leave too few ids to generate.
+        qWarning() << "Refusing to reserve id" << id << "near the end of the id space";
+        return false;
+    }
+    advancePast(value);
+    return true;
+}
+
+bool IdGenerator::isTaken(const QString &id) const
+{
+    quint64 value = 0;
+    if (!parse(id, &value)) {
+        return false;
+    }
+    // Everything at or below the last issued value was issued or skipped.
+    if (value != 0 && value <= m_last.loadAcquire()) {
+        return true;
+    }
+    return (m_strategy == Random64 || m_hasReserved.loadRelaxed()) && containsValue(value);
+}
+
+void IdGenerator::takeOver(const IdGenerator &previous)
+{
+    advancePast(previous.m_last.loadAcquire());
+    const quint64 last = m_last.loadAcquire();
+
+    for (const Stripe &stripe : previous.m_stripes) {
+        QSet<quint64> values;
+        {
+            QMutexLocker locker(&stripe.mutex);
+            values = stripe.values;
+        }
+        for (quint64 value : std::as_const(values)) {
+            // Sequential generators only need the ids they have not passed yet.
+            if (m_strategy == Random64 || value > last) {
+                if (m_strategy != Random64) {
+                    m_hasReserved.storeRelaxed(1);
+                }
+                insertValue(value);
+            }
+        }
+    }
+}
+
+QString IdGenerator::format(quint64 value)
+{
+    return QString::number(value, 16).rightJustified(16, QLatin1Char('0'));
+}
+
+bool IdGenerator::parse(const QString &id, quint64 *value)
+{
+    if (id.size() != 16) {
+        return false;
+    }
+    bool ok = false;
+    *value = id.toULongLong(&ok, 16);
+    return ok;
+}
+
+quint64 IdGenerator::nextSequential()
+{
+    for (;;) {
+        const quint64 value = m_strategy == Counter ? m_last.fetchAndAddRelaxed(1) + 1 : nextSnowflake();
+        if (!m_hasReserved.loadRelaxed() || !containsValue(value)) {
+            return value;
+        }
+    }
+}
+
+quint64 IdGenerator::nextSnowflake()
+{
+    constexpr quint64 sequenceMask = (quint64(1) << kSequenceBits) - 1;
+    constexpr int timeShift = kSequenceBits + kNodeBits;
+
+    quint64 last = m_last.loadRelaxed();
+    for (;;) {
+        const quint64 now = (millisecondsSinceEpoch() << timeShift) | m_nodeBits;
+        // A full sequence borrows the next millisecond rather than waiting for it.
+        quint64 candidate = (last & sequenceMask) == sequenceMask
+            ? (((last >> timeShift) + 1) << timeShift) | m_nodeBits
+            : last + 1;
+        candidate = qMax(candidate, now);
+        if (m_last.testAndSetOrdered(last, candidate, last)) {
+            return candidate;
+        }
+    }
+}
+
+quint64 IdGenerator::nextRandom()
+{
+    thread_local QRandomGenerator64 random = QRandomGenerator64::securelySeeded();
+    for (;;) {
+        const quint64 value = random.generate64();
+        if (value != 0 && value > m_last.loadRelaxed() && insertValue(value)) {
+            return value;
+        }
+    }
+}
+
+bool IdGenerator::insertValue(quint64 value)
+{
+    Stripe &stripe = stripeFor(value);
+    QMutexLocker locker(&stripe.mutex);
+    const qsizetype before = stripe.values.size();
+    stripe.values.insert(value);
+    return stripe.values.size() != before;
+}
+
+bool IdGenerator::containsValue(quint64 value) const
+{
+    const Stripe &stripe = stripeFor(value);
+    QMutexLocker locker(&stripe.mutex);
+    return stripe.values.contains(value);
+}
+
+void IdGenerator::advancePast(quint64 value)
+{
+    quint64 last = m_last.loadRelaxed();
+    while (last < value && !m_last.testAndSetOrdered(last, value, last)) {
+    }
+}
+
+IdGenerator::Stripe &IdGenerator::stripeFor(quint64 value)
+{
+    // The low bits of a random id are already uniform.
+    return m_stripes[value % kStripes];
+}
+
+const IdGenerator::Stripe &IdGenerator::stripeFor(quint64 value) const
+{
+    return m_stripes[value % kStripes];
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QString>
+#include <QSet>
+#include <QMutex>
+#include <QAtomicInteger>
+
+// Unique item ids rendered as 16 lowercase hex digits.
+//
+// Counter and Snowflake ids come from one atomic compare-and-swap on a
+// 64-bit state, so generation never blocks. Random64 ids are checked
+// against the set of ids already issued; that set is split into stripes
+// so concurrent generators rarely touch the same lock. A generator that
+// takes over from another keeps everything the other issued out of reach.
+class IdGenerator
+{
+public:
+    enum Strategy {
+        Counter,    // 1, 2, 3, ... for the lifetime of the process
+        Snowflake,  // 41-bit milliseconds | 10-bit node | 12-bit sequence
+        Random64    // uniformly random, never repeated within the process
+    };
+
+    explicit IdGenerator(Strategy strategy = Snowflake, quint16 node = 0);
+
+    Strategy strategy() const;
+
+    quint64 next();
+    QString nextId();
+
+    // Records an id created elsewhere so it is never generated. Returns
+    // false if the id was already taken, or if a Counter or Snowflake
+    // generator would have to skip so close to the end of the id space
+    // that it could run out.
+    bool claim(const QString &id);
+    bool isTaken(const QString &id) const;
+
+    // Reserves every id previous issued or claimed, for a generator that
+    // replaces it.
+    void takeOver(const IdGenerator &previous);
+
+    static QString format(quint64 value);
+    static bool parse(const QString &id, quint64 *value);
+
+private:
+    static constexpr int kStripes = 64;
+    static constexpr int kSequenceBits = 12;
+    static constexpr int kNodeBits = 10;
+    // Counter and Snowflake claims must leave at least this many ids
+    static constexpr quint64 kClaimHeadroom = quint64(1) << 48;
+
+    struct Stripe {
+        mutable QMutex mutex;
+        QSet<quint64> values;
+    };
+
+    Strategy m_strategy;
+    quint64 m_nodeBits;
+    // Counter and Snowflake: the last value issued. Random64: values up to
+    // here were issued by a generator this one took over from.
+    QAtomicInteger<quint64> m_last;
+    // Random64: every id issued or claimed. Counter and Snowflake: ids above
+    // m_last taken over from a Random64 generator, which next() skips.
+    Stripe m_stripes[kStripes];
+    QAtomicInt m_hasReserved;
+
+    quint64 nextSequential();
+    quint64 nextSnowflake();
+    quint64 nextRandom();
+    bool insertValue(quint64 value);
+    bool containsValue(quint64 value) const;
+    void advancePast(quint64 value);
+    Stripe &stripeFor(quint64 value);
+    const Stripe &stripeFor(quint64 value) const;
+};
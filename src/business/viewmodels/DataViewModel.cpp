@@ -1,14 +1,31 @@
 #include "DataViewModel.h"
+#include <QUrl>
 
 DataViewModel::DataViewModel(QObject *parent)
     : QObject(parent)
     , m_model(nullptr)
+    , m_loader(nullptr)
+    , m_journal(nullptr)
+    , m_proxyModel(nullptr)
+    , m_searchIndex(nullptr)
 {
     if (!m_model) {
         qWarning() << "Failed to get data model from ModelManager";
         m_model = new DataModel(this);
     }
 
+    m_proxyModel = new DataProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+
+    m_loader = new DataLoader(m_model, this);
+    connect(m_loader, &DataLoader::runningChanged, this, &DataViewModel::loadingChanged);
+    connect(m_loader, &DataLoader::progressChanged, this, &DataViewModel::loadProgressChanged);
+    connect(m_loader, &DataLoader::finished, this, &DataViewModel::loadFinished);
+    connect(m_loader, &DataLoader::failed, this, &DataViewModel::loadFailed);
+
+    m_journal = new DataJournal(m_model, this);
+    connect(m_journal, &DataJournal::writeFailed, this, &DataViewModel::journalFailed);
+
     qDebug() << "DataViewModel initialized with model:" << m_model;
 }
 
@@ -22,10 +39,15 @@ DataModel* DataViewModel::model() const
     return m_model;
 }
 
+DataProxyModel* DataViewModel::proxyModel() const
+{
+    return m_proxyModel;
+}
+
 void DataViewModel::addItem(const QString &name, const QString &description, int value)
 {
     m_model->addItem(name, description, value);
-    emit itemAdded(m_model->index(m_model->rowCount() - 1).data(DataModel::IdRole).toString());
+    emit itemAdded(m_model->getItem(m_model->getCount() - 1)["id"].toString());
 }
 
 void DataViewModel::removeItem(const QString &id)
@@ -51,6 +73,117 @@ void DataViewModel::clear()
     m_model->clear();
 }
 
+QStringList DataViewModel::addItems(const QVariantList &items)
+{
+    const QStringList ids = m_model->addItems(items);
+    if (!ids.isEmpty()) {
+        emit itemsAdded(ids);
+    }
+    return ids;
+}
+
+int DataViewModel::removeItems(const QStringList &ids)
+{
+    const int removed = m_model->removeItems(ids);
+    if (removed > 0) {
+        emit itemsRemoved(ids);
+    }
+    return removed;
+}
+
+int DataViewModel::updateValues(const QVariantMap &values)
+{
+    const int updated = m_model->updateValues(values);
+    if (updated > 0) {
+        emit itemsUpdated(values.keys());
+    }
+    return updated;
+}
+
+void DataViewModel::beginBatch()
+{
+    m_model->beginBatch();
+}
+
+void DataViewModel::endBatch()
+{
+    m_model->endBatch();
+}
+
+bool DataViewModel::undo()
+{
+    return m_model->undo();
+}
+
+bool DataViewModel::redo()
+{
+    return m_model->redo();
+}
+
+void DataViewModel::loadFile(const QString &filePath)
+{
+    // QML file dialogs hand over URLs
+    const QUrl url(filePath);
+    m_loader->loadFile(url.isLocalFile() ? url.toLocalFile() : filePath);
+}
+
+void DataViewModel::loadGenerated(int count)
+{
+    m_loader->loadGenerated(count);
+}
+
+void DataViewModel::cancelLoading()
+{
+    m_loader->cancel();
+}
+
+bool DataViewModel::isLoading() const
+{
+    return m_loader->isRunning();
+}
+
+qreal DataViewModel::loadProgress() const
+{
+    return m_loader->progress();
+}
+
+bool DataViewModel::saveSnapshot(const QString &filePath) const
+{
+    const QUrl url(filePath);
+    return m_model->saveSnapshot(url.isLocalFile() ? url.toLocalFile() : filePath);
+}
+
+bool DataViewModel::loadSnapshot(const QString &filePath)
+{
+    m_loader->cancel();
+    const QUrl url(filePath);
+    return m_model->loadSnapshot(url.isLocalFile() ? url.toLocalFile() : filePath);
+}
+
+bool DataViewModel::openJournal(const QString &basePath)
+{
+    m_loader->cancel();
+    if (!m_journal->open(basePath)) {
+        emit journalFailed(m_journal->errorString());
+        return false;
+    }
+    return true;
+}
+
+bool DataViewModel::compactJournal()
+{
+    return m_journal->compact();
+}
+
+QStringList DataViewModel::search(const QString &query) const
+{
+    // Built on first use; until then edits do not pay for keeping it current.
+    if (!m_searchIndex) {
+        m_searchIndex = new DataSearchIndex(m_model, const_cast<DataViewModel*>(this));
+    }
+    return m_searchIndex->searchIds(query);
+}
+
 QVariant DataViewModel::getItem(const QString &id) const
 {
     return m_model->getItem(id);
@@ -4,6 +4,10 @@
 #include <QQmlEngine>
 #include <QLoggingCategory>
 #include "../../data/models/DataModel.h"
+#include "../../data/models/DataLoader.h"
+#include "../../data/models/DataJournal.h"
+#include "../../data/models/DataProxyModel.h"
+#include "../../data/models/DataSearchIndex.h"
 
 
 class DataViewModel : public QObject
@@ -11,12 +15,17 @@ class DataViewModel : public QObject
     Q_OBJECT
     QML_ELEMENT
     Q_PROPERTY(DataModel* model READ model NOTIFY modelChanged)
+    Q_PROPERTY(DataProxyModel* proxyModel READ proxyModel NOTIFY modelChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(qreal loadProgress READ loadProgress NOTIFY loadProgressChanged)
 
 public:
     explicit DataViewModel(QObject *parent = nullptr);
     ~DataViewModel();
 
     DataModel* model() const;
+    // Filtered/sorted view of model; bind filterText, sortBy and ascending from QML
+    DataProxyModel* proxyModel() const;
 
     Q_INVOKABLE void addItem(const QString &name, const QString &description, int value);
     Q_INVOKABLE void removeItem(const QString &id);
@@ -24,6 +33,31 @@ public:
     Q_INVOKABLE void setItemEnabled(const QString &id, bool enabled);
     Q_INVOKABLE void clear();
 
+    Q_INVOKABLE QStringList addItems(const QVariantList &items);
+    Q_INVOKABLE int removeItems(const QStringList &ids);
+    Q_INVOKABLE int updateValues(const QVariantMap &values);
+    Q_INVOKABLE void beginBatch();
+    Q_INVOKABLE void endBatch();
+    Q_INVOKABLE bool undo();
+    Q_INVOKABLE bool redo();
+
+    // Background loading; rows reach the model in small chunks per frame
+    Q_INVOKABLE void loadFile(const QString &filePath);
+    Q_INVOKABLE void loadGenerated(int count);
+    Q_INVOKABLE void cancelLoading();
+    bool isLoading() const;
+    qreal loadProgress() const;
+
+    Q_INVOKABLE bool saveSnapshot(const QString &filePath) const;
+    Q_INVOKABLE bool loadSnapshot(const QString &filePath);
+
+    // Restores <basePath>.dms plus <basePath>.journal and records every later change
+    Q_INVOKABLE bool openJournal(const QString &basePath);
+    Q_INVOKABLE bool compactJournal();
+
+    // Ids of items whose name or description contains every term
+    Q_INVOKABLE QStringList search(const QString &query) const;
+
     Q_INVOKABLE QVariant getItem(const QString &id) const;
     Q_INVOKABLE int getCount() const;
 
@@ -31,8 +65,20 @@ signals:
     void itemAdded(const QString &id);
     void itemRemoved(const QString &id);
     void itemUpdated(const QString &id);
+    void itemsAdded(const QStringList &ids);
+    void itemsRemoved(const QStringList &ids);
+    void itemsUpdated(const QStringList &ids);
     void modelChanged();
+    void loadingChanged();
+    void loadProgressChanged();
+    void loadFinished(int count);
+    void loadFailed(const QString &error);
+    void journalFailed(const QString &error);
 
 private:
     DataModel* m_model;
+    DataLoader* m_loader;
+    DataJournal* m_journal;
+    DataProxyModel* m_proxyModel;
+    mutable DataSearchIndex* m_searchIndex;
 };
\ No newline at end of file
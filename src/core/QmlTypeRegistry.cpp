@@ -2,6 +2,9 @@
 #include <QDebug>
 #include "../business/viewmodels/AppViewModel.h"
 #include "../business/viewmodels/DataViewModel.h"
+#include "../data/models/PagedDataModel.h"
+#include "../data/models/DataProxyModel.h"
+#include "../data/models/DataAggregates.h"
 
 
 QmlTypeRegistry* QmlTypeRegistry::s_instance = nullptr;
@@ -45,7 +48,11 @@ void QmlTypeRegistry::registerDataTypes()
 {
     qDebug() << "Registering data types";
 
-    // Register data models here if needed
+    // Register data models
+    qmlRegisterType<PagedDataModel>("com.example.app", 1, 0, "PagedDataModel");
+    qmlRegisterType<DataProxyModel>("com.example.app", 1, 0, "DataProxyModel");
+    qmlRegisterUncreatableType<DataAggregates>("com.example.app", 1, 0, "DataAggregates",
+                                               "DataAggregates is provided by DataModel");
 }
 
 void QmlTypeRegistry::registerUtilityTypes()
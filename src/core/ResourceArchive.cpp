@@ -0,0 +1,400 @@
+#include "ResourceArchive.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr char kMagic[4] = {'Q', 'R', 'P', 'K'};
+constexpr quint16 kVersion = 1;
+constexpr qint64 kHeaderSize = 32;
+constexpr qint64 kTocEntrySize = 32;
+
+template <typename T>
+T readLE(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+template <typename T>
+void appendLE(QByteArray &buffer, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    buffer.append(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+int compareNames(const char *name, quint32 nameLength, const QByteArray &key)
+{
+    const int common = int(std::min<qint64>(nameLength, key.size()));
+    const int result = std::memcmp(name, key.constData(), size_t(common));
+    if (result != 0) {
+        return result;
+    }
+    return int(nameLength) - int(key.size());
+}
+}
+
+ResourceArchive::ResourceArchive()
+{
+}
+
+ResourceArchive::~ResourceArchive()
+{
+    close();
+}
+
+bool ResourceArchive::open(const QString &archivePath)
+{
+    close();
+
+    m_file.setFileName(archivePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("Cannot open archive: ") + m_file.errorString());
+    }
+
+    m_size = m_file.size();
+    if (m_size < kHeaderSize) {
+        return fail(QStringLiteral("Archive is truncated"));
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return fail(QStringLiteral("Cannot map archive: ") + m_file.errorString());
+    }
+
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+        return fail(QStringLiteral("Not a resource archive"));
+    }
+    if (readLE<quint16>(m_data + 4) != kVersion) {
+        return fail(QStringLiteral("Unsupported archive version"));
+    }
+
+    m_entryCount = readLE<quint32>(m_data + 8);
+    const quint32 tocOffset = readLE<quint32>(m_data + 12);
+    const quint32 stringsOffset = readLE<quint32>(m_data + 16);
+    const quint32 stringsSize = readLE<quint32>(m_data + 20);
+    const quint64 dataOffset = readLE<quint64>(m_data + 24);
+
+    if (qint64(tocOffset) + qint64(m_entryCount) * kTocEntrySize > m_size
+        || qint64(stringsOffset) + qint64(stringsSize) > m_size
+        || dataOffset > quint64(m_size)) {
+        return fail(QStringLiteral("Archive table of contents is out of bounds"));
+    }
+
+    m_toc = m_data + tocOffset;
+    m_strings = reinterpret_cast<const char *>(m_data + stringsOffset);
+    m_payload = m_data + dataOffset;
+
+    const quint64 payloadSize = quint64(m_size) - dataOffset;
+    for (quint32 i = 0; i < m_entryCount; ++i) {
+        const TocEntry entry = tocEntry(i);
+        if (quint64(entry.nameOffset) + entry.nameLength > stringsSize
+            || entry.dataOffset + entry.storedSize > payloadSize) {
+            return fail(QStringLiteral("Archive entry %1 is out of bounds").arg(i));
+        }
+    }
+
+    m_lastModified = QFileInfo(m_file).lastModified().toSecsSinceEpoch();
+    m_errorString.clear();
+    return true;
+}
+
+void ResourceArchive::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+    m_file.close();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_entryCount = 0;
+    m_toc = nullptr;
+    m_strings = nullptr;
+    m_payload = nullptr;
+    m_lastModified = 0;
+}
+
+bool ResourceArchive::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString ResourceArchive::fileName() const
+{
+    return m_file.fileName();
+}
+
+QString ResourceArchive::errorString() const
+{
+    return m_errorString;
+}
+
+qint64 ResourceArchive::lastModified() const
+{
+    return m_lastModified;
+}
+
+int ResourceArchive::entryCount() const
+{
+    return int(m_entryCount);
+}
+
+bool ResourceArchive::contains(const QString &entryName) const
+{
+    return findEntry(entryName.toUtf8()) >= 0;
+}
+
+QByteArray ResourceArchive::read(const QString &entryName, bool *ok) const
+{
+    if (ok) {
+        *ok = false;
+    }
+    const int index = findEntry(entryName.toUtf8());
+    if (index < 0) {
+        return QByteArray();
+    }
+
+    const TocEntry entry = tocEntry(quint32(index));
+    const uchar *payload = m_payload + entry.dataOffset;
+    QByteArray data;
+    if (entry.flags & Compressed) {
+        data = qUncompress(payload, qsizetype(entry.storedSize));
+    } else {
+        data = QByteArray::fromRawData(reinterpret_cast<const char *>(payload), qsizetype(entry.storedSize));
+    }
+
+    if (data.size() != qsizetype(entry.originalSize)) {
+        qWarning() << "Resource archive entry" << entryName << "has" << data.size()
+                   << "bytes, expected" << entry.originalSize;
+        return QByteArray();
+    }
+    if (ok) {
+        *ok = true;
+    }
+    return data;
+}
+
+bool ResourceArchive::isCompressed(const QString &entryName) const
+{
+    const int index = findEntry(entryName.toUtf8());
+    return index >= 0 && (tocEntry(quint32(index)).flags & Compressed);
+}
+
+QStringList ResourceArchive::entryNames(const QString &prefix) const
+{
+    QStringList names;
+    const QByteArray key = prefix.toUtf8();
+
+    // Entries are sorted, so all names sharing the prefix form one contiguous run.
+    quint32 low = 0;
+    quint32 high = m_entryCount;
+    while (low < high) {
+        const quint32 middle = low + (high - low) / 2;
+        const TocEntry entry = tocEntry(middle);
+        if (compareNames(m_strings + entry.nameOffset, entry.nameLength, key) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (quint32 i = low; i < m_entryCount; ++i) {
+        const TocEntry entry = tocEntry(i);
+        const char *name = m_strings + entry.nameOffset;
+        if (entry.nameLength < quint32(key.size())
+            || std::memcmp(name, key.constData(), size_t(key.size())) != 0) {
+            break;
+        }
+        names.append(QString::fromUtf8(name, qsizetype(entry.nameLength)));
+    }
+    return names;
+}
+
+bool ResourceArchive::pack(const QString &sourceDir, const QString &archivePath,
+                           const PackOptions &options, QString *errorString)
+{
+    auto setError = [errorString](const QString &error) {
+        if (errorString) {
+            *errorString = error;
+        }
+        return false;
+    };
+
+    QDir root(sourceDir);
+    if (!root.exists()) {
+        return setError(QStringLiteral("Source directory does not exist: ") + sourceDir);
+    }
+
+    struct PendingEntry {
+        QByteArray name;
+        QString filePath;
+        quint32 mtime;
+    };
+    QList<PendingEntry> pending;
+
+    QDirIterator it(root.absolutePath(), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        if (!options.nameFilters.isEmpty() && !QDir::match(options.nameFilters, fileInfo.fileName())) {
+            continue;
+        }
+        if (fileInfo.size() > std::numeric_limits<quint32>::max()) {
+            return setError(QStringLiteral("File too large for archive: ") + fileInfo.filePath());
+        }
+        pending.append({root.relativeFilePath(fileInfo.absoluteFilePath()).toUtf8(),
+                        fileInfo.absoluteFilePath(),
+                        quint32(fileInfo.lastModified().toSecsSinceEpoch())});
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const PendingEntry &a, const PendingEntry &b) {
+        return a.name < b.name;
+    });
+
+    QByteArray strings;
+    QList<quint32> nameOffsets;
+    nameOffsets.reserve(pending.size());
+    for (const PendingEntry &entry : std::as_const(pending)) {
+        nameOffsets.append(quint32(strings.size()));
+        strings.append(entry.name);
+    }
+
+    // Offsets up to the payloads are stored as 32 bits
+    const quint64 tableEnd = quint64(kHeaderSize) + quint64(pending.size()) * quint64(kTocEntrySize)
+                             + quint64(strings.size());
+    if (tableEnd > std::numeric_limits<quint32>::max()) {
+        return setError(QStringLiteral("Too many entries for one archive"));
+    }
+
+    const quint32 entryCount = quint32(pending.size());
+    const quint32 tocOffset = quint32(kHeaderSize);
+    const quint32 stringsOffset = tocOffset + entryCount * quint32(kTocEntrySize);
+    const quint64 dataOffset = quint64(stringsOffset) + quint64(strings.size());
+
+    QSaveFile file(archivePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return setError(QStringLiteral("Cannot create archive: ") + file.errorString());
+    }
+
+    QByteArray header;
+    header.append(kMagic, sizeof(kMagic));
+    appendLE<quint16>(header, kVersion);
+    appendLE<quint16>(header, 0);
+    appendLE<quint32>(header, entryCount);
+    appendLE<quint32>(header, tocOffset);
+    appendLE<quint32>(header, stringsOffset);
+    appendLE<quint32>(header, quint32(strings.size()));
+    appendLE<quint64>(header, dataOffset);
+
+    // The table of contents is written after the payloads, once sizes are known.
+    const QByteArray placeholderToc(qsizetype(entryCount) * kTocEntrySize, '\0');
+    if (file.write(header) != header.size()
+        || file.write(placeholderToc) != placeholderToc.size()
+        || file.write(strings) != strings.size()) {
+        file.cancelWriting();
+        return setError(QStringLiteral("Failed to write archive: ") + file.errorString());
+    }
+
+    QByteArray toc;
+    toc.reserve(qsizetype(entryCount) * kTocEntrySize);
+    quint64 payloadOffset = 0;
+    for (int i = 0; i < pending.size(); ++i) {
+        const PendingEntry &entry = pending.at(i);
+        QFile source(entry.filePath);
+        if (!source.open(QIODevice::ReadOnly)) {
+            file.cancelWriting();
+            return setError(QStringLiteral("Cannot read ") + entry.filePath + QStringLiteral(": ") + source.errorString());
+        }
+        const QByteArray original = source.readAll();
+
+        QByteArray stored = original;
+        quint32 flags = 0;
+        if (options.compress && !original.isEmpty()) {
+            const QByteArray compressed = qCompress(original, options.compressionLevel);
+            if (compressed.size() <= qsizetype(original.size() * options.maxCompressionRatio)) {
+                stored = compressed;
+                flags |= Compressed;
+            }
+        }
+
+        if (file.write(stored) != stored.size()) {
+            file.cancelWriting();
+            return setError(QStringLiteral("Failed to write archive: ") + file.errorString());
+        }
+
+        appendLE<quint32>(toc, nameOffsets.at(i));
+        appendLE<quint32>(toc, quint32(entry.name.size()));
+        appendLE<quint64>(toc, payloadOffset);
+        appendLE<quint32>(toc, quint32(stored.size()));
+        appendLE<quint32>(toc, quint32(original.size()));
+        appendLE<quint32>(toc, flags);
+        appendLE<quint32>(toc, entry.mtime);
+        payloadOffset += quint64(stored.size());
+    }
+
+    if (!file.seek(tocOffset) || file.write(toc) != toc.size()) {
+        file.cancelWriting();
+        return setError(QStringLiteral("Failed to write archive table of contents: ") + file.errorString());
+    }
+
+    if (!file.commit()) {
+        return setError(QStringLiteral("Failed to commit archive: ") + file.errorString());
+    }
+
+    qDebug() << "Packed" << entryCount << "resources into" << archivePath;
+    return true;
+}
+
+ResourceArchive::TocEntry ResourceArchive::tocEntry(quint32 index) const
+{
+    const uchar *record = m_toc + qint64(index) * kTocEntrySize;
+    TocEntry entry;
+    entry.nameOffset = readLE<quint32>(record);
+    entry.nameLength = readLE<quint32>(record + 4);
+    entry.dataOffset = readLE<quint64>(record + 8);
+    entry.storedSize = readLE<quint32>(record + 16);
+    entry.originalSize = readLE<quint32>(record + 20);
+    entry.flags = readLE<quint32>(record + 24);
+    entry.mtime = readLE<quint32>(record + 28);
+    return entry;
+}
+
+int ResourceArchive::findEntry(const QByteArray &entryName) const
+{
+    quint32 low = 0;
+    quint32 high = m_entryCount;
+    while (low < high) {
+        const quint32 middle = low + (high - low) / 2;
+        const TocEntry entry = tocEntry(middle);
+        const int order = compareNames(m_strings + entry.nameOffset, entry.nameLength, entryName);
+        if (order == 0) {
+            return int(middle);
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return -1;
+}
+
+bool ResourceArchive::fail(const QString &error)
+{
+    m_errorString = error;
+    qWarning() << "Resource archive error:" << m_file.fileName() << error;
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_entryCount = 0;
+    return false;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+
+// Read-only view of a packed resource archive (.pak).
+//
+// Layout, all integers little-endian:
+//   header   magic "QRPK", u16 version, u16 flags, u32 entryCount,
+//            u32 tocOffset, u32 stringsOffset, u32 stringsSize, u64 dataOffset
+//   toc      entryCount x { u32 nameOffset, u32 nameLength, u64 dataOffset,
+//            u32 storedSize, u32 originalSize, u32 flags, u32 mtime },
+//            sorted by UTF-8 name bytes
+//   strings  UTF-8 entry names, referenced by the toc
+//   data     entry payloads, zlib-compressed (qCompress) when flagged
+//
+// The archive is memory-mapped; uncompressed entries are returned without
+// copying and stay valid for as long as the archive is open.
+class ResourceArchive
+{
+public:
+    enum EntryFlag {
+        Compressed = 0x1
+    };
+
+    struct PackOptions {
+        bool compress = true;
+        int compressionLevel = -1;
+        // Keep the compressed form only when it is at most this fraction of the original.
+        double maxCompressionRatio = 0.9;
+        QStringList nameFilters;
+    };
+
+    ResourceArchive();
+    ~ResourceArchive();
+
+    bool open(const QString &archivePath);
+    void close();
+    bool isOpen() const;
+
+    QString fileName() const;
+    QString errorString() const;
+    qint64 lastModified() const;
+
+    int entryCount() const;
+    bool contains(const QString &entryName) const;
+    // Null with *ok false when the entry is missing or does not inflate to its recorded size
+    QByteArray read(const QString &entryName, bool *ok = nullptr) const;
+    bool isCompressed(const QString &entryName) const;
+    QStringList entryNames(const QString &prefix = QString()) const;
+
+    static bool pack(const QString &sourceDir, const QString &archivePath,
+                     const PackOptions &options, QString *errorString = nullptr);
+
+private:
+    struct TocEntry {
+        quint32 nameOffset;
+        quint32 nameLength;
+        quint64 dataOffset;
+        quint32 storedSize;
+        quint32 originalSize;
+        quint32 flags;
+        quint32 mtime;
+    };
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_entryCount = 0;
+    const uchar *m_toc = nullptr;
+    const char *m_strings = nullptr;
+    const uchar *m_payload = nullptr;
+    qint64 m_lastModified = 0;
+    QString m_errorString;
+
+    TocEntry tocEntry(quint32 index) const;
+    int findEntry(const QByteArray &entryName) const;
+    bool fail(const QString &error);
+
+    Q_DISABLE_COPY(ResourceArchive)
+};
@@ -0,0 +1,240 @@
+#include "ResourceImageProvider.h"
+#include "ResourceManager.h"
+#include <QQuickTextureFactory>
+#include <QImageReader>
+#include <QBuffer>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+
+namespace {
+constexpr qint64 kDefaultCacheBudget = 64 * 1024 * 1024;
+
+// QCache costs are ints, so images are accounted in KiB.
+int imageCost(const QImage &image)
+{
+    return int(image.sizeInBytes() / 1024) + 1;
+}
+
+// The tag changes with the source bytes, so a changed file or a remounted
+// archive misses the cache; the stale entries age out under the budget.
+QString cacheKey(const QString &id, const QSize &requestedSize, const QString &tag)
+{
+    QString key = id + QLatin1Char('#') + tag;
+    if (requestedSize.isValid()) {
+        key += QLatin1Char('@') + QString::number(requestedSize.width())
+               + QLatin1Char('x') + QString::number(requestedSize.height());
+    }
+    return key;
+}
+
+QSize targetSize(const QSize &sourceSize, const QSize &requestedSize)
+{
+    if (!sourceSize.isValid() || (requestedSize.width() <= 0 && requestedSize.height() <= 0)) {
+        return QSize();
+    }
+
+    if (requestedSize.width() > 0 && requestedSize.height() > 0) {
+        return sourceSize.scaled(requestedSize, Qt::KeepAspectRatio);
+    }
+    if (requestedSize.width() > 0) {
+        return QSize(requestedSize.width(),
+                     qMax(1, sourceSize.height() * requestedSize.width() / qMax(1, sourceSize.width())));
+    }
+    return QSize(qMax(1, sourceSize.width() * requestedSize.height() / qMax(1, sourceSize.height())),
+                 requestedSize.height());
+}
+}
+
+class ResourceImageResponse : public QQuickImageResponse
+{
+public:
+    ResourceImageResponse()
+        : m_cancelled(new QAtomicInt(0))
+    {
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_errorString;
+    }
+
+    void cancel() override
+    {
+        m_cancelled->storeRelaxed(1);
+    }
+
+    void complete(const QImage &image, const QString &errorString)
+    {
+        m_image = image;
+        m_errorString = errorString;
+        emit finished();
+    }
+
+    QSharedPointer<QAtomicInt> cancelFlag() const
+    {
+        return m_cancelled;
+    }
+
+private:
+    QImage m_image;
+    QString m_errorString;
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+class ImageDecodeJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    ImageDecodeJob(ResourceImageProvider *provider, const QString &id, const QSize &requestedSize,
+                   const QString &key, const QSharedPointer<QAtomicInt> &cancelled)
+        : m_provider(provider)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+        , m_key(key)
+        , m_cancelled(cancelled)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        if (m_cancelled->loadRelaxed()) {
+            emit done(QImage(), QStringLiteral("Cancelled"));
+            return;
+        }
+
+        QImage image;
+        // Another request may have decoded the same image while this one was queued.
+        if (m_provider->cachedImage(m_key, &image)) {
+            emit done(image, QString());
+            return;
+        }
+
+        QByteArray data = ResourceManager::instance()->imageData(m_id);
+        if (data.isEmpty()) {
+            emit done(QImage(), QStringLiteral("Image resource not found: ") + m_id);
+            return;
+        }
+
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        reader.setAutoTransform(true);
+
+        const QSize scaledSize = targetSize(reader.size(), m_requestedSize);
+        if (scaledSize.isValid()) {
+            reader.setScaledSize(scaledSize);
+        }
+
+        if (!reader.read(&image)) {
+            emit done(QImage(), QStringLiteral("Failed to decode ") + m_id + QStringLiteral(": ") + reader.errorString());
+            return;
+        }
+
+        m_provider->insertImage(m_key, image);
+        emit done(image, QString());
+    }
+
+signals:
+    void done(const QImage &image, const QString &errorString);
+
+private:
+    ResourceImageProvider *m_provider;
+    QString m_id;
+    QSize m_requestedSize;
+    QString m_key;
+    QSharedPointer<QAtomicInt> m_cancelled;
+};
+
+ResourceImageProvider::ResourceImageProvider()
+{
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    m_cache.setMaxCost(int(kDefaultCacheBudget / 1024));
+}
+
+ResourceImageProvider::~ResourceImageProvider()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QString ResourceImageProvider::providerId()
+{
+    return QStringLiteral("resources");
+}
+
+QQuickImageResponse *ResourceImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto *response = new ResourceImageResponse();
+    const QString key = cacheKey(id, requestedSize, ResourceManager::instance()->imageCacheTag(id));
+
+    QImage image;
+    if (cachedImage(key, &image)) {
+        // finished() must not fire before the engine has connected to it.
+        QMetaObject::invokeMethod(response, [response, image]() {
+            response->complete(image, QString());
+        }, Qt::QueuedConnection);
+        return response;
+    }
+
+    auto *job = new ImageDecodeJob(this, id, requestedSize, key, response->cancelFlag());
+    QObject::connect(job, &ImageDecodeJob::done, response, &ResourceImageResponse::complete,
+                     Qt::QueuedConnection);
+    m_pool.start(job);
+    return response;
+}
+
+void ResourceImageProvider::setCacheBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_cache.setMaxCost(int(qMax<qint64>(0, bytes) / 1024));
+}
+
+qint64 ResourceImageProvider::cacheBudget() const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    return qint64(m_cache.maxCost()) * 1024;
+}
+
+void ResourceImageProvider::clearCache()
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_cache.clear();
+}
+
+void ResourceImageProvider::setMaxDecodeThreads(int threads)
+{
+    m_pool.setMaxThreadCount(qMax(1, threads));
+}
+
+bool ResourceImageProvider::cachedImage(const QString &key, QImage *image) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    const QImage *cached = m_cache.object(key);
+    if (!cached) {
+        return false;
+    }
+
+    if (image) {
+        *image = *cached;
+    }
+    return true;
+}
+
+void ResourceImageProvider::insertImage(const QString &key, const QImage &image)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_cache.insert(key, new QImage(image), imageCost(image));
+}
+
+#include "ResourceImageProvider.moc"
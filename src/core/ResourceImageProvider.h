@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+
+// Serves "image://resources/<name>" URLs. Images are resolved through
+// ResourceManager (index and packed archive), decoded on a worker pool at
+// the size QML asks for, and kept in a decoded-image cache bounded by a
+// memory budget so repeated requests skip decoding entirely. Entries are
+// keyed by ResourceManager::imageCacheTag(), so edited files and remounted
+// archives are decoded afresh.
+class ResourceImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    ResourceImageProvider();
+    ~ResourceImageProvider();
+
+    static QString providerId();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    void setCacheBudget(qint64 bytes);
+    qint64 cacheBudget() const;
+    void clearCache();
+
+    void setMaxDecodeThreads(int threads);
+
+    // Used by decode jobs
+    bool cachedImage(const QString &key, QImage *image) const;
+    void insertImage(const QString &key, const QImage &image);
+
+private:
+    QThreadPool m_pool;
+    mutable QMutex m_cacheMutex;
+    QCache<QString, QImage> m_cache;
+};
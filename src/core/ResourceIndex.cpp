@@ -0,0 +1,312 @@
+#include "ResourceIndex.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+#include <utility>
+
+namespace {
+constexpr int kRebuildDelayMs = 100;
+
+bool isTopLevelMatch(const QString &resourceName, const QStringList &nameFilters)
+{
+    if (resourceName.contains(QLatin1Char('/'))) {
+        return false;
+    }
+    return nameFilters.isEmpty() || QDir::match(nameFilters, resourceName);
+}
+
+QStringList buildListing(const QHash<QString, ResourceEntry> &entries, const QStringList &nameFilters)
+{
+    QStringList listing;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (isTopLevelMatch(it.key(), nameFilters)) {
+            listing.append(it.key());
+        }
+    }
+    std::sort(listing.begin(), listing.end(), [](const QString &a, const QString &b) {
+        return a.compare(b, Qt::CaseInsensitive) < 0;
+    });
+    return listing;
+}
+}
+
+ResourceIndex::ResourceIndex(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_rebuildTimer(new QTimer(this))
+{
+    m_rebuildTimer->setSingleShot(true);
+    m_rebuildTimer->setInterval(kRebuildDelayMs);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &ResourceIndex::onDirectoryChanged);
+    connect(m_rebuildTimer, &QTimer::timeout,
+            this, &ResourceIndex::rebuildPendingTypes);
+}
+
+ResourceIndex::~ResourceIndex()
+{
+}
+
+void ResourceIndex::addDirectory(const QString &resourceType, const QString &path)
+{
+    {
+        QWriteLocker locker(&m_lock);
+        TypeIndex &index = m_types[resourceType];
+        if (index.directories.contains(path)) {
+            return;
+        }
+        index.directories.append(path);
+    }
+
+    rebuild(resourceType);
+}
+
+void ResourceIndex::removeType(const QString &resourceType)
+{
+    {
+        QWriteLocker locker(&m_lock);
+        if (!m_types.remove(resourceType)) {
+            return;
+        }
+    }
+
+    m_pendingTypes.remove(resourceType);
+    updateWatchedDirectories(resourceType, QStringList());
+}
+
+void ResourceIndex::setNameFilters(const QString &resourceType, const QStringList &nameFilters)
+{
+    QWriteLocker locker(&m_lock);
+    TypeIndex &index = m_types[resourceType];
+    index.nameFilters = nameFilters;
+    index.listing = buildListing(index.entries, nameFilters);
+}
+
+void ResourceIndex::rebuild(const QString &resourceType)
+{
+    TypeIndex scanned;
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_types.constFind(resourceType);
+        if (it == m_types.constEnd()) {
+            return;
+        }
+        scanned.directories = it->directories;
+        scanned.nameFilters = it->nameFilters;
+    }
+
+    // Scan without holding the lock so readers are never blocked on disk I/O.
+    QStringList watchedDirectories;
+    scanType(scanned, watchedDirectories);
+
+    {
+        QWriteLocker locker(&m_lock);
+        auto it = m_types.find(resourceType);
+        if (it == m_types.end() || it->directories != scanned.directories) {
+            // The type was removed or changed while scanning; a newer rebuild owns it.
+            return;
+        }
+        it->entries = std::move(scanned.entries);
+        it->listing = std::move(scanned.listing);
+    }
+
+    updateWatchedDirectories(resourceType, watchedDirectories);
+    emit typeRebuilt(resourceType);
+}
+
+void ResourceIndex::refreshEntry(const QString &resourceType, const QString &resourceName)
+{
+    const QString name = normalizedName(resourceName);
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_types.find(resourceType);
+    if (it == m_types.end()) {
+        return;
+    }
+
+    const bool wasIndexed = it->entries.contains(name);
+    for (const QString &directory : std::as_const(it->directories)) {
+        QFileInfo fileInfo(directory + QLatin1Char('/') + name);
+        if (fileInfo.isFile()) {
+            it->entries.insert(name, {fileInfo.filePath(), fileInfo.size(), fileInfo.lastModified()});
+            if (!wasIndexed && isTopLevelMatch(name, it->nameFilters)) {
+                it->listing = buildListing(it->entries, it->nameFilters);
+            }
+            return;
+        }
+    }
+
+    if (wasIndexed) {
+        it->entries.remove(name);
+        it->listing.removeOne(name);
+    }
+}
+
+bool ResourceIndex::contains(const QString &resourceType, const QString &resourceName) const
+{
+    return entry(resourceType, resourceName).isValid();
+}
+
+QString ResourceIndex::lookup(const QString &resourceType, const QString &resourceName) const
+{
+    return entry(resourceType, resourceName).path;
+}
+
+ResourceEntry ResourceIndex::entry(const QString &resourceType, const QString &resourceName) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_types.constFind(resourceType);
+    if (it == m_types.constEnd()) {
+        return ResourceEntry();
+    }
+
+    auto entryIt = it->entries.constFind(resourceName);
+    if (entryIt == it->entries.constEnd()) {
+        entryIt = it->entries.constFind(normalizedName(resourceName));
+        if (entryIt == it->entries.constEnd()) {
+            return ResourceEntry();
+        }
+    }
+    return entryIt.value();
+}
+
+QStringList ResourceIndex::listing(const QString &resourceType) const
+{
+    QReadLocker locker(&m_lock);
+    return m_types.value(resourceType).listing;
+}
+
+QStringList ResourceIndex::types() const
+{
+    QReadLocker locker(&m_lock);
+    return m_types.keys();
+}
+
+QStringList ResourceIndex::directories(const QString &resourceType) const
+{
+    QReadLocker locker(&m_lock);
+    return m_types.value(resourceType).directories;
+}
+
+QString ResourceIndex::typeForPath(const QString &filePath, QString *resourceName) const
+{
+    QReadLocker locker(&m_lock);
+    for (auto it = m_types.constBegin(); it != m_types.constEnd(); ++it) {
+        for (const QString &directory : it->directories) {
+            if (filePath.size() > directory.size()
+                && filePath.startsWith(directory)
+                && filePath.at(directory.size()) == QLatin1Char('/')) {
+                if (resourceName) {
+                    *resourceName = filePath.mid(directory.size() + 1);
+                }
+                return it.key();
+            }
+        }
+    }
+    return QString();
+}
+
+void ResourceIndex::onDirectoryChanged(const QString &path)
+{
+    const QSet<QString> owners = m_watchOwners.value(path);
+    if (owners.isEmpty()) {
+        return;
+    }
+
+    m_pendingTypes.unite(owners);
+    m_rebuildTimer->start();
+}
+
+void ResourceIndex::rebuildPendingTypes()
+{
+    const QSet<QString> pendingTypes = std::exchange(m_pendingTypes, QSet<QString>());
+    for (const QString &resourceType : pendingTypes) {
+        qDebug() << "Rebuilding resource index for type:" << resourceType;
+        rebuild(resourceType);
+    }
+}
+
+void ResourceIndex::scanType(TypeIndex &index, QStringList &watchedDirectories) const
+{
+    index.entries.clear();
+
+    for (const QString &directory : std::as_const(index.directories)) {
+        const bool watchable = !directory.startsWith(QLatin1Char(':'));
+        if (watchable) {
+            watchedDirectories.append(directory);
+        }
+
+        const int prefixLength = directory.size() + 1;
+        QDirIterator it(directory, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo fileInfo = it.fileInfo();
+            if (fileInfo.isDir()) {
+                if (watchable) {
+                    watchedDirectories.append(fileInfo.filePath());
+                }
+                continue;
+            }
+
+            // Earlier directories take precedence, matching the registration order.
+            const QString name = fileInfo.filePath().mid(prefixLength);
+            if (!index.entries.contains(name)) {
+                index.entries.insert(name, {fileInfo.filePath(), fileInfo.size(), fileInfo.lastModified()});
+            }
+        }
+    }
+
+    index.listing = buildListing(index.entries, index.nameFilters);
+}
+
+void ResourceIndex::updateWatchedDirectories(const QString &resourceType, const QStringList &directories)
+{
+    QSet<QString> unwatched;
+    const QStringList previous = m_watchedByType.take(resourceType);
+    for (const QString &directory : previous) {
+        auto it = m_watchOwners.find(directory);
+        if (it == m_watchOwners.end()) {
+            continue;
+        }
+        it->remove(resourceType);
+        if (it->isEmpty()) {
+            m_watchOwners.erase(it);
+            unwatched.insert(directory);
+        }
+    }
+
+    QStringList toAdd;
+    for (const QString &directory : directories) {
+        QSet<QString> &owners = m_watchOwners[directory];
+        if (owners.isEmpty() && !unwatched.remove(directory)) {
+            toAdd.append(directory);
+        }
+        owners.insert(resourceType);
+    }
+
+    if (!unwatched.isEmpty()) {
+        m_watcher->removePaths(unwatched.values());
+    }
+    if (!toAdd.isEmpty()) {
+        m_watcher->addPaths(toAdd);
+    }
+
+    if (!directories.isEmpty()) {
+        m_watchedByType.insert(resourceType, directories);
+    }
+}
+
+QString ResourceIndex::normalizedName(const QString &resourceName)
+{
+    QString name = QDir::cleanPath(resourceName);
+    while (name.startsWith(QLatin1Char('/'))) {
+        name.remove(0, 1);
+    }
+    return name;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include <QReadWriteLock>
+
+class QFileSystemWatcher;
+class QTimer;
+
+struct ResourceEntry {
+    QString path;
+    qint64 size = -1;
+    QDateTime lastModified;
+
+    bool isValid() const { return !path.isEmpty(); }
+};
+
+// In-memory index of the files below each registered resource directory.
+// Lookups and listings are answered from hash tables; a directory watcher
+// keeps the index in sync with the disk. Reads are safe from any thread.
+class ResourceIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResourceIndex(QObject *parent = nullptr);
+    ~ResourceIndex();
+
+    // Index management
+    void addDirectory(const QString &resourceType, const QString &path);
+    void removeType(const QString &resourceType);
+    void setNameFilters(const QString &resourceType, const QStringList &nameFilters);
+    void rebuild(const QString &resourceType);
+    void refreshEntry(const QString &resourceType, const QString &resourceName);
+
+    // Queries
+    bool contains(const QString &resourceType, const QString &resourceName) const;
+    QString lookup(const QString &resourceType, const QString &resourceName) const;
+    ResourceEntry entry(const QString &resourceType, const QString &resourceName) const;
+    QStringList listing(const QString &resourceType) const;
+    QStringList types() const;
+    QStringList directories(const QString &resourceType) const;
+    QString typeForPath(const QString &filePath, QString *resourceName = nullptr) const;
+
+signals:
+    void typeRebuilt(const QString &resourceType);
+
+private slots:
+    void onDirectoryChanged(const QString &path);
+    void rebuildPendingTypes();
+
+private:
+    struct TypeIndex {
+        QStringList directories;
+        QStringList nameFilters;
+        QHash<QString, ResourceEntry> entries;
+        QStringList listing;
+    };
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, TypeIndex> m_types;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_rebuildTimer;
+    QSet<QString> m_pendingTypes;
+    QHash<QString, QStringList> m_watchedByType;
+    QHash<QString, QSet<QString>> m_watchOwners;
+
+    void scanType(TypeIndex &index, QStringList &watchedDirectories) const;
+    void updateWatchedDirectories(const QString &resourceType, const QStringList &directories);
+    static QString normalizedName(const QString &resourceName);
+};
@@ -1,17 +1,47 @@
 #include "ResourceManager.h"
+#include "ResourceIndex.h"
+#include "ResourceArchive.h"
+#include "ResourceImageProvider.h"
+#include "ResourceWriter.h"
+#include "TranslationManager.h"
+#include "ResourceStats.h"
 #include <QFile>
+#include <QSaveFile>
+#include <QFileSystemWatcher>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QDir>
 #include <QStandardPaths>
 #include <QCoreApplication>
-#include <QTranslator>
+#include <QLocale>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QStringTokenizer>
 #include <QDebug>
 #include <QRegularExpression>
+#include <QReadLocker>
+#include <QWriteLocker>
 
 ResourceManager* ResourceManager::s_instance = nullptr;
 
+namespace {
+QStringList nameFiltersForType(const QString &resourceType)
+{
+    if (resourceType == QLatin1String("qml")) {
+        return {QStringLiteral("*.qml"), QStringLiteral("*.js")};
+    }
+    if (resourceType == QLatin1String("images")) {
+        return {QStringLiteral("*.png"), QStringLiteral("*.jpg"), QStringLiteral("*.jpeg"),
+                QStringLiteral("*.gif"), QStringLiteral("*.svg"), QStringLiteral("*.bmp")};
+    }
+    if (resourceType == QLatin1String("translations")) {
+        return {QStringLiteral("*.qm"), QStringLiteral("*.ts")};
+    }
+    return QStringList();
+}
+}
+
 ResourceManager* ResourceManager::instance()
 {
     if (!s_instance) {
@@ -22,13 +52,38 @@ ResourceManager* ResourceManager::instance()
 
 ResourceManager::ResourceManager(QObject *parent)
     : QObject(parent)
+    , m_index(new ResourceIndex(this))
+    , m_cacheWatcher(new QFileSystemWatcher(this))
+    , m_writer(new ResourceWriter(this))
+    , m_translations(new TranslationManager(this))
     , m_cacheEnabled(true)
+    , m_cacheValidationEnabled(false)
+    , m_writeBehindEnabled(true)
+    , m_stats(new ResourceStats())
+    , m_statisticsEnabled(true)
+    , m_statisticsDumpPath(qEnvironmentVariable("APP_RESOURCE_STATS"))
 {
+    connect(m_cacheWatcher, &QFileSystemWatcher::fileChanged,
+            this, &ResourceManager::onCachedFileChanged);
+    connect(m_index, &ResourceIndex::typeRebuilt, this, [this](const QString &resourceType) {
+        m_missingResources.remove(resourceType);
+    });
+    connect(m_writer, &ResourceWriter::written,
+            this, &ResourceManager::onResourceWritten);
+    connect(m_writer, &ResourceWriter::writeFailed,
+            this, &ResourceManager::resourceError);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &ResourceManager::onAboutToQuit);
+    }
     qDebug() << "ResourceManager initialized";
 }
 
 ResourceManager::~ResourceManager()
 {
+    flush();
+    unloadArchiveCatalogs();
     clearCache();
     qDebug() << "ResourceManager destroyed";
 }
@@ -55,6 +110,11 @@ bool ResourceManager::initialize(const QString &baseResourcePath)
     registerResourcePath("translations", m_baseResourcePath + "/translations");
     registerResourcePath("config", m_baseResourcePath + "/config");
 
+    const QString archivePath = m_baseResourcePath + ".pak";
+    if (QFile::exists(archivePath)) {
+        mountArchive(archivePath);
+    }
+
     qDebug() << "ResourceManager initialized with base path:" << m_baseResourcePath;
     return true;
 }
@@ -74,8 +134,9 @@ bool ResourceManager::registerResourcePath(const QString &resourceType, const QS
         }
     }
 
-    if (!m_resourcePaths[resourceType].contains(path)) {
-        m_resourcePaths[resourceType].append(path);
+    if (!m_index->directories(resourceType).contains(path)) {
+        m_index->setNameFilters(resourceType, nameFiltersForType(resourceType));
+        m_index->addDirectory(resourceType, path);
         qDebug() << "Registered resource path:" << path << "for type:" << resourceType;
     }
 
@@ -84,8 +145,9 @@ bool ResourceManager::registerResourcePath(const QString &resourceType, const QS
 
 bool ResourceManager::unregisterResourcePath(const QString &resourceType)
 {
-    if (m_resourcePaths.contains(resourceType)) {
-        m_resourcePaths.remove(resourceType);
+    if (m_index->types().contains(resourceType)) {
+        m_index->removeType(resourceType);
+        m_missingResources.remove(resourceType);
         qDebug() << "Unregistered resource type:" << resourceType;
         return true;
     }
@@ -94,7 +156,7 @@ bool ResourceManager::unregisterResourcePath(const QString &resourceType)
 
 QStringList ResourceManager::getRegisteredResourceTypes() const
 {
-    return m_resourcePaths.keys();
+    return m_index->types();
 }
 
 QString ResourceManager::getResourcePath(const QString &resourceType, const QString &resourceName) const
@@ -104,7 +166,9 @@ QString ResourceManager::getResourcePath(const QString &resourceType, const QStr
 
 bool ResourceManager::resourceExists(const QString &resourcePath) const
 {
-    return QFile::exists(resourcePath);
+    return !archiveEntryForPath(resourcePath).isEmpty()
+           || m_writer->pendingData(resourcePath)
+           || QFile::exists(resourcePath);
 }
 
 QString ResourceManager::readTextResource(const QString &resourcePath) const
@@ -120,18 +184,33 @@ QByteArray ResourceManager::readBinaryResource(const QString &resourcePath) cons
 
 bool ResourceManager::saveResource(const QString &resourcePath, const QByteArray &data) const
 {
-    QFile file(resourcePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing:" << resourcePath;
+    if (resourcePath.isEmpty()) {
+        qWarning() << "Cannot save resource to an empty path";
         return false;
     }
 
-    if (file.write(data) == -1) {
-        qWarning() << "Failed to write data to file:" << resourcePath;
+    auto *self = const_cast<ResourceManager*>(this);
+    if (m_writeBehindEnabled) {
+        // Readers see the new bytes immediately; the file follows after the debounce window.
+        m_writer->enqueue(resourcePath, data);
+        if (m_resourceCache.contains(resourcePath)) {
+            self->cacheResource(resourcePath, data);
+        }
+        return true;
+    }
+
+    QString error;
+    if (!ResourceWriter::writeFile(resourcePath, data, &error)) {
+        qWarning() << "Failed to write data to file:" << resourcePath << error;
+        emit self->resourceError(resourcePath, error);
         return false;
     }
 
-    file.close();
+    // Keep our own cache entry current instead of waiting for the watcher to evict it.
+    if (m_resourceCache.contains(resourcePath)) {
+        self->cacheResource(resourcePath, data);
+    }
+    self->refreshIndexEntry(resourcePath);
     return true;
 }
 
@@ -142,6 +221,15 @@ QUrl ResourceManager::getQmlResource(const QString &qmlName) const
         return QUrl();
     }
 
+    // The QML engine needs a loadable URL, so archived documents are unpacked once.
+    const QString entryName = archiveEntryForPath(resourcePath);
+    if (!entryName.isEmpty()) {
+        resourcePath = const_cast<ResourceManager*>(this)->materializeArchiveEntry(entryName);
+        if (resourcePath.isEmpty()) {
+            return QUrl();
+        }
+    }
+
     QUrl url = QUrl::fromLocalFile(resourcePath);
     if (!url.isValid()) {
         qWarning() << "Invalid QML resource URL:" << resourcePath;
@@ -153,22 +241,7 @@ QUrl ResourceManager::getQmlResource(const QString &qmlName) const
 
 QStringList ResourceManager::getAvailableQmlResources() const
 {
-    QStringList qmlFiles;
-    const QStringList &paths = m_resourcePaths.value("qml");
-
-    for (const QString &path : paths) {
-        QDir dir(path);
-        QStringList filters;
-        filters << "*.qml" << "*.js";
-        dir.setNameFilters(filters);
-
-        QFileInfoList files = dir.entryInfoList(QDir::Files);
-        for (const QFileInfo &file : files) {
-            qmlFiles.append(file.fileName());
-        }
-    }
-
-    return qmlFiles;
+    return listResources("qml");
 }
 
 QUrl ResourceManager::getImageResource(const QString &imageName) const
@@ -178,96 +251,129 @@ QUrl ResourceManager::getImageResource(const QString &imageName) const
         return QUrl();
     }
 
-    QUrl url = QUrl::fromLocalFile(resourcePath);
-    return url;
+    // Decoded off-thread and cached by ResourceImageProvider
+    return QUrl(QStringLiteral("image://") + ResourceImageProvider::providerId() + QLatin1Char('/') + imageName);
 }
 
 QStringList ResourceManager::getAvailableImages() const
 {
-    QStringList imageFiles;
-    const QStringList &paths = m_resourcePaths.value("images");
+    return listResources("images");
+}
 
-    for (const QString &path : paths) {
-        QDir dir(path);
-        QStringList filters;
-        filters << "*.png" << "*.jpg" << "*.jpeg" << "*.gif" << "*.svg" << "*.bmp";
-        dir.setNameFilters(filters);
 
-        QFileInfoList files = dir.entryInfoList(QDir::Files);
-        for (const QFileInfo &file : files) {
-            imageFiles.append(file.fileName());
-        }
+bool ResourceManager::loadTranslation(const QString &translationFile, const QString &locale)
+{
+    QString effectiveLocale = locale;
+    if (effectiveLocale.isEmpty()) {
+        effectiveLocale = TranslationManager::localeFromFileName(translationFile);
+    }
+    if (effectiveLocale.isEmpty()) {
+        effectiveLocale = QLocale::system().name();
     }
 
-    return imageFiles;
+    if (!loadTranslationCatalog(translationFile, effectiveLocale)) {
+        return false;
+    }
+    return m_translations->activate(effectiveLocale);
 }
 
+bool ResourceManager::setLocale(const QString &locale)
+{
+    // Every catalog of the locale (application and plugins) is loaded, not just the first.
+    bool found = m_translations->isLoaded(locale);
+    const QStringList translationFiles = getAvailableTranslations();
+    for (const QString &translationFile : translationFiles) {
+        if (translationFile.endsWith(".qm")
+            && TranslationManager::localeFromFileName(translationFile) == locale
+            && loadTranslationCatalog(translationFile, locale)) {
+            found = true;
+        }
+    }
 
-bool ResourceManager::loadTranslation(const QString &translationFile, const QString &locale)
+    if (!found) {
+        qWarning() << "No translation available for locale:" << locale;
+        return false;
+    }
+    return m_translations->activate(locale);
+}
+
+bool ResourceManager::loadTranslationCatalog(const QString &translationFile, const QString &locale)
 {
-    QString translationPath = resolveResourcePath("translations", translationFile);
+    const QString translationPath = resolveResourcePath("translations", translationFile);
     if (translationPath.isEmpty()) {
         qWarning() << "Translation file not found:" << translationFile;
         return false;
     }
 
-    QTranslator *translator = new QTranslator(this);
-    if (!translator->load(translationPath)) {
-        qWarning() << "Failed to load translation:" << translationPath;
-        delete translator;
-        return false;
+    // Catalogs are keyed by their path, so loading one again is just a lookup.
+    const QString entryName = archiveEntryForPath(translationPath);
+    if (entryName.isEmpty()) {
+        return m_translations->loadFile(locale, translationPath);
     }
 
-    QString effectiveLocale = locale.isEmpty() ? QLocale::system().name() : locale;
-    if (!QCoreApplication::installTranslator(translator)) {
-        qWarning() << "Failed to install translator for locale:" << effectiveLocale;
-        delete translator;
+    bool ok = false;
+    const QByteArray data = m_archive->read(entryName, &ok);
+    if (!ok) {
+        emit resourceError(translationPath, QStringLiteral("Corrupt archive entry"));
         return false;
     }
-
-    qDebug() << "Translation loaded for locale:" << effectiveLocale;
+    if (!m_translations->loadData(locale, data, translationPath)) {
+        return false;
+    }
+    m_archiveCatalogs.insert(translationPath, locale);
     return true;
 }
 
-QStringList ResourceManager::getAvailableTranslations() const
+TranslationManager *ResourceManager::translations() const
 {
-    QStringList translationFiles;
-    const QStringList &paths = m_resourcePaths.value("translations");
+    return m_translations;
+}
 
-    for (const QString &path : paths) {
-        QDir dir(path);
-        QStringList filters;
-        filters << "*.qm" << "*.ts";
-        dir.setNameFilters(filters);
+QStringList ResourceManager::getAvailableTranslations() const
+{
+    return listResources("translations");
+}
 
-        QFileInfoList files = dir.entryInfoList(QDir::Files);
-        for (const QFileInfo &file : files) {
-            translationFiles.append(file.fileName());
-        }
-    }
+QVariantMap ResourceManager::loadConfig(const QString &configName) const
+{
+    return configObject(configName).toVariantMap();
+}
 
-    return translationFiles;
+QVariant ResourceManager::config(const QString &configName, const QString &keyPath, const QVariant &defaultValue) const
+{
+    const QJsonValue value = configValue(configName, keyPath);
+    return value.isUndefined() ? defaultValue : value.toVariant();
 }
 
-QVariantMap ResourceManager::loadConfig(const QString &configName) const
+QJsonValue ResourceManager::configValue(const QString &configName, const QString &keyPath) const
 {
-    QString configPath = resolveResourcePath("config", configName + ".json");
-    if (configPath.isEmpty()) {
-        return QVariantMap();
+    QJsonValue current = configObject(configName);
+    if (keyPath.isEmpty()) {
+        return current;
     }
 
-    QByteArray data = getResourceData(configPath);
-    if (data.isEmpty()) {
-        return QVariantMap();
-    }
+    // Walk the cached document one segment at a time; only the leaf is converted.
+    for (const QStringView segment : qTokenize(keyPath, u'.')) {
+        if (current.isObject()) {
+            current = current.toObject().value(segment);
+        } else if (current.isArray()) {
+            bool isIndex = false;
+            const int index = segment.toInt(&isIndex);
+            const QJsonArray array = current.toArray();
+            if (!isIndex || index < 0 || index >= array.size()) {
+                return QJsonValue(QJsonValue::Undefined);
+            }
+            current = array.at(index);
+        } else {
+            return QJsonValue(QJsonValue::Undefined);
+        }
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        qWarning() << "Invalid JSON config file:" << configPath;
-        return QVariantMap();
+        if (current.isUndefined()) {
+            return current;
+        }
     }
 
-    return doc.object().toVariantMap();
+    return current;
 }
 
 bool ResourceManager::saveConfig(const QString &configName, const QVariantMap &config) const
@@ -281,7 +387,57 @@ bool ResourceManager::saveConfig(const QString &configName, const QVariantMap &c
     QJsonDocument doc(jsonObj);
     QByteArray data = doc.toJson();
 
-    return saveResource(configPath, data);
+    if (!saveResource(configPath, data)) {
+        return false;
+    }
+
+    // Cache the bytes too, so the entry is watched and evicted like a loaded one.
+    if (m_cacheEnabled) {
+        auto *self = const_cast<ResourceManager*>(this);
+        self->cacheResource(configPath, data);
+        self->m_configCache.insert(configPath, jsonObj);
+    }
+    return true;
+}
+
+QJsonObject ResourceManager::configObject(const QString &configName) const
+{
+    QString configPath = resolveResourcePath("config", configName + ".json");
+    if (configPath.isEmpty()) {
+        return QJsonObject();
+    }
+
+    if (m_cacheEnabled && !m_cacheValidationEnabled) {
+        auto it = m_configCache.constFind(configPath);
+        if (it != m_configCache.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // With validation on, this re-checks the file and drops both cache levels if it changed.
+    QByteArray data = getResourceData(configPath);
+    if (data.isEmpty()) {
+        return QJsonObject();
+    }
+
+    if (m_cacheEnabled) {
+        auto it = m_configCache.constFind(configPath);
+        if (it != m_configCache.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (doc.isNull() || !doc.isObject()) {
+        qWarning() << "Invalid JSON config file:" << configPath;
+        return QJsonObject();
+    }
+
+    const QJsonObject object = doc.object();
+    if (m_cacheEnabled) {
+        const_cast<ResourceManager*>(this)->m_configCache.insert(configPath, object);
+    }
+    return object;
 }
 
 bool ResourceManager::registerPluginResources(const QString &pluginName, const QString &resourcePath)
@@ -291,7 +447,18 @@ bool ResourceManager::registerPluginResources(const QString &pluginName, const Q
         return false;
     }
 
+    // One scan at registration; lookups are served from the index afterwards.
+    // Registering the same directory again (a plugin reload) scans it again.
+    const QString resourceType = pluginNamespace(pluginName);
+    if (m_pluginResourcePaths.value(pluginName) == resourcePath) {
+        m_index->rebuild(resourceType);
+    } else {
+        m_index->removeType(resourceType);
+        m_index->addDirectory(resourceType, resourcePath);
+    }
+    m_missingResources.remove(resourceType);
     m_pluginResourcePaths[pluginName] = resourcePath;
+
     emit pluginResourcesRegistered(pluginName);
     qDebug() << "Registered plugin resources for:" << pluginName << "at:" << resourcePath;
     return true;
@@ -299,12 +466,30 @@ bool ResourceManager::registerPluginResources(const QString &pluginName, const Q
 
 bool ResourceManager::unregisterPluginResources(const QString &pluginName)
 {
-    if (m_pluginResourcePaths.remove(pluginName)) {
-        emit pluginResourcesUnregistered(pluginName);
-        qDebug() << "Unregistered plugin resources for:" << pluginName;
-        return true;
+    auto it = m_pluginResourcePaths.find(pluginName);
+    if (it == m_pluginResourcePaths.end()) {
+        return false;
     }
-    return false;
+
+    const QString resourceType = pluginNamespace(pluginName);
+    const QString prefix = it.value() + "/";
+    m_pluginResourcePaths.erase(it);
+    m_index->removeType(resourceType);
+    m_missingResources.remove(resourceType);
+
+    QStringList cachedPaths;
+    for (auto cacheIt = m_resourceCache.constBegin(); cacheIt != m_resourceCache.constEnd(); ++cacheIt) {
+        if (cacheIt.key().startsWith(prefix)) {
+            cachedPaths.append(cacheIt.key());
+        }
+    }
+    for (const QString &cachedPath : std::as_const(cachedPaths)) {
+        invalidateResource(cachedPath);
+    }
+
+    emit pluginResourcesUnregistered(pluginName);
+    qDebug() << "Unregistered plugin resources for:" << pluginName << "evicted:" << cachedPaths.size();
+    return true;
 }
 
 QUrl ResourceManager::getPluginResource(const QString &pluginName, const QString &resourceName) const
@@ -314,13 +499,136 @@ QUrl ResourceManager::getPluginResource(const QString &pluginName, const QString
         return QUrl();
     }
 
-    QString fullPath = m_pluginResourcePaths[pluginName] + "/" + resourceName;
-    if (!QFile::exists(fullPath)) {
-        qWarning() << "Plugin resource not found:" << fullPath;
+    const QString resourcePath = resolveResourcePath(pluginNamespace(pluginName), resourceName);
+    if (resourcePath.isEmpty()) {
         return QUrl();
     }
 
-    return QUrl::fromLocalFile(fullPath);
+    return QUrl::fromLocalFile(resourcePath);
+}
+
+QString ResourceManager::pluginNamespace(const QString &pluginName)
+{
+    return QStringLiteral("plugin:") + pluginName;
+}
+
+bool ResourceManager::mountArchive(const QString &archivePath)
+{
+    QSharedPointer<ResourceArchive> archive(new ResourceArchive());
+    if (!archive->open(archivePath)) {
+        emit resourceError(archivePath, archive->errorString());
+        return false;
+    }
+
+    // Cached entries and catalogs may point into the previous mapping.
+    clearCache();
+    unloadArchiveCatalogs();
+    {
+        QWriteLocker locker(&m_archiveLock);
+        m_archive = archive;
+        ++m_archiveGeneration;
+    }
+    m_materializedPrefixes.clear();
+    m_missingResources.clear();
+
+    qDebug() << "Mounted resource archive:" << archivePath << "entries:" << m_archive->entryCount();
+    return true;
+}
+
+void ResourceManager::unmountArchive()
+{
+    if (!m_archive) {
+        return;
+    }
+
+    clearCache();
+    unloadArchiveCatalogs();
+    {
+        QWriteLocker locker(&m_archiveLock);
+        m_archive.reset();
+        ++m_archiveGeneration;
+    }
+    m_materializedPrefixes.clear();
+    m_missingResources.clear();
+    qDebug() << "Unmounted resource archive";
+}
+
+bool ResourceManager::hasArchive() const
+{
+    return !m_archive.isNull();
+}
+
+void ResourceManager::unloadArchiveCatalogs()
+{
+    for (auto it = m_archiveCatalogs.constBegin(); it != m_archiveCatalogs.constEnd(); ++it) {
+        m_translations->unload(it.value(), it.key());
+    }
+    m_archiveCatalogs.clear();
+}
+
+QByteArray ResourceManager::imageData(const QString &imageName) const
+{
+    // Runs on decode threads: hold the archive for the whole read, and copy the
+    // bytes out of the mapping, which goes away when the archive is unmounted.
+    QElapsedTimer timer;
+    timer.start();
+    const QSharedPointer<ResourceArchive> archive = currentArchive();
+    if (archive) {
+        const QString entryName = archiveEntryName(*archive, "images", imageName);
+        if (!entryName.isEmpty()) {
+            const QString path = m_baseResourcePath + "/" + entryName;
+            bool ok = false;
+            QByteArray data = archive->read(entryName, &ok);
+            if (!ok) {
+                if (m_statisticsEnabled.loadRelaxed()) {
+                    m_stats->recordError("images", path);
+                }
+                emit const_cast<ResourceManager*>(this)->resourceError(path, QStringLiteral("Corrupt archive entry"));
+                return QByteArray();
+            }
+            data.detach();
+            if (m_statisticsEnabled.loadRelaxed()) {
+                m_stats->recordRead("images", path, data.size(), timer.nsecsElapsed(), ResourceStats::Archive);
+            }
+            return data;
+        }
+    }
+
+    const QString path = m_index->lookup("images", imageName);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (m_statisticsEnabled.loadRelaxed()) {
+            m_stats->recordError("images", path.isEmpty() ? imageName : path);
+        }
+        return QByteArray();
+    }
+    QByteArray data = file.readAll();
+    if (m_statisticsEnabled.loadRelaxed()) {
+        m_stats->recordRead("images", path, data.size(), timer.nsecsElapsed(), ResourceStats::Disk);
+    }
+    return data;
+}
+
+QString ResourceManager::imageCacheTag(const QString &imageName) const
+{
+    QSharedPointer<ResourceArchive> archive;
+    quint64 generation = 0;
+    {
+        QReadLocker locker(&m_archiveLock);
+        archive = m_archive;
+        generation = m_archiveGeneration;
+    }
+    if (archive && !archiveEntryName(*archive, "images", imageName).isEmpty()) {
+        return QLatin1Char('a') + QString::number(generation);
+    }
+
+    const QString path = m_index->lookup("images", imageName);
+    const QFileInfo fileInfo(path);
+    if (path.isEmpty() || !fileInfo.exists()) {
+        return QString();
+    }
+    return QString::number(fileInfo.size()) + QLatin1Char('-')
+           + QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
 }
 
 void ResourceManager::enableCache(bool enabled)
@@ -335,9 +643,120 @@ void ResourceManager::enableCache(bool enabled)
 void ResourceManager::clearCache()
 {
     m_resourceCache.clear();
+    m_configCache.clear();
+    const QStringList watchedFiles = m_cacheWatcher->files();
+    if (!watchedFiles.isEmpty()) {
+        m_cacheWatcher->removePaths(watchedFiles);
+    }
     qDebug() << "Resource cache cleared";
 }
 
+void ResourceManager::invalidateResource(const QString &resourcePath)
+{
+    m_configCache.remove(resourcePath);
+
+    auto it = m_resourceCache.find(resourcePath);
+    if (it == m_resourceCache.end()) {
+        return;
+    }
+
+    if (!it->fromArchive) {
+        m_cacheWatcher->removePath(resourcePath);
+    }
+    m_resourceCache.erase(it);
+    qDebug() << "Invalidated cached resource:" << resourcePath;
+}
+
+bool ResourceManager::flush()
+{
+    return m_writer->flush();
+}
+
+void ResourceManager::setWriteBehindEnabled(bool enabled)
+{
+    if (!enabled) {
+        flush();
+    }
+    m_writeBehindEnabled = enabled;
+}
+
+void ResourceManager::setWriteDebounceInterval(int msecs)
+{
+    m_writer->setDebounceInterval(msecs);
+}
+
+void ResourceManager::onResourceWritten(const QString &filePath)
+{
+    refreshIndexEntry(filePath);
+
+    // Adopt the new file stamp so the watcher does not evict bytes we wrote ourselves.
+    auto it = m_resourceCache.find(filePath);
+    if (it != m_resourceCache.end() && !it->fromArchive) {
+        const QFileInfo fileInfo(filePath);
+        if (fileInfo.size() == it->data.size()) {
+            it->size = fileInfo.size();
+            it->lastModified = fileInfo.lastModified();
+        }
+        if (!m_cacheWatcher->files().contains(filePath) && fileInfo.exists()) {
+            m_cacheWatcher->addPath(filePath);
+        }
+    }
+}
+
+QVariantMap ResourceManager::resourceStatistics(int topN) const
+{
+    return m_stats->toVariantMap(topN);
+}
+
+void ResourceManager::resetStatistics()
+{
+    m_stats->reset();
+}
+
+bool ResourceManager::dumpStatistics(const QString &filePath, int topN) const
+{
+    return m_stats->dumpToFile(filePath, topN);
+}
+
+void ResourceManager::setStatisticsEnabled(bool enabled)
+{
+    m_statisticsEnabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+void ResourceManager::setStatisticsDumpPath(const QString &filePath)
+{
+    m_statisticsDumpPath = filePath;
+}
+
+void ResourceManager::onAboutToQuit()
+{
+    flush();
+    if (!m_statisticsDumpPath.isEmpty()) {
+        dumpStatistics(m_statisticsDumpPath);
+    }
+}
+
+void ResourceManager::setCacheValidationEnabled(bool enabled)
+{
+    m_cacheValidationEnabled = enabled;
+}
+
+void ResourceManager::onCachedFileChanged(const QString &filePath)
+{
+    refreshIndexEntry(filePath);
+
+    auto it = m_resourceCache.constFind(filePath);
+    if (it != m_resourceCache.constEnd() && isCacheEntryCurrent(filePath, it.value())) {
+        // Our own write: the cached bytes already match the file.
+        if (!m_cacheWatcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+            m_cacheWatcher->addPath(filePath);
+        }
+        return;
+    }
+
+    invalidateResource(filePath);
+}
+
 void ResourceManager::preloadResources(const QStringList &resourcePaths)
 {
     for (const QString &resourcePath : resourcePaths) {
@@ -360,48 +779,276 @@ bool ResourceManager::isValidResourcePath(const QString &path) const
 
 QString ResourceManager::resolveResourcePath(const QString &resourceType, const QString &resourceName) const
 {
-    if (!m_resourcePaths.contains(resourceType)) {
+    auto missingIt = m_missingResources.constFind(resourceType);
+    if (missingIt != m_missingResources.constEnd() && missingIt->contains(resourceName)) {
+        return QString();
+    }
+
+    const ResourceEntry entry = m_index->entry(resourceType, resourceName);
+    if (entry.isValid()) {
+        return entry.path;
+    }
+
+    const QString entryName = archiveEntryName(resourceType, resourceName);
+    if (!entryName.isEmpty()) {
+        return m_baseResourcePath + "/" + entryName;
+    }
+
+    if (m_index->directories(resourceType).isEmpty()) {
         qWarning() << "Resource type not registered:" << resourceType;
         return QString();
     }
 
-    const QStringList &paths = m_resourcePaths[resourceType];
-    for (const QString &path : paths) {
-        QString fullPath = path + "/" + resourceName;
-        if (QFile::exists(fullPath)) {
-            return fullPath;
+    // Remember the miss until the type's index changes, and warn only once for it.
+    const_cast<ResourceManager*>(this)->m_missingResources[resourceType].insert(resourceName);
+    qWarning() << "Resource not found:" << resourceName << "for type:" << resourceType;
+    return QString();
+}
+
+QStringList ResourceManager::listResources(const QString &resourceType) const
+{
+    QStringList names = m_index->listing(resourceType);
+    if (!m_archive) {
+        return names;
+    }
+
+    const QStringList nameFilters = nameFiltersForType(resourceType);
+    QSet<QString> known(names.cbegin(), names.cend());
+    const QString basePrefix = m_baseResourcePath + "/";
+    const QStringList directories = m_index->directories(resourceType);
+    for (const QString &directory : directories) {
+        if (!directory.startsWith(basePrefix)) {
+            continue;
+        }
+        const QString prefix = directory.mid(basePrefix.size()) + "/";
+        const QStringList entries = m_archive->entryNames(prefix);
+        for (const QString &entry : entries) {
+            const QString name = entry.mid(prefix.size());
+            if (name.contains('/') || known.contains(name)
+                || (!nameFilters.isEmpty() && !QDir::match(nameFilters, name))) {
+                continue;
+            }
+            known.insert(name);
+            names.append(name);
         }
     }
+    return names;
+}
 
-    qWarning() << "Resource not found:" << resourceName << "for type:" << resourceType;
+QSharedPointer<ResourceArchive> ResourceManager::currentArchive() const
+{
+    QReadLocker locker(&m_archiveLock);
+    return m_archive;
+}
+
+QString ResourceManager::archiveEntryName(const QString &resourceType, const QString &resourceName) const
+{
+    if (!m_archive) {
+        return QString();
+    }
+    return archiveEntryName(*m_archive, resourceType, resourceName);
+}
+
+QString ResourceManager::archiveEntryName(const ResourceArchive &archive, const QString &resourceType,
+                                          const QString &resourceName) const
+{
+    // Loose files win over archived ones, so resources saved after packing are not shadowed.
+    if (m_index->contains(resourceType, resourceName)) {
+        return QString();
+    }
+
+    const QString basePrefix = m_baseResourcePath + "/";
+    const QStringList directories = m_index->directories(resourceType);
+    for (const QString &directory : directories) {
+        if (!directory.startsWith(basePrefix)) {
+            continue;
+        }
+        const QString entryName = directory.mid(basePrefix.size()) + "/" + resourceName;
+        if (archive.contains(entryName)) {
+            return entryName;
+        }
+    }
     return QString();
 }
 
+QString ResourceManager::archiveEntryForPath(const QString &resourcePath) const
+{
+    if (!m_archive || m_baseResourcePath.isEmpty()) {
+        return QString();
+    }
+
+    const QString basePrefix = m_baseResourcePath + "/";
+    if (!resourcePath.startsWith(basePrefix)) {
+        return QString();
+    }
+
+    const QString entryName = resourcePath.mid(basePrefix.size());
+    if (!m_archive->contains(entryName) || QFileInfo::exists(resourcePath)) {
+        return QString();
+    }
+    return entryName;
+}
+
+QString ResourceManager::materializeArchiveEntry(const QString &entryName)
+{
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                              + "/resource-archive/" + QString::number(m_archive->lastModified());
+    const QString prefix = entryName.section('/', 0, 0) + "/";
+
+    // Unpack the whole top-level directory so relative imports keep resolving.
+    if (!m_materializedPrefixes.contains(prefix)) {
+        const QStringList entries = m_archive->entryNames(prefix);
+        for (const QString &entry : entries) {
+            const QString targetPath = cacheRoot + "/" + entry;
+            if (QFileInfo::exists(targetPath)) {
+                continue;
+            }
+
+            bool ok = false;
+            const QByteArray data = m_archive->read(entry, &ok);
+            if (!ok) {
+                emit resourceError(entry, QStringLiteral("Corrupt archive entry"));
+                return QString();
+            }
+
+            QDir().mkpath(QFileInfo(targetPath).absolutePath());
+            QSaveFile file(targetPath);
+            if (!file.open(QIODevice::WriteOnly)
+                || file.write(data) == -1
+                || !file.commit()) {
+                qWarning() << "Failed to unpack archived resource:" << entry << "to" << targetPath;
+                emit resourceError(entry, file.errorString());
+                return QString();
+            }
+        }
+        m_materializedPrefixes.insert(prefix);
+    }
+
+    return cacheRoot + "/" + entryName;
+}
+
 QByteArray ResourceManager::getResourceData(const QString &resourcePath) const
 {
-    if (m_cacheEnabled && m_resourceCache.contains(resourcePath)) {
-        return m_resourceCache[resourcePath];
+    QElapsedTimer timer;
+    timer.start();
+    auto record = [&](const QByteArray &data, ResourceStats::Source source) {
+        if (m_statisticsEnabled.loadRelaxed()) {
+            const qint64 elapsedNs = timer.nsecsElapsed();
+            m_stats->recordRead(m_index->typeForPath(resourcePath), resourcePath, data.size(), elapsedNs, source);
+        }
+    };
+
+    if (m_cacheEnabled) {
+        auto it = m_resourceCache.constFind(resourcePath);
+        if (it != m_resourceCache.constEnd()) {
+            if (!m_cacheValidationEnabled || isCacheEntryCurrent(resourcePath, it.value())) {
+                if (m_statisticsEnabled.loadRelaxed()) {
+                    m_stats->recordRead(it->type, resourcePath, it->data.size(), timer.nsecsElapsed(),
+                                        ResourceStats::Cache);
+                }
+                return it->data;
+            }
+            const_cast<ResourceManager*>(this)->invalidateResource(resourcePath);
+        }
+    }
+
+    QByteArray pending;
+    if (m_writer->pendingData(resourcePath, &pending)) {
+        record(pending, ResourceStats::Pending);
+        return pending;
+    }
+
+    auto *self = const_cast<ResourceManager*>(this);
+    const QString entryName = archiveEntryForPath(resourcePath);
+    if (!entryName.isEmpty()) {
+        bool ok = false;
+        QByteArray data = m_archive->read(entryName, &ok);
+        if (!ok) {
+            if (m_statisticsEnabled.loadRelaxed()) {
+                m_stats->recordError(m_index->typeForPath(resourcePath), resourcePath);
+            }
+            emit self->resourceError(resourcePath, QStringLiteral("Corrupt archive entry"));
+            return QByteArray();
+        }
+        // Callers may keep the bytes past an unmount, so views into the mapping are copied.
+        data.detach();
+        // Only inflated entries are worth caching; stored ones are a plain copy.
+        if (m_cacheEnabled && m_archive->isCompressed(entryName)) {
+            self->cacheResource(resourcePath, data, true);
+        }
+        record(data, ResourceStats::Archive);
+        emit self->resourceLoaded(resourcePath);
+        return data;
     }
 
     QFile file(resourcePath);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open resource:" << resourcePath;
+        if (m_statisticsEnabled.loadRelaxed()) {
+            m_stats->recordError(m_index->typeForPath(resourcePath), resourcePath);
+        }
+        emit self->resourceError(resourcePath, file.errorString());
         return QByteArray();
     }
 
     QByteArray data = file.readAll();
     file.close();
+    record(data, ResourceStats::Disk);
 
     if (m_cacheEnabled) {
-        const_cast<ResourceManager*>(this)->cacheResource(resourcePath, data);
+        self->cacheResource(resourcePath, data);
     }
 
+    emit self->resourceLoaded(resourcePath);
     return data;
 }
 
-void ResourceManager::cacheResource(const QString &resourcePath, const QByteArray &data)
+void ResourceManager::cacheResource(const QString &resourcePath, const QByteArray &data, bool fromArchive)
 {
-    if (m_cacheEnabled) {
-        m_resourceCache[resourcePath] = data;
+    if (!m_cacheEnabled) {
+        return;
+    }
+
+    // New bytes make any parsed form of the old ones stale.
+    m_configCache.remove(resourcePath);
+
+    CachedResource cached;
+    cached.data = data;
+    cached.fromArchive = fromArchive;
+    cached.type = m_index->typeForPath(resourcePath);
+    if (!fromArchive) {
+        const QFileInfo fileInfo(resourcePath);
+        cached.size = fileInfo.size();
+        cached.lastModified = fileInfo.lastModified();
+        // Loose cached files are exactly the watched set, so only new entries need a watch.
+        if (!m_resourceCache.contains(resourcePath) && fileInfo.exists()) {
+            m_cacheWatcher->addPath(resourcePath);
+        }
+    }
+    m_resourceCache.insert(resourcePath, cached);
+}
+
+bool ResourceManager::isCacheEntryCurrent(const QString &resourcePath, const CachedResource &cached) const
+{
+    if (cached.fromArchive) {
+        return true;
+    }
+
+    const QFileInfo fileInfo(resourcePath);
+    return fileInfo.exists()
+           && fileInfo.size() == cached.size
+           && fileInfo.lastModified() == cached.lastModified;
+}
+
+void ResourceManager::refreshIndexEntry(const QString &resourcePath)
+{
+    QString resourceName;
+    const QString resourceType = m_index->typeForPath(resourcePath, &resourceName);
+    if (!resourceType.isEmpty()) {
+        m_index->refreshEntry(resourceType, resourceName);
+        auto it = m_missingResources.find(resourceType);
+        if (it != m_missingResources.end()) {
+            it->remove(resourceName);
+        }
     }
 }
\ No newline at end of file
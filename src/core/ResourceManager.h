@@ -8,6 +8,22 @@
 #include <QDir>
 #include <QUrl>
 #include <QResource>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <QSet>
+#include <QHash>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QJsonValue>
+
+class QFileSystemWatcher;
+class ResourceIndex;
+class ResourceWriter;
+class TranslationManager;
+class ResourceStats;
+class ResourceArchive;
 
 class ResourceManager : public QObject
 {
@@ -32,6 +48,11 @@ public:
     Q_INVOKABLE QByteArray readBinaryResource(const QString &resourcePath) const;
     Q_INVOKABLE bool saveResource(const QString &resourcePath, const QByteArray &data) const;
 
+    // Write-behind saving; flush() must run before shutdown
+    Q_INVOKABLE bool flush();
+    void setWriteBehindEnabled(bool enabled);
+    void setWriteDebounceInterval(int msecs);
+
     // QML resources
     Q_INVOKABLE QUrl getQmlResource(const QString &qmlName) const;
     Q_INVOKABLE QStringList getAvailableQmlResources() const;
@@ -46,39 +67,119 @@ public:
 
     // Translation resources
     Q_INVOKABLE bool loadTranslation(const QString &translationFile, const QString &locale = QString());
+    Q_INVOKABLE bool setLocale(const QString &locale);
+    TranslationManager *translations() const;
     Q_INVOKABLE QStringList getAvailableTranslations() const;
 
     // Configuration resources
     Q_INVOKABLE QVariantMap loadConfig(const QString &configName) const;
     Q_INVOKABLE bool saveConfig(const QString &configName, const QVariantMap &config) const;
+    // Dotted key path into the cached document, e.g. config("app", "network.timeoutMs")
+    Q_INVOKABLE QVariant config(const QString &configName, const QString &keyPath,
+                                const QVariant &defaultValue = QVariant()) const;
+    QJsonValue configValue(const QString &configName, const QString &keyPath) const;
+
+    template <typename T>
+    T configAs(const QString &configName, const QString &keyPath, const T &defaultValue = T()) const
+    {
+        const QVariant value = config(configName, keyPath);
+        return value.isValid() && value.canConvert<T>() ? value.value<T>() : defaultValue;
+    }
 
     // Plugin resources
     Q_INVOKABLE bool registerPluginResources(const QString &pluginName, const QString &resourcePath);
     Q_INVOKABLE bool unregisterPluginResources(const QString &pluginName);
     Q_INVOKABLE QUrl getPluginResource(const QString &pluginName, const QString &resourceName) const;
 
+    // Packed resource archives
+    bool mountArchive(const QString &archivePath);
+    void unmountArchive();
+    bool hasArchive() const;
+
+    // Raw image bytes by name, owned by the caller; callable from image provider threads
+    QByteArray imageData(const QString &imageName) const;
+    // Changes whenever the bytes imageData() would return change: the archive
+    // mount for archived images, size and mtime for files. Empty when missing.
+    QString imageCacheTag(const QString &imageName) const;
+
     // Resource caching
     void enableCache(bool enabled);
     void clearCache();
+    Q_INVOKABLE void invalidateResource(const QString &resourcePath);
+    // Re-stat cached files on every hit; for mounts where file watching is unreliable
+    void setCacheValidationEnabled(bool enabled);
     Q_INVOKABLE void preloadResources(const QStringList &resourcePaths);
 
+    // Load statistics; dumped as JSON at shutdown when a dump path (or APP_RESOURCE_STATS) is set
+    Q_INVOKABLE QVariantMap resourceStatistics(int topN = 10) const;
+    Q_INVOKABLE void resetStatistics();
+    bool dumpStatistics(const QString &filePath, int topN = 10) const;
+    void setStatisticsEnabled(bool enabled);
+    void setStatisticsDumpPath(const QString &filePath);
+
 signals:
     void resourceLoaded(const QString &resourcePath);
     void resourceError(const QString &resourcePath, const QString &error);
     void pluginResourcesRegistered(const QString &pluginName);
     void pluginResourcesUnregistered(const QString &pluginName);
 
+private slots:
+    void onCachedFileChanged(const QString &filePath);
+    void onResourceWritten(const QString &filePath);
+    void onAboutToQuit();
+
 private:
+    struct CachedResource {
+        QByteArray data;
+        qint64 size = -1;
+        QDateTime lastModified;
+        bool fromArchive = false;
+        // Resolved once when cached, so hits are counted without a lookup
+        QString type;
+    };
+
     static ResourceManager* s_instance;
 
     QString m_baseResourcePath;
-    QMap<QString, QStringList> m_resourcePaths;
-    QMap<QString, QByteArray> m_resourceCache;
-    QMap<QString, QString> m_pluginResourcePaths;
+    ResourceIndex *m_index;
+    // Replaced only on the GUI thread, under the write lock; other threads
+    // take a reference under the read lock and keep the mapping alive with it.
+    QSharedPointer<ResourceArchive> m_archive;
+    quint64 m_archiveGeneration = 0;
+    mutable QReadWriteLock m_archiveLock;
+    QSet<QString> m_materializedPrefixes;
+    QHash<QString, CachedResource> m_resourceCache;
+    QHash<QString, QJsonObject> m_configCache;
+    QFileSystemWatcher *m_cacheWatcher;
+    ResourceWriter *m_writer;
+    TranslationManager *m_translations;
+    // Catalog path -> locale, for catalogs loaded from the archive mapping
+    QHash<QString, QString> m_archiveCatalogs;
+    QHash<QString, QString> m_pluginResourcePaths;
+    QHash<QString, QSet<QString>> m_missingResources;
     bool m_cacheEnabled;
+    bool m_cacheValidationEnabled;
+    bool m_writeBehindEnabled;
+    QScopedPointer<ResourceStats> m_stats;
+    // Read by image decode threads
+    QAtomicInt m_statisticsEnabled;
+    QString m_statisticsDumpPath;
 
     bool isValidResourcePath(const QString &path) const;
     QString resolveResourcePath(const QString &resourceType, const QString &resourceName) const;
+    QStringList listResources(const QString &resourceType) const;
+    QJsonObject configObject(const QString &configName) const;
+    QSharedPointer<ResourceArchive> currentArchive() const;
+    QString archiveEntryName(const QString &resourceType, const QString &resourceName) const;
+    QString archiveEntryName(const ResourceArchive &archive, const QString &resourceType,
+                             const QString &resourceName) const;
+    QString archiveEntryForPath(const QString &resourcePath) const;
+    QString materializeArchiveEntry(const QString &entryName);
+    bool loadTranslationCatalog(const QString &translationFile, const QString &locale);
+    void unloadArchiveCatalogs();
+    static QString pluginNamespace(const QString &pluginName);
     QByteArray getResourceData(const QString &resourcePath) const;
-    void cacheResource(const QString &resourcePath, const QByteArray &data);
+    void cacheResource(const QString &resourcePath, const QByteArray &data, bool fromArchive = false);
+    bool isCacheEntryCurrent(const QString &resourcePath, const CachedResource &cached) const;
+    void refreshIndexEntry(const QString &resourcePath);
 };
\ No newline at end of file
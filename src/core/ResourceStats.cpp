@@ -0,0 +1,175 @@
+#include "ResourceStats.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+
+namespace {
+int latencyBucket(qint64 elapsedNs)
+{
+    quint64 micros = quint64(qMax<qint64>(elapsedNs, 0)) / 1000;
+    int bucket = 0;
+    while (micros > 1 && bucket < ResourceStats::kLatencyBuckets - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+}
+
+void ResourceStats::recordRead(const QString &resourceType, const QString &resourcePath,
+                               qint64 bytes, qint64 elapsedNs, Source source)
+{
+    QMutexLocker locker(&m_mutex);
+    TypeStats &stats = m_types[resourceType];
+    ++stats.reads;
+    stats.bytes += quint64(qMax<qint64>(bytes, 0));
+
+    switch (source) {
+    case Cache:
+    case Pending:
+        ++stats.cacheHits;
+        return;
+    case Archive:
+        ++stats.archiveReads;
+        break;
+    case Disk:
+        ++stats.diskReads;
+        stats.diskNs += quint64(qMax<qint64>(elapsedNs, 0));
+        break;
+    }
+
+    // Only loads that actually went to storage count towards latency and slow paths.
+    ++stats.cacheMisses;
+    ++stats.latency[size_t(latencyBucket(elapsedNs))];
+
+    if (m_paths.size() >= kMaxTrackedPaths && !m_paths.contains(resourcePath)) {
+        pruneFastestPaths();
+    }
+    PathStats &pathStats = m_paths[resourcePath];
+    pathStats.resourceType = resourceType;
+    ++pathStats.loads;
+    pathStats.totalNs += quint64(qMax<qint64>(elapsedNs, 0));
+    pathStats.maxNs = qMax(pathStats.maxNs, quint64(qMax<qint64>(elapsedNs, 0)));
+}
+
+void ResourceStats::recordError(const QString &resourceType, const QString &resourcePath)
+{
+    Q_UNUSED(resourcePath)
+    QMutexLocker locker(&m_mutex);
+    ++m_types[resourceType].errors;
+}
+
+void ResourceStats::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_types.clear();
+    m_paths.clear();
+    m_droppedPaths = 0;
+}
+
+QVariantMap ResourceStats::toVariantMap(int topN) const
+{
+    return toJson(topN).toVariantMap();
+}
+
+QJsonObject ResourceStats::toJson(int topN) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject types;
+    for (auto it = m_types.constBegin(); it != m_types.constEnd(); ++it) {
+        const TypeStats &stats = it.value();
+
+        QJsonArray latency;
+        for (quint64 count : stats.latency) {
+            latency.append(double(count));
+        }
+
+        QJsonObject typeObject;
+        typeObject["reads"] = double(stats.reads);
+        typeObject["bytes"] = double(stats.bytes);
+        typeObject["diskReads"] = double(stats.diskReads);
+        typeObject["diskTimeMs"] = double(stats.diskNs) / 1e6;
+        typeObject["archiveReads"] = double(stats.archiveReads);
+        typeObject["cacheHits"] = double(stats.cacheHits);
+        typeObject["cacheMisses"] = double(stats.cacheMisses);
+        typeObject["errors"] = double(stats.errors);
+        typeObject["latencyHistogramLog2Us"] = latency;
+        types[it.key().isEmpty() ? QStringLiteral("other") : it.key()] = typeObject;
+    }
+
+    QList<QHash<QString, PathStats>::const_iterator> slowest;
+    slowest.reserve(m_paths.size());
+    for (auto it = m_paths.constBegin(); it != m_paths.constEnd(); ++it) {
+        slowest.append(it);
+    }
+    const int count = qMin(qMax(topN, 0), int(slowest.size()));
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+                      [](const auto &a, const auto &b) { return a->maxNs > b->maxNs; });
+
+    QJsonArray slowestPaths;
+    for (int i = 0; i < count; ++i) {
+        const PathStats &stats = slowest.at(i).value();
+        QJsonObject pathObject;
+        pathObject["path"] = slowest.at(i).key();
+        pathObject["type"] = stats.resourceType;
+        pathObject["loads"] = double(stats.loads);
+        pathObject["maxMs"] = double(stats.maxNs) / 1e6;
+        pathObject["totalMs"] = double(stats.totalNs) / 1e6;
+        slowestPaths.append(pathObject);
+    }
+
+    QJsonObject result;
+    result["types"] = types;
+    result["slowestPaths"] = slowestPaths;
+    result["trackedPaths"] = double(m_paths.size());
+    result["droppedPaths"] = double(m_droppedPaths);
+    return result;
+}
+
+bool ResourceStats::dumpToFile(const QString &filePath, int topN) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open resource statistics file:" << filePath << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson(topN)).toJson());
+    if (!file.commit()) {
+        qWarning() << "Failed to write resource statistics file:" << filePath << file.errorString();
+        return false;
+    }
+
+    qDebug() << "Resource statistics written to:" << filePath;
+    return true;
+}
+
+void ResourceStats::pruneFastestPaths()
+{
+    // Halving at once keeps the amortised cost per new path constant.
+    QList<quint64> maxima;
+    maxima.reserve(m_paths.size());
+    for (const PathStats &stats : std::as_const(m_paths)) {
+        maxima.append(stats.maxNs);
+    }
+    const qsizetype keep = kMaxTrackedPaths / 2;
+    std::nth_element(maxima.begin(), maxima.begin() + (keep - 1), maxima.end(), std::greater<quint64>());
+    const quint64 threshold = maxima.at(keep - 1);
+    // Paths tied at the threshold fill what the slower ones leave of the budget.
+    qsizetype tiesToKeep = keep - std::count_if(maxima.cbegin(), maxima.cend(),
+                                                [threshold](quint64 maxNs) { return maxNs > threshold; });
+
+    for (auto it = m_paths.begin(); it != m_paths.end();) {
+        if (it->maxNs > threshold || (it->maxNs == threshold && tiesToKeep-- > 0)) {
+            ++it;
+        } else {
+            it = m_paths.erase(it);
+            ++m_droppedPaths;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QVariantMap>
+#include <QJsonObject>
+#include <array>
+
+// Per-resource-type load counters, a log2 latency histogram and per-path
+// timings for finding slow or hot assets. Per-type counters are exact; the
+// per-path table is bounded and keeps the slowest paths once full. All
+// methods are thread-safe.
+class ResourceStats
+{
+public:
+    enum Source {
+        Disk,
+        Archive,
+        Cache,
+        Pending
+    };
+
+    static constexpr int kLatencyBuckets = 24;
+    // Past this many paths the faster half is dropped
+    static constexpr int kMaxTrackedPaths = 1024;
+
+    void recordRead(const QString &resourceType, const QString &resourcePath,
+                    qint64 bytes, qint64 elapsedNs, Source source);
+    void recordError(const QString &resourceType, const QString &resourcePath);
+    void reset();
+
+    QVariantMap toVariantMap(int topN = 10) const;
+    QJsonObject toJson(int topN = 10) const;
+    bool dumpToFile(const QString &filePath, int topN = 10) const;
+
+private:
+    struct TypeStats {
+        quint64 reads = 0;
+        quint64 bytes = 0;
+        quint64 diskReads = 0;
+        quint64 diskNs = 0;
+        quint64 archiveReads = 0;
+        quint64 cacheHits = 0;
+        quint64 cacheMisses = 0;
+        quint64 errors = 0;
+        // Bucket i counts loads that took [2^i, 2^(i+1)) microseconds.
+        std::array<quint64, kLatencyBuckets> latency{};
+    };
+
+    struct PathStats {
+        QString resourceType;
+        quint64 loads = 0;
+        quint64 totalNs = 0;
+        quint64 maxNs = 0;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, TypeStats> m_types;
+    QHash<QString, PathStats> m_paths;
+    quint64 m_droppedPaths = 0;
+
+    void pruneFastestPaths();
+};
@@ -0,0 +1,151 @@
+#include "ResourceWriter.h"
+#include <QThread>
+#include <QTimer>
+#include <QSaveFile>
+#include <QMutexLocker>
+#include <QDebug>
+#include <utility>
+
+namespace {
+constexpr int kDefaultDebounceMs = 250;
+}
+
+ResourceWriter::ResourceWriter(QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_timer(new QTimer())
+    , m_debounceInterval(kDefaultDebounceMs)
+{
+    m_thread->setObjectName("ResourceWriter");
+
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(kDefaultDebounceMs);
+    m_timer->moveToThread(m_thread);
+
+    // The timer lives on the writer thread, so the batch is written there.
+    connect(m_timer, &QTimer::timeout, m_timer, [this]() {
+        writePending();
+    });
+
+    m_thread->start(QThread::LowPriority);
+}
+
+ResourceWriter::~ResourceWriter()
+{
+    flush();
+
+    QMetaObject::invokeMethod(m_timer, &QTimer::stop, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_timer;
+}
+
+void ResourceWriter::enqueue(const QString &filePath, const QByteArray &data)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.insert(filePath, data);
+    }
+
+    // A fixed window from the first queued save, so a steady stream of saves still gets written.
+    QMetaObject::invokeMethod(m_timer, [this]() {
+        if (!m_timer->isActive()) {
+            m_timer->start();
+        }
+    });
+}
+
+bool ResourceWriter::pendingData(const QString &filePath, QByteArray *data) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pending.constFind(filePath);
+    if (it == m_pending.constEnd()) {
+        it = m_inFlight.constFind(filePath);
+        if (it == m_inFlight.constEnd()) {
+            return false;
+        }
+    }
+
+    if (data) {
+        *data = it.value();
+    }
+    return true;
+}
+
+bool ResourceWriter::hasPendingWrites() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_pending.isEmpty() || !m_inFlight.isEmpty();
+}
+
+bool ResourceWriter::flush()
+{
+    return writePending();
+}
+
+void ResourceWriter::setDebounceInterval(int msecs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_debounceInterval = msecs;
+    }
+    QMetaObject::invokeMethod(m_timer, [this, msecs]() {
+        m_timer->setInterval(msecs);
+    });
+}
+
+int ResourceWriter::debounceInterval() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_debounceInterval;
+}
+
+bool ResourceWriter::writeFile(const QString &filePath, const QByteArray &data, QString *errorString)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    if (file.write(data) == -1 || !file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool ResourceWriter::writePending()
+{
+    // Serialises batches so a flush never overtakes an in-progress background write.
+    QMutexLocker writeLocker(&m_writeMutex);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pending.isEmpty()) {
+            return true;
+        }
+        m_inFlight = std::exchange(m_pending, QHash<QString, QByteArray>());
+    }
+
+    bool success = true;
+    for (auto it = m_inFlight.constBegin(); it != m_inFlight.constEnd(); ++it) {
+        QString error;
+        if (writeFile(it.key(), it.value(), &error)) {
+            emit written(it.key());
+        } else {
+            qWarning() << "Failed to write resource:" << it.key() << error;
+            emit writeFailed(it.key(), error);
+            success = false;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_inFlight.clear();
+    return success;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+class QThread;
+class QTimer;
+
+// Write-behind writer for resource files. Saves are queued, repeated saves
+// to the same path within the debounce window collapse into one write, and
+// writes happen atomically (QSaveFile) on a dedicated background thread.
+class ResourceWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResourceWriter(QObject *parent = nullptr);
+    ~ResourceWriter();
+
+    void enqueue(const QString &filePath, const QByteArray &data);
+    bool pendingData(const QString &filePath, QByteArray *data = nullptr) const;
+    bool hasPendingWrites() const;
+    bool flush();
+
+    void setDebounceInterval(int msecs);
+    int debounceInterval() const;
+
+    static bool writeFile(const QString &filePath, const QByteArray &data, QString *errorString = nullptr);
+
+signals:
+    void written(const QString &filePath);
+    void writeFailed(const QString &filePath, const QString &error);
+
+private:
+    mutable QMutex m_mutex;
+    QMutex m_writeMutex;
+    QHash<QString, QByteArray> m_pending;
+    QHash<QString, QByteArray> m_inFlight;
+    QThread *m_thread;
+    QTimer *m_timer;
+    int m_debounceInterval;
+
+    bool writePending();
+};
@@ -0,0 +1,232 @@
+#include "TranslationManager.h"
+#include <QCoreApplication>
+#include <QTranslator>
+#include <QQmlEngine>
+#include <QFileInfo>
+#include <QLocale>
+#include <algorithm>
+#include <QDebug>
+
+TranslationManager::TranslationManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TranslationManager::~TranslationManager()
+{
+    const QStringList locales = m_catalogs.keys();
+    for (const QString &locale : locales) {
+        unload(locale);
+    }
+}
+
+bool TranslationManager::loadFile(const QString &locale, const QString &filePath)
+{
+    if (isLoaded(locale, filePath)) {
+        return true;
+    }
+
+    auto *translator = new QTranslator(this);
+    if (!translator->load(filePath)) {
+        qWarning() << "Failed to load translation:" << filePath;
+        delete translator;
+        return false;
+    }
+
+    qDebug() << "Translation catalog loaded for locale:" << locale << "from" << filePath;
+    return addCatalog(locale, {filePath, translator, QByteArray()});
+}
+
+bool TranslationManager::loadData(const QString &locale, const QByteArray &data, const QString &source)
+{
+    if (isLoaded(locale, source)) {
+        return true;
+    }
+
+    auto *translator = new QTranslator(this);
+    // QTranslator does not copy the buffer; the catalog keeps a reference to it.
+    if (!translator->load(reinterpret_cast<const uchar *>(data.constData()), int(data.size()))) {
+        qWarning() << "Failed to load translation data for locale:" << locale << "from" << source;
+        delete translator;
+        return false;
+    }
+
+    qDebug() << "Translation catalog loaded for locale:" << locale << "from" << source;
+    return addCatalog(locale, {source, translator, data});
+}
+
+void TranslationManager::unload(const QString &locale)
+{
+    auto it = m_catalogs.find(locale);
+    if (it == m_catalogs.end()) {
+        return;
+    }
+
+    const bool current = locale == m_currentLocale;
+    for (const Catalog &catalog : std::as_const(*it)) {
+        if (current) {
+            QCoreApplication::removeTranslator(catalog.translator);
+        }
+        delete catalog.translator;
+    }
+    m_catalogs.erase(it);
+    if (current) {
+        m_currentLocale.clear();
+    }
+}
+
+void TranslationManager::unload(const QString &locale, const QString &source)
+{
+    auto it = m_catalogs.find(locale);
+    if (it == m_catalogs.end()) {
+        return;
+    }
+
+    for (qsizetype i = 0; i < it->size(); ++i) {
+        const Catalog catalog = it->at(i);
+        if (catalog.source != source) {
+            continue;
+        }
+        it->removeAt(i);
+        if (locale == m_currentLocale) {
+            QCoreApplication::removeTranslator(catalog.translator);
+            retranslate();
+        }
+        delete catalog.translator;
+        break;
+    }
+
+    if (it->isEmpty()) {
+        m_catalogs.erase(it);
+        if (locale == m_currentLocale) {
+            m_currentLocale.clear();
+        }
+    }
+}
+
+bool TranslationManager::activate(const QString &locale)
+{
+    if (locale == m_currentLocale) {
+        return true;
+    }
+
+    auto it = m_catalogs.constFind(locale);
+    if (it == m_catalogs.constEnd()) {
+        qWarning() << "Translation catalog not loaded for locale:" << locale;
+        return false;
+    }
+
+    if (!m_currentLocale.isEmpty()) {
+        for (const Catalog &catalog : m_catalogs.value(m_currentLocale)) {
+            QCoreApplication::removeTranslator(catalog.translator);
+        }
+    }
+
+    int installed = 0;
+    for (const Catalog &catalog : *it) {
+        if (QCoreApplication::installTranslator(catalog.translator)) {
+            ++installed;
+        } else {
+            qWarning() << "Failed to install translator for locale:" << locale << "from" << catalog.source;
+        }
+    }
+    if (installed == 0) {
+        m_currentLocale.clear();
+        return false;
+    }
+
+    m_currentLocale = locale;
+    retranslate();
+
+    qDebug() << "Translation switched to locale:" << locale;
+    emit localeChanged(locale);
+    return true;
+}
+
+bool TranslationManager::isLoaded(const QString &locale) const
+{
+    return m_catalogs.contains(locale);
+}
+
+bool TranslationManager::isLoaded(const QString &locale, const QString &source) const
+{
+    const auto it = m_catalogs.constFind(locale);
+    if (it == m_catalogs.constEnd()) {
+        return false;
+    }
+    return std::any_of(it->cbegin(), it->cend(), [&source](const Catalog &catalog) {
+        return catalog.source == source;
+    });
+}
+
+QStringList TranslationManager::loadedLocales() const
+{
+    return m_catalogs.keys();
+}
+
+QString TranslationManager::currentLocale() const
+{
+    return m_currentLocale;
+}
+
+void TranslationManager::setEngine(QQmlEngine *engine)
+{
+    m_engine = engine;
+}
+
+bool TranslationManager::addCatalog(const QString &locale, Catalog catalog)
+{
+    m_catalogs[locale].append(catalog);
+
+    // A catalog added to the active locale takes effect right away.
+    if (locale == m_currentLocale) {
+        if (!QCoreApplication::installTranslator(catalog.translator)) {
+            qWarning() << "Failed to install translator for locale:" << locale << "from" << catalog.source;
+        }
+        retranslate();
+    }
+    return true;
+}
+
+void TranslationManager::retranslate()
+{
+    if (m_engine) {
+        m_engine->retranslate();
+    }
+}
+
+QString TranslationManager::localeFromFileName(const QString &fileName)
+{
+    // The locale is the tail of the name: language[_Script][_REGION]. Prefixes
+    // may contain '_' themselves ("my_app_zh_CN"), so parse from the end.
+    const QStringList parts = QFileInfo(fileName).completeBaseName().split('_');
+    auto isAsciiRun = [](const QString &part, bool upper) {
+        return std::all_of(part.cbegin(), part.cend(), [upper](QChar c) {
+            return upper ? (c >= 'A' && c <= 'Z') : (c >= 'a' && c <= 'z');
+        });
+    };
+    auto isRegion = [&](const QString &part) {
+        const bool digits = std::all_of(part.cbegin(), part.cend(), [](QChar c) { return c.isDigit(); });
+        return (part.size() == 2 && isAsciiRun(part, true)) || (part.size() == 3 && digits);
+    };
+    auto isScript = [&](const QString &part) {
+        return part.size() == 4 && isAsciiRun(part.left(1), true) && isAsciiRun(part.mid(1), false);
+    };
+    auto isLanguage = [&](const QString &part) {
+        return (part.size() == 2 || part.size() == 3) && isAsciiRun(part, false)
+               && QLocale(part).language() != QLocale::C;
+    };
+
+    qsizetype first = parts.size();
+    if (first > 0 && isRegion(parts.at(first - 1))) {
+        --first;
+    }
+    if (first > 0 && isScript(parts.at(first - 1))) {
+        --first;
+    }
+    if (first == 0 || !isLanguage(parts.at(first - 1))) {
+        return QString();
+    }
+    --first;
+    return parts.mid(first).join('_');
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+#include <QPointer>
+
+class QTranslator;
+class QQmlEngine;
+
+// Keeps the loaded catalogs of each locale (one translator per source
+// file) and switches between locales by swapping the installed set, so
+// tr() only searches the active locale's catalogs and switching back to a
+// locale never reloads it.
+class TranslationManager : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString currentLocale READ currentLocale NOTIFY localeChanged)
+
+public:
+    explicit TranslationManager(QObject *parent = nullptr);
+    ~TranslationManager();
+
+    // Loading; .qm files are memory-mapped by QTranslator, in-memory data must stay alive.
+    // A source already loaded for the locale is not loaded again.
+    bool loadFile(const QString &locale, const QString &filePath);
+    bool loadData(const QString &locale, const QByteArray &data, const QString &source);
+    void unload(const QString &locale);
+    void unload(const QString &locale, const QString &source);
+
+    Q_INVOKABLE bool activate(const QString &locale);
+    Q_INVOKABLE bool isLoaded(const QString &locale) const;
+    bool isLoaded(const QString &locale, const QString &source) const;
+    Q_INVOKABLE QStringList loadedLocales() const;
+    QString currentLocale() const;
+
+    void setEngine(QQmlEngine *engine);
+
+    // "app_zh_CN.qm" -> "zh_CN", "my_app_de.qm" -> "de"; empty if the name has no locale suffix
+    static QString localeFromFileName(const QString &fileName);
+
+signals:
+    void localeChanged(const QString &locale);
+
+private:
+    struct Catalog {
+        QString source;
+        QTranslator *translator = nullptr;
+        QByteArray data;
+    };
+
+    QHash<QString, QList<Catalog>> m_catalogs;
+    QString m_currentLocale;
+    QPointer<QQmlEngine> m_engine;
+
+    bool addCatalog(const QString &locale, Catalog catalog);
+    void retranslate();
+};
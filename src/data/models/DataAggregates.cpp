@@ -0,0 +1,254 @@
+#include "DataAggregates.h"
+#include "DataModel.h"
+
+DataAggregates::DataAggregates(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+{
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &DataAggregates::onRowsInserted);
+    connect(m_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DataAggregates::onRowsAboutToBeRemoved);
+    connect(m_model, &QAbstractItemModel::dataChanged, this, &DataAggregates::onDataChanged);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &DataAggregates::rebuild);
+
+    rebuild();
+}
+
+DataAggregates::~DataAggregates()
+{
+}
+
+int DataAggregates::count() const
+{
+    return m_disabled.count + m_enabled.count;
+}
+
+qint64 DataAggregates::sum() const
+{
+    return m_disabled.sum + m_enabled.sum;
+}
+
+int DataAggregates::minimum() const
+{
+    if (m_disabled.values.empty()) {
+        return enabledMinimum();
+    }
+    if (m_enabled.values.empty()) {
+        return m_disabled.values.begin()->first;
+    }
+    return qMin(m_disabled.values.begin()->first, m_enabled.values.begin()->first);
+}
+
+int DataAggregates::maximum() const
+{
+    if (m_disabled.values.empty()) {
+        return enabledMaximum();
+    }
+    if (m_enabled.values.empty()) {
+        return m_disabled.values.rbegin()->first;
+    }
+    return qMax(m_disabled.values.rbegin()->first, m_enabled.values.rbegin()->first);
+}
+
+double DataAggregates::average() const
+{
+    return count() > 0 ? double(sum()) / count() : 0.0;
+}
+
+QVariantList DataAggregates::histogram() const
+{
+    QList<int> buckets = m_enabled.buckets;
+    for (int i = 0; i < buckets.size(); ++i) {
+        buckets[i] += m_disabled.buckets[i];
+    }
+    return toVariantList(buckets);
+}
+
+int DataAggregates::enabledCount() const
+{
+    return m_enabled.count;
+}
+
+qint64 DataAggregates::enabledSum() const
+{
+    return m_enabled.sum;
+}
+
+int DataAggregates::enabledMinimum() const
+{
+    return m_enabled.values.empty() ? 0 : m_enabled.values.begin()->first;
+}
+
+int DataAggregates::enabledMaximum() const
+{
+    return m_enabled.values.empty() ? 0 : m_enabled.values.rbegin()->first;
+}
+
+double DataAggregates::enabledAverage() const
+{
+    return m_enabled.count > 0 ? double(m_enabled.sum) / m_enabled.count : 0.0;
+}
+
+QVariantList DataAggregates::enabledHistogram() const
+{
+    return toVariantList(m_enabled.buckets);
+}
+
+void DataAggregates::setHistogramLayout(int minimum, int width, int count)
+{
+    if (width <= 0 || count <= 0) {
+        qWarning(appModels) << "Ignoring histogram layout with width" << width << "and" << count << "buckets";
+        return;
+    }
+    m_bucketMinimum = minimum;
+    m_bucketWidth = width;
+    m_bucketCount = count;
+
+    // Re-bucket from the multisets: one pass over the distinct values, not the rows.
+    for (Group *group : {&m_disabled, &m_enabled}) {
+        resetBuckets(*group);
+        for (const auto &entry : group->values) {
+            group->buckets[bucketOf(entry.first)] += entry.second;
+        }
+    }
+    emit changed();
+}
+
+int DataAggregates::bucketMinimum() const
+{
+    return m_bucketMinimum;
+}
+
+int DataAggregates::bucketWidth() const
+{
+    return m_bucketWidth;
+}
+
+int DataAggregates::bucketCount() const
+{
+    return m_bucketCount;
+}
+
+void DataAggregates::rebuild()
+{
+    m_disabled = Group();
+    m_enabled = Group();
+    resetBuckets(m_disabled);
+    resetBuckets(m_enabled);
+
+    const int rows = m_model->rowCount();
+    m_rows.clear();
+    m_rows.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_rows.append(stateOf(row));
+        add(m_rows.last());
+    }
+    emit changed();
+}
+
+void DataAggregates::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    QList<RowState> inserted;
+    inserted.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        inserted.append(stateOf(row));
+        add(inserted.last());
+    }
+
+    if (first == m_rows.size()) {
+        m_rows.append(inserted);
+    } else {
+        m_rows.insert(first, inserted.size(), RowState());
+        std::copy(inserted.cbegin(), inserted.cend(), m_rows.begin() + first);
+    }
+    emit changed();
+}
+
+void DataAggregates::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    for (int row = first; row <= last; ++row) {
+        remove(m_rows[row]);
+    }
+    m_rows.remove(first, last - first + 1);
+    emit changed();
+}
+
+void DataAggregates::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (!roles.isEmpty() && !roles.contains(DataModel::ValueRole) && !roles.contains(DataModel::EnabledRole)) {
+        return;
+    }
+
+    bool anyChanged = false;
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const RowState current = stateOf(row);
+        RowState &previous = m_rows[row];
+        if (current.value == previous.value && current.enabled == previous.enabled) {
+            continue;
+        }
+        remove(previous);
+        add(current);
+        previous = current;
+        anyChanged = true;
+    }
+    if (anyChanged) {
+        emit changed();
+    }
+}
+
+DataAggregates::Group &DataAggregates::groupFor(bool enabled)
+{
+    return enabled ? m_enabled : m_disabled;
+}
+
+void DataAggregates::add(const RowState &row)
+{
+    Group &group = groupFor(row.enabled);
+    ++group.count;
+    group.sum += row.value;
+    ++group.values[row.value];
+    ++group.buckets[bucketOf(row.value)];
+}
+
+void DataAggregates::remove(const RowState &row)
+{
+    Group &group = groupFor(row.enabled);
+    --group.count;
+    group.sum -= row.value;
+    auto it = group.values.find(row.value);
+    if (it != group.values.end() && --it->second == 0) {
+        group.values.erase(it);
+    }
+    --group.buckets[bucketOf(row.value)];
+}
+
+int DataAggregates::bucketOf(int value) const
+{
+    const qint64 bucket = (qint64(value) - m_bucketMinimum) / m_bucketWidth;
+    if (value < m_bucketMinimum || bucket < 0) {
+        return 0;
+    }
+    return int(qMin<qint64>(bucket, m_bucketCount - 1));
+}
+
+void DataAggregates::resetBuckets(Group &group) const
+{
+    group.buckets = QList<int>(m_bucketCount, 0);
+}
+
+DataAggregates::RowState DataAggregates::stateOf(int row) const
+{
+    const DataColumns &columns = m_model->columns();
+    return {columns.value(row), columns.enabled(row)};
+}
+
+QVariantList DataAggregates::toVariantList(const QList<int> &buckets)
+{
+    QVariantList list;
+    list.reserve(buckets.size());
+    for (int bucket : buckets) {
+        list.append(bucket);
+    }
+    return list;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QVariantList>
+#include <map>
+
+class DataModel;
+
+// Statistics of a DataModel's values, all items and enabled items apart,
+// kept current from the model's signals instead of rescanning it. Each
+// inserted, removed or changed row costs O(log d) for d distinct values:
+// counts and sums are adjusted, min/max come from an ordered multiset
+// (value -> occurrences) and histograms from fixed-width buckets.
+class DataAggregates : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY changed)
+    Q_PROPERTY(qint64 sum READ sum NOTIFY changed)
+    Q_PROPERTY(int minimum READ minimum NOTIFY changed)
+    Q_PROPERTY(int maximum READ maximum NOTIFY changed)
+    Q_PROPERTY(double average READ average NOTIFY changed)
+    Q_PROPERTY(QVariantList histogram READ histogram NOTIFY changed)
+    Q_PROPERTY(int enabledCount READ enabledCount NOTIFY changed)
+    Q_PROPERTY(qint64 enabledSum READ enabledSum NOTIFY changed)
+    Q_PROPERTY(int enabledMinimum READ enabledMinimum NOTIFY changed)
+    Q_PROPERTY(int enabledMaximum READ enabledMaximum NOTIFY changed)
+    Q_PROPERTY(double enabledAverage READ enabledAverage NOTIFY changed)
+    Q_PROPERTY(QVariantList enabledHistogram READ enabledHistogram NOTIFY changed)
+    Q_PROPERTY(int bucketMinimum READ bucketMinimum NOTIFY changed)
+    Q_PROPERTY(int bucketWidth READ bucketWidth NOTIFY changed)
+    Q_PROPERTY(int bucketCount READ bucketCount NOTIFY changed)
+
+public:
+    explicit DataAggregates(DataModel *model, QObject *parent = nullptr);
+    ~DataAggregates();
+
+    int count() const;
+    qint64 sum() const;
+    int minimum() const;
+    int maximum() const;
+    double average() const;
+    QVariantList histogram() const;
+
+    int enabledCount() const;
+    qint64 enabledSum() const;
+    int enabledMinimum() const;
+    int enabledMaximum() const;
+    double enabledAverage() const;
+    QVariantList enabledHistogram() const;
+
+    // Buckets [minimum + i * width, minimum + (i + 1) * width); values outside
+    // the range land in the first or last bucket
+    Q_INVOKABLE void setHistogramLayout(int minimum, int width, int count);
+    int bucketMinimum() const;
+    int bucketWidth() const;
+    int bucketCount() const;
+
+    void rebuild();
+
+signals:
+    void changed();
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+private:
+    struct RowState {
+        int value;
+        bool enabled;
+    };
+
+    struct Group {
+        int count = 0;
+        qint64 sum = 0;
+        std::map<int, int> values;
+        QList<int> buckets;
+    };
+
+    DataModel *m_model;
+    // Row-parallel copy of the aggregated fields, so a change knows what it replaced.
+    // A plain list like DataModel's items: shifting 8-byte entries is O(n), but
+    // never more than the model's own insert or remove.
+    QList<RowState> m_rows;
+    Group m_disabled;
+    Group m_enabled;
+    int m_bucketMinimum = 0;
+    int m_bucketWidth = 100;
+    int m_bucketCount = 10;
+
+    Group &groupFor(bool enabled);
+    void add(const RowState &row);
+    void remove(const RowState &row);
+    int bucketOf(int value) const;
+    void resetBuckets(Group &group) const;
+    RowState stateOf(int row) const;
+
+    static QVariantList toVariantList(const QList<int> &buckets);
+};
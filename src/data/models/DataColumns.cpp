@@ -0,0 +1,292 @@
+#include "DataColumns.h"
+#include "DataItem.h"
+#include <QtAlgorithms>
+
+namespace {
+constexpr qsizetype kMinGarbageToCompact = 4096;
+// Above this many scattered inserts one rebuild beats shifting every column per item.
+constexpr int kMaxShiftedInserts = 32;
+
+bool testBit(const QList<quint64> &bits, int index)
+{
+    return (bits[index >> 6] >> (index & 63)) & 1u;
+}
+
+void assignBit(QList<quint64> &bits, int index, bool on)
+{
+    const quint64 mask = quint64(1) << (index & 63);
+    if (on) {
+        bits[index >> 6] |= mask;
+    } else {
+        bits[index >> 6] &= ~mask;
+    }
+}
+
+int wordsFor(int bitCount)
+{
+    return (bitCount + 63) / 64;
+}
+}
+
+void StringColumn::reserve(int rows)
+{
+    m_starts.reserve(rows);
+    m_lengths.reserve(rows);
+}
+
+void StringColumn::append(QStringView text)
+{
+    m_starts.append(quint32(m_arena.size()));
+    m_lengths.append(quint32(text.size()));
+    m_arena.append(text);
+}
+
+void StringColumn::insert(int row, QStringView text)
+{
+    // The text goes to the end of the arena; only the row tables shift.
+    m_starts.insert(row, quint32(m_arena.size()));
+    m_lengths.insert(row, quint32(text.size()));
+    m_arena.append(text);
+}
+
+void StringColumn::remove(int first, int count)
+{
+    for (int row = first; row < first + count; ++row) {
+        m_garbage += m_lengths[row];
+    }
+    m_starts.remove(first, count);
+    m_lengths.remove(first, count);
+    compactIfWasteful();
+}
+
+void StringColumn::removeSorted(const QList<int> &rows)
+{
+    int next = 0;
+    int write = 0;
+    for (int read = 0; read < m_starts.size(); ++read) {
+        if (next < rows.size() && rows[next] == read) {
+            m_garbage += m_lengths[read];
+            ++next;
+            continue;
+        }
+        m_starts[write] = m_starts[read];
+        m_lengths[write] = m_lengths[read];
+        ++write;
+    }
+    m_starts.resize(write);
+    m_lengths.resize(write);
+    compactIfWasteful();
+}
+
+void StringColumn::clear()
+{
+    m_arena.clear();
+    m_starts.clear();
+    m_lengths.clear();
+    m_garbage = 0;
+}
+
+QStringView StringColumn::view(int row) const
+{
+    return QStringView(m_arena).mid(m_starts[row], m_lengths[row]);
+}
+
+qsizetype StringColumn::memoryUsage() const
+{
+    return m_arena.capacity() * qsizetype(sizeof(QChar))
+        + (m_starts.capacity() + m_lengths.capacity()) * qsizetype(sizeof(quint32));
+}
+
+void StringColumn::compactIfWasteful()
+{
+    if (m_garbage < kMinGarbageToCompact || m_garbage * 2 < m_arena.size()) {
+        return;
+    }
+
+    QString arena;
+    arena.reserve(m_arena.size() - m_garbage);
+    for (int row = 0; row < m_starts.size(); ++row) {
+        const quint32 start = quint32(arena.size());
+        arena.append(QStringView(m_arena).mid(m_starts[row], m_lengths[row]));
+        m_starts[row] = start;
+    }
+    m_arena = std::move(arena);
+    m_garbage = 0;
+}
+
+void DataColumns::reserve(int rows)
+{
+    m_ids.reserve(rows);
+    m_names.reserve(rows);
+    m_descriptions.reserve(rows);
+    m_values.reserve(rows);
+    m_enabledBits.reserve(wordsFor(rows));
+}
+
+void DataColumns::append(const DataItem &item)
+{
+    append(item.id, item.name, item.description, item.value, item.enabled);
+}
+
+void DataColumns::append(QStringView id, QStringView name, QStringView description, int value, bool enabled)
+{
+    const int row = m_values.size();
+    m_ids.append(id);
+    m_names.append(name);
+    m_descriptions.append(description);
+    m_values.append(value);
+    if (wordsFor(row + 1) > m_enabledBits.size()) {
+        m_enabledBits.append(0);
+    }
+    assignBit(m_enabledBits, row, enabled);
+}
+
+void DataColumns::insert(int row, const DataItem &item)
+{
+    const int oldSize = m_values.size();
+    if (row == oldSize) {
+        append(item);
+        return;
+    }
+
+    m_ids.insert(row, item.id);
+    m_names.insert(row, item.name);
+    m_descriptions.insert(row, item.description);
+    m_values.insert(row, item.value);
+
+    if (wordsFor(oldSize + 1) > m_enabledBits.size()) {
+        m_enabledBits.append(0);
+    }
+    // Shift the flags at and after row up by one bit, a word at a time.
+    const int firstWord = row >> 6;
+    for (int word = m_enabledBits.size() - 1; word > firstWord; --word) {
+        m_enabledBits[word] = (m_enabledBits[word] << 1) | (m_enabledBits[word - 1] >> 63);
+    }
+    const quint64 lowMask = (quint64(1) << (row & 63)) - 1;
+    quint64 &word = m_enabledBits[firstWord];
+    word = (word & lowMask) | ((word & ~lowMask) << 1);
+    assignBit(m_enabledBits, row, item.enabled);
+}
+
+void DataColumns::insertSorted(const QList<int> &rows, const QList<DataItem> &items)
+{
+    Q_ASSERT(rows.size() == items.size());
+    const int oldSize = m_values.size();
+    if (rows.size() <= kMaxShiftedInserts || rows.first() >= oldSize) {
+        for (int i = 0; i < rows.size(); ++i) {
+            insert(rows[i], items[i]);
+        }
+        return;
+    }
+
+    DataColumns merged;
+    merged.reserve(oldSize + rows.size());
+    int next = 0;
+    int read = 0;
+    for (int row = 0; row < oldSize + rows.size(); ++row) {
+        if (next < rows.size() && rows[next] == row) {
+            merged.append(items[next++]);
+        } else {
+            merged.append(idView(read), nameView(read), descriptionView(read), value(read), enabled(read));
+            ++read;
+        }
+    }
+    *this = std::move(merged);
+}
+
+void DataColumns::remove(int first, int count)
+{
+    const int oldSize = m_values.size();
+    m_ids.remove(first, count);
+    m_names.remove(first, count);
+    m_descriptions.remove(first, count);
+    m_values.remove(first, count);
+
+    for (int row = first; row + count < oldSize; ++row) {
+        assignBit(m_enabledBits, row, testBit(m_enabledBits, row + count));
+    }
+    const int newSize = oldSize - count;
+    m_enabledBits.resize(wordsFor(newSize));
+    if (newSize & 63) {
+        // Keep bits past the end zero so enabledCount() can count whole words.
+        m_enabledBits.last() &= (quint64(1) << (newSize & 63)) - 1;
+    }
+}
+
+void DataColumns::removeSorted(const QList<int> &rows)
+{
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    m_ids.removeSorted(rows);
+    m_names.removeSorted(rows);
+    m_descriptions.removeSorted(rows);
+
+    const int oldSize = m_values.size();
+    int next = 0;
+    int write = 0;
+    for (int read = 0; read < oldSize; ++read) {
+        if (next < rows.size() && rows[next] == read) {
+            ++next;
+            continue;
+        }
+        m_values[write] = m_values[read];
+        assignBit(m_enabledBits, write, testBit(m_enabledBits, read));
+        ++write;
+    }
+    m_values.resize(write);
+    m_enabledBits.resize(wordsFor(write));
+    if (write & 63) {
+        m_enabledBits.last() &= (quint64(1) << (write & 63)) - 1;
+    }
+}
+
+void DataColumns::clear()
+{
+    m_ids.clear();
+    m_names.clear();
+    m_descriptions.clear();
+    m_values.clear();
+    m_enabledBits.clear();
+}
+
+DataItem DataColumns::item(int row) const
+{
+    return {id(row), name(row), description(row), value(row), enabled(row)};
+}
+
+bool DataColumns::enabled(int row) const
+{
+    return testBit(m_enabledBits, row);
+}
+
+void DataColumns::setEnabled(int row, bool enabled)
+{
+    assignBit(m_enabledBits, row, enabled);
+}
+
+qint64 DataColumns::sumValues() const
+{
+    qint64 sum = 0;
+    for (int value : m_values) {
+        sum += value;
+    }
+    return sum;
+}
+
+int DataColumns::enabledCount() const
+{
+    int count = 0;
+    for (quint64 word : m_enabledBits) {
+        count += qPopulationCount(word);
+    }
+    return count;
+}
+
+qsizetype DataColumns::memoryUsage() const
+{
+    return m_ids.memoryUsage() + m_names.memoryUsage() + m_descriptions.memoryUsage()
+        + m_values.capacity() * qsizetype(sizeof(int))
+        + m_enabledBits.capacity() * qsizetype(sizeof(quint64));
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QList>
+
+struct DataItem;
+
+// Column store of UTF-16 strings: one shared arena plus per-row start and
+// length. Removed rows leave garbage in the arena until it is compacted.
+class StringColumn
+{
+public:
+    int size() const { return m_starts.size(); }
+    void reserve(int rows);
+    void append(QStringView text);
+    void insert(int row, QStringView text);
+    void remove(int first, int count);
+    void removeSorted(const QList<int> &rows);
+    void clear();
+
+    QStringView view(int row) const;
+    QString at(int row) const { return view(row).toString(); }
+    qsizetype memoryUsage() const;
+
+private:
+    QString m_arena;
+    QList<quint32> m_starts;
+    QList<quint32> m_lengths;
+    qsizetype m_garbage = 0;
+
+    void compactIfWasteful();
+};
+
+// Struct-of-arrays backing store for DataModel. Values sit in one contiguous
+// int column and enabled flags are bit-packed, so scans over either touch
+// only the bytes they need.
+class DataColumns
+{
+public:
+    int size() const { return m_values.size(); }
+    void reserve(int rows);
+    void append(const DataItem &item);
+    void append(QStringView id, QStringView name, QStringView description, int value, bool enabled);
+    void insert(int row, const DataItem &item);
+    // rows are the items' final positions, sorted ascending and unique
+    void insertSorted(const QList<int> &rows, const QList<DataItem> &items);
+    void remove(int first, int count);
+    // rows must be sorted ascending and unique
+    void removeSorted(const QList<int> &rows);
+    void clear();
+
+    DataItem item(int row) const;
+    QString id(int row) const { return m_ids.at(row); }
+    QStringView idView(int row) const { return m_ids.view(row); }
+    QString name(int row) const { return m_names.at(row); }
+    QStringView nameView(int row) const { return m_names.view(row); }
+    QString description(int row) const { return m_descriptions.at(row); }
+    QStringView descriptionView(int row) const { return m_descriptions.view(row); }
+
+    int value(int row) const { return m_values.at(row); }
+    void setValue(int row, int value) { m_values[row] = value; }
+    bool enabled(int row) const;
+    void setEnabled(int row, bool enabled);
+
+    const QList<int> &values() const { return m_values; }
+    qint64 sumValues() const;
+    int enabledCount() const;
+    qsizetype memoryUsage() const;
+
+private:
+    StringColumn m_ids;
+    StringColumn m_names;
+    StringColumn m_descriptions;
+    QList<int> m_values;
+    QList<quint64> m_enabledBits;
+};
@@ -0,0 +1,210 @@
+#include "DataHistory.h"
+#include "DataItem.h"
+
+namespace {
+constexpr qint64 kDefaultMemoryLimit = 32 * 1024 * 1024;
+constexpr int kDefaultMergeIntervalMs = 1000;
+
+bool isMergeableEdit(const DataHistory::Command &command)
+{
+    return command.mergeable
+        && command.kind == DataHistory::Command::Change
+        && command.changes.size() == 1;
+}
+}
+
+DataHistory::DataHistory()
+    : m_memoryLimit(kDefaultMemoryLimit)
+    , m_mergeInterval(kDefaultMergeIntervalMs)
+{
+}
+
+void DataHistory::record(Command command)
+{
+    if (m_groupDepth > 0) {
+        m_group.commands.append(std::move(command));
+        return;
+    }
+    if (tryMerge(command)) {
+        return;
+    }
+
+    const bool mergeable = isMergeableEdit(command);
+    Entry entry;
+    entry.commands.append(std::move(command));
+    commit(std::move(entry));
+    // An entry over the memory limit is dropped at once; never merge into an older one.
+    m_canMerge = mergeable && !m_undo.isEmpty();
+}
+
+void DataHistory::beginGroup()
+{
+    if (m_groupDepth++ == 0) {
+        m_group = Entry();
+    }
+}
+
+void DataHistory::endGroup()
+{
+    if (m_groupDepth == 0 || --m_groupDepth > 0) {
+        return;
+    }
+
+    Entry group = std::move(m_group);
+    m_group = Entry();
+    if (!group.commands.isEmpty()) {
+        commit(std::move(group));
+    }
+}
+
+bool DataHistory::canUndo() const
+{
+    return !m_undo.isEmpty();
+}
+
+bool DataHistory::canRedo() const
+{
+    return !m_redo.isEmpty();
+}
+
+int DataHistory::undoCount() const
+{
+    return m_undo.size();
+}
+
+int DataHistory::redoCount() const
+{
+    return m_redo.size();
+}
+
+DataHistory::Entry DataHistory::takeUndo()
+{
+    m_canMerge = false;
+    Entry entry = m_undo.takeLast();
+    m_bytes -= entry.bytes;
+    return entry;
+}
+
+DataHistory::Entry DataHistory::takeRedo()
+{
+    m_canMerge = false;
+    Entry entry = m_redo.takeLast();
+    m_bytes -= entry.bytes;
+    return entry;
+}
+
+void DataHistory::pushRedo(Entry entry)
+{
+    m_bytes += entry.bytes;
+    m_redo.append(std::move(entry));
+    enforceLimit();
+}
+
+void DataHistory::pushUndo(Entry entry)
+{
+    m_bytes += entry.bytes;
+    m_undo.append(std::move(entry));
+    enforceLimit();
+}
+
+void DataHistory::clear()
+{
+    m_undo.clear();
+    m_redo.clear();
+    m_group = Entry();
+    m_bytes = 0;
+    m_canMerge = false;
+}
+
+void DataHistory::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = qMax<qint64>(0, bytes);
+    enforceLimit();
+}
+
+qint64 DataHistory::memoryLimit() const
+{
+    return m_memoryLimit;
+}
+
+qint64 DataHistory::memoryUsage() const
+{
+    return m_bytes;
+}
+
+void DataHistory::setMergeInterval(int msecs)
+{
+    m_mergeInterval = msecs;
+}
+
+int DataHistory::mergeInterval() const
+{
+    return m_mergeInterval;
+}
+
+qint64 DataHistory::estimateBytes(const Command &command)
+{
+    qint64 bytes = qint64(sizeof(Command));
+    for (const DataItem &item : command.items) {
+        bytes += estimateItemBytes(item.id.size() + item.name.size() + item.description.size());
+    }
+    bytes += command.rows.size() * qint64(sizeof(int));
+    for (const FieldChange &change : command.changes) {
+        bytes += qint64(sizeof(FieldChange)) + change.id.size() * qint64(sizeof(QChar));
+    }
+    return bytes;
+}
+
+qint64 DataHistory::estimateItemBytes(qsizetype characters)
+{
+    return qint64(sizeof(DataItem)) + characters * qint64(sizeof(QChar));
+}
+
+void DataHistory::commit(Entry entry)
+{
+    for (const Entry &undone : std::as_const(m_redo)) {
+        m_bytes -= undone.bytes;
+    }
+    m_redo.clear();
+
+    entry.bytes = qint64(sizeof(Entry));
+    for (const Command &command : std::as_const(entry.commands)) {
+        entry.bytes += estimateBytes(command);
+    }
+    m_bytes += entry.bytes;
+    m_undo.append(std::move(entry));
+    m_canMerge = false;
+    m_lastRecord.start();
+    enforceLimit();
+}
+
+bool DataHistory::tryMerge(const Command &command)
+{
+    if (!m_canMerge || m_undo.isEmpty() || !isMergeableEdit(command)) {
+        return false;
+    }
+    if (m_mergeInterval >= 0 && m_lastRecord.elapsed() > m_mergeInterval) {
+        return false;
+    }
+
+    FieldChange &previous = m_undo.last().commands.first().changes.first();
+    const FieldChange &next = command.changes.first();
+    if (previous.id != next.id || previous.role != next.role) {
+        return false;
+    }
+    // Later edits of the same item keep the first "before" and take the newest "after".
+    previous.after = next.after;
+    m_lastRecord.start();
+    return true;
+}
+
+void DataHistory::enforceLimit()
+{
+    // Drop the oldest undo steps first, then the redo steps furthest away.
+    while (m_bytes > m_memoryLimit && !m_undo.isEmpty()) {
+        m_bytes -= m_undo.takeFirst().bytes;
+    }
+    while (m_bytes > m_memoryLimit && !m_redo.isEmpty()) {
+        m_bytes -= m_redo.takeFirst().bytes;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QElapsedTimer>
+#include "DataItem.h"
+
+// Undo/redo stacks of DataModel edits. Each entry stores only what its
+// inverse needs (the rows an insert added, the rows a removal took, the
+// before/after of changed fields), never a copy of the model. Consecutive
+// value edits of one item merge into a single entry, and the oldest entries
+// are dropped once the stored edits exceed the memory limit.
+class DataHistory
+{
+public:
+    struct FieldChange {
+        QString id;
+        int role;
+        int before;
+        int after;
+    };
+
+    struct Command {
+        enum Kind {
+            Insert,   // items appended at the end, or inserted at rows when set
+            Remove,   // items taken from rows (ascending, pre-removal positions)
+            Change    // field edits
+        };
+
+        Kind kind = Change;
+        QList<DataItem> items;
+        QList<int> rows;
+        QList<FieldChange> changes;
+        // A single field edit that later edits of the same field may merge into
+        bool mergeable = false;
+    };
+
+    // One undo step: a single command, or every command of one model batch
+    struct Entry {
+        QList<Command> commands;
+        qint64 bytes = 0;
+    };
+
+    DataHistory();
+
+    void record(Command command);
+    // Commands recorded between the outermost begin/end become one step
+    void beginGroup();
+    void endGroup();
+
+    bool canUndo() const;
+    bool canRedo() const;
+    int undoCount() const;
+    int redoCount() const;
+    Entry takeUndo();
+    Entry takeRedo();
+    // Put back a step once its inverse (or itself) has been applied
+    void pushRedo(Entry entry);
+    void pushUndo(Entry entry);
+    void clear();
+
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const;
+    qint64 memoryUsage() const;
+    // Value edits of the same item this close together merge; negative merges always
+    void setMergeInterval(int msecs);
+    int mergeInterval() const;
+
+    static qint64 estimateBytes(const Command &command);
+    // Estimate for one stored item holding this many characters of text
+    static qint64 estimateItemBytes(qsizetype characters);
+
+private:
+    QList<Entry> m_undo;
+    QList<Entry> m_redo;
+    Entry m_group;
+    int m_groupDepth = 0;
+    qint64 m_bytes = 0;
+    qint64 m_memoryLimit;
+    int m_mergeInterval;
+    QElapsedTimer m_lastRecord;
+    bool m_canMerge = false;
+
+    void commit(Entry entry);
+    bool tryMerge(const Command &command);
+    void enforceLimit();
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QString>
+
+struct DataItem {
+    QString id;
+    QString name;
+    QString description;
+    int value;
+    bool enabled;
+
+    bool operator==(const DataItem &other) const {
+        return id == other.id;
+    }
+};
@@ -0,0 +1,570 @@
+#include "DataJournal.h"
+#include "DataSnapshot.h"
+#include <QThread>
+#include <QTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+namespace {
+constexpr char kMagic[4] = {'Q', 'D', 'M', 'J'};
+constexpr quint16 kVersion = 1;
+constexpr qint64 kHeaderSize = 8;
+constexpr qint64 kRecordHeaderSize = 8;
+constexpr qint64 kDefaultCompactThreshold = 16 * 1024 * 1024;
+// Compaction waits for open batches to end; hidden rows must not reach a snapshot.
+constexpr int kCompactRetryMs = 100;
+
+template <typename T>
+void appendLE(QByteArray &buffer, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    buffer.append(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+void appendString(QByteArray &buffer, QStringView text)
+{
+    appendLE<quint32>(buffer, quint32(text.size()));
+    const qsizetype offset = buffer.size();
+    buffer.resize(offset + text.size() * 2);
+    qToLittleEndian<quint16>(text.utf16(), text.size(), buffer.data() + offset);
+}
+
+QByteArray fileHeader()
+{
+    QByteArray header(kMagic, sizeof(kMagic));
+    appendLE<quint16>(header, kVersion);
+    appendLE<quint16>(header, 0);
+    return header;
+}
+
+bool syncToDisk(QFile &file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+#if defined(Q_OS_UNIX)
+    return ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+// Bounds-checked reader over one record body.
+class RecordReader
+{
+public:
+    RecordReader(const char *data, qsizetype size)
+        : m_data(reinterpret_cast<const uchar *>(data))
+        , m_size(size)
+    {
+    }
+
+    bool ok() const { return m_ok; }
+
+    template <typename T>
+    T read()
+    {
+        if (!m_ok || m_size - m_pos < qsizetype(sizeof(T))) {
+            m_ok = false;
+            return T();
+        }
+        const T value = qFromLittleEndian<T>(m_data + m_pos);
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    QString readString()
+    {
+        const quint32 length = read<quint32>();
+        if (!m_ok || quint64(m_size - m_pos) < quint64(length) * 2) {
+            m_ok = false;
+            return QString();
+        }
+        QString text(qsizetype(length), Qt::Uninitialized);
+        qFromLittleEndian<quint16>(m_data + m_pos, qsizetype(length), text.data());
+        m_pos += qsizetype(length) * 2;
+        return text;
+    }
+
+private:
+    const uchar *m_data;
+    qsizetype m_size;
+    qsizetype m_pos = 0;
+    bool m_ok = true;
+};
+}
+
+DataJournal::DataJournal(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_compactThreshold(kDefaultCompactThreshold)
+    , m_journalSize(0)
+{
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &DataJournal::onRowsInserted);
+    connect(m_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DataJournal::onRowsAboutToBeRemoved);
+    connect(m_model, &QAbstractItemModel::dataChanged, this, &DataJournal::onDataChanged);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &DataJournal::onModelReset);
+}
+
+DataJournal::~DataJournal()
+{
+    close();
+}
+
+bool DataJournal::open(const QString &basePath)
+{
+    close();
+    m_basePath = basePath;
+    m_replayedCount = 0;
+
+    m_replaying = true;
+    if (QFileInfo::exists(snapshotPath())) {
+        if (!m_model->loadSnapshot(snapshotPath())) {
+            m_replaying = false;
+            return fail(QStringLiteral("Cannot load snapshot ") + snapshotPath());
+        }
+    } else {
+        m_model->clear();
+    }
+
+    m_file.setFileName(journalPath());
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        m_replaying = false;
+        return fail(QStringLiteral("Cannot open journal: ") + m_file.errorString());
+    }
+    const bool replayed = replay();
+    m_replaying = false;
+    // Restored state is the starting point, not something to undo.
+    m_model->clearHistory();
+    if (!replayed) {
+        return false;
+    }
+
+    m_journalSize.storeRelaxed(m_file.size());
+    m_stopRequested = false;
+    m_thread = QThread::create([this]() {
+        writerLoop();
+    });
+    m_thread->setObjectName("DataJournal");
+    m_thread->start();
+
+    qDebug(appModels) << "Journal opened:" << m_model->getCount() << "items," << m_replayedCount << "changes replayed";
+    if (m_journalSize.loadRelaxed() > m_compactThreshold) {
+        scheduleCompaction();
+    }
+    m_errorString.clear();
+    return true;
+}
+
+void DataJournal::close()
+{
+    if (m_thread) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopRequested = true;
+            m_pendingReady.wakeAll();
+        }
+        // The writer drains everything still pending before it exits.
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    m_file.close();
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.clear();
+    m_recordedSeq = 0;
+    m_syncedSeq = 0;
+    m_journalSize.storeRelaxed(0);
+    m_compactedSeq = 0;
+}
+
+bool DataJournal::isOpen() const
+{
+    return m_thread != nullptr;
+}
+
+QString DataJournal::errorString() const
+{
+    return m_errorString;
+}
+
+void DataJournal::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 target = m_recordedSeq;
+    while (m_thread && m_syncedSeq < target) {
+        m_synced.wait(&m_mutex);
+    }
+}
+
+bool DataJournal::compact()
+{
+    if (!isOpen()) {
+        return false;
+    }
+    if (m_model->isBatching()) {
+        qWarning(appModels) << "Journal compaction skipped: the model is inside a batch";
+        return false;
+    }
+
+    if (!m_model->saveSnapshot(snapshotPath())) {
+        m_errorString = QStringLiteral("Cannot write snapshot ") + snapshotPath();
+        emit writeFailed(m_errorString);
+        return false;
+    }
+
+    // Everything recorded so far is in the snapshot. A group the writer has
+    // already taken but not written must not reach the fresh journal: replayed
+    // over the newer snapshot it would undo later changes.
+    bool ok = true;
+    {
+        QMutexLocker fileLocker(&m_fileMutex);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pending.clear();
+            m_compactedSeq = m_recordedSeq;
+            m_syncedSeq = m_recordedSeq;
+            m_synced.wakeAll();
+        }
+        ok = m_file.resize(0) && m_file.seek(0)
+            && m_file.write(fileHeader()) == kHeaderSize
+            && syncToDisk(m_file);
+    }
+    m_journalSize.storeRelaxed(kHeaderSize);
+
+    if (!ok) {
+        m_errorString = QStringLiteral("Cannot truncate journal: ") + m_file.errorString();
+        emit writeFailed(m_errorString);
+        return false;
+    }
+
+    qDebug(appModels) << "Journal compacted into" << snapshotPath();
+    emit compacted();
+    return true;
+}
+
+void DataJournal::setCompactThreshold(qint64 bytes)
+{
+    m_compactThreshold = qMax(kHeaderSize, bytes);
+}
+
+qint64 DataJournal::compactThreshold() const
+{
+    return m_compactThreshold;
+}
+
+qint64 DataJournal::journalSize() const
+{
+    return m_journalSize.loadRelaxed();
+}
+
+int DataJournal::replayedCount() const
+{
+    return m_replayedCount;
+}
+
+void DataJournal::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    if (!isOpen() || m_replaying) {
+        return;
+    }
+
+    // Appends replay as appends; anything else (undoing a removal) needs its row.
+    const bool appended = last == m_model->rowCount() - 1;
+    const DataColumns &columns = m_model->columns();
+    for (int row = first; row <= last; ++row) {
+        QByteArray body;
+        if (appended) {
+            body.append(char(AddOp));
+        } else {
+            body.append(char(InsertOp));
+            appendLE<qint32>(body, row);
+        }
+        appendString(body, columns.idView(row));
+        appendString(body, columns.nameView(row));
+        appendString(body, columns.descriptionView(row));
+        appendLE<qint32>(body, columns.value(row));
+        appendLE<quint8>(body, columns.enabled(row));
+        record(body);
+    }
+}
+
+void DataJournal::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    if (!isOpen() || m_replaying) {
+        return;
+    }
+
+    const DataColumns &columns = m_model->columns();
+    for (int row = first; row <= last; ++row) {
+        QByteArray body;
+        body.append(char(RemoveOp));
+        appendString(body, columns.idView(row));
+        record(body);
+    }
+}
+
+void DataJournal::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (!isOpen() || m_replaying) {
+        return;
+    }
+
+    const bool valueChanged = roles.isEmpty() || roles.contains(DataModel::ValueRole);
+    const bool enabledChanged = roles.isEmpty() || roles.contains(DataModel::EnabledRole);
+    const DataColumns &columns = m_model->columns();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        if (valueChanged) {
+            QByteArray body;
+            body.append(char(SetValueOp));
+            appendString(body, columns.idView(row));
+            appendLE<qint32>(body, columns.value(row));
+            record(body);
+        }
+        if (enabledChanged) {
+            QByteArray body;
+            body.append(char(SetEnabledOp));
+            appendString(body, columns.idView(row));
+            appendLE<quint8>(body, columns.enabled(row));
+            record(body);
+        }
+    }
+}
+
+void DataJournal::onModelReset()
+{
+    if (!isOpen() || m_replaying) {
+        return;
+    }
+
+    // Only clear() and loadSnapshot() reset, and both replace every row: log
+    // the visible ones whole. Rows still hidden in a batch are logged when
+    // they are published.
+    record(QByteArray(1, char(ClearOp)));
+    if (m_model->rowCount() > 0) {
+        onRowsInserted(QModelIndex(), 0, m_model->rowCount() - 1);
+    }
+}
+
+QString DataJournal::snapshotPath() const
+{
+    return m_basePath + QStringLiteral(".dms");
+}
+
+QString DataJournal::journalPath() const
+{
+    return m_basePath + QStringLiteral(".journal");
+}
+
+bool DataJournal::replay()
+{
+    const QByteArray data = m_file.readAll();
+    if (data.isEmpty()) {
+        if (m_file.write(fileHeader()) != kHeaderSize || !syncToDisk(m_file)) {
+            return fail(QStringLiteral("Cannot write journal: ") + m_file.errorString());
+        }
+        return true;
+    }
+    if (data.size() < kHeaderSize || std::memcmp(data.constData(), kMagic, sizeof(kMagic)) != 0) {
+        return fail(QStringLiteral("Not a data journal"));
+    }
+    if (qFromLittleEndian<quint16>(data.constData() + 4) != kVersion) {
+        return fail(QStringLiteral("Unsupported journal version"));
+    }
+
+    // Consecutive adds, and inserts at consecutive rows, go to the model together.
+    QList<DataItem> adds;
+    int addsRow = -1;
+    auto flushAdds = [this, &adds, &addsRow]() {
+        if (addsRow < 0) {
+            m_model->appendItems(adds);
+        } else {
+            m_model->insertItems(addsRow, adds);
+        }
+        adds.clear();
+        addsRow = -1;
+    };
+
+    m_model->beginBatch();
+    qsizetype pos = kHeaderSize;
+    while (data.size() - pos >= kRecordHeaderSize) {
+        const quint32 size = qFromLittleEndian<quint32>(data.constData() + pos);
+        const quint32 crc = qFromLittleEndian<quint32>(data.constData() + pos + 4);
+        const char *body = data.constData() + pos + kRecordHeaderSize;
+        if (quint64(data.size() - pos - kRecordHeaderSize) < size
+            || DataSnapshot::crc32(body, qsizetype(size)) != crc) {
+            break;
+        }
+
+        RecordReader reader(body, qsizetype(size));
+        const quint8 op = reader.read<quint8>();
+        if (op == ClearOp) {
+            adds.clear();
+            addsRow = -1;
+            m_model->clear();
+        } else if (op == AddOp || op == InsertOp) {
+            const int row = op == InsertOp ? qMax(reader.read<qint32>(), 0) : -1;
+            DataItem item;
+            item.id = reader.readString();
+            item.name = reader.readString();
+            item.description = reader.readString();
+            item.value = reader.read<qint32>();
+            item.enabled = reader.read<quint8>() != 0;
+            if (!reader.ok()) {
+                break;
+            }
+            if (m_model->contains(item.id)) {
+                m_model->updateItemValue(item.id, item.value);
+                m_model->setItemEnabled(item.id, item.enabled);
+            } else {
+                const bool continues = row < 0 ? addsRow < 0 : row == addsRow + adds.size();
+                if (!adds.isEmpty() && !continues) {
+                    flushAdds();
+                }
+                if (adds.isEmpty()) {
+                    addsRow = row;
+                }
+                adds.append(std::move(item));
+            }
+        } else {
+            const QString id = reader.readString();
+            if (op == RemoveOp) {
+                flushAdds();
+                m_model->removeItem(id);
+            } else if (op == SetValueOp) {
+                const qint32 value = reader.read<qint32>();
+                flushAdds();
+                m_model->updateItemValue(id, value);
+            } else if (op == SetEnabledOp) {
+                const bool enabled = reader.read<quint8>() != 0;
+                flushAdds();
+                m_model->setItemEnabled(id, enabled);
+            } else {
+                break;
+            }
+            if (!reader.ok()) {
+                break;
+            }
+        }
+
+        pos += kRecordHeaderSize + qsizetype(size);
+        ++m_replayedCount;
+    }
+    flushAdds();
+    m_model->endBatch();
+
+    if (pos < data.size()) {
+        // A crash mid-append leaves a torn record; later appends must not follow it.
+        qWarning(appModels) << "Discarding" << data.size() - pos << "bytes of damaged journal tail in" << journalPath();
+        if (!m_file.resize(pos)) {
+            return fail(QStringLiteral("Cannot repair journal: ") + m_file.errorString());
+        }
+    }
+    m_file.seek(m_file.size());
+    return true;
+}
+
+void DataJournal::record(const QByteArray &body)
+{
+    QByteArray frame;
+    frame.reserve(kRecordHeaderSize + body.size());
+    appendLE<quint32>(frame, quint32(body.size()));
+    appendLE<quint32>(frame, DataSnapshot::crc32(body.constData(), body.size()));
+    frame.append(body);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.append(frame);
+        ++m_recordedSeq;
+        m_pendingReady.wakeOne();
+    }
+
+    if (m_journalSize.fetchAndAddRelaxed(frame.size()) + frame.size() > m_compactThreshold) {
+        scheduleCompaction();
+    }
+}
+
+void DataJournal::scheduleCompaction()
+{
+    if (m_compactPending) {
+        return;
+    }
+    m_compactPending = true;
+    QTimer::singleShot(m_model->isBatching() ? kCompactRetryMs : 0, this, [this]() {
+        m_compactPending = false;
+        if (!isOpen() || m_journalSize.loadRelaxed() <= m_compactThreshold) {
+            return;
+        }
+        if (m_model->isBatching()) {
+            scheduleCompaction();
+            return;
+        }
+        compact();
+    });
+}
+
+void DataJournal::writerLoop()
+{
+    for (;;) {
+        QByteArray group;
+        quint64 groupSeq = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_pending.isEmpty() && !m_stopRequested) {
+                m_pendingReady.wait(&m_mutex);
+            }
+            if (m_pending.isEmpty()) {
+                break;
+            }
+            // Everything recorded while the previous group was syncing goes out together.
+            group.swap(m_pending);
+            groupSeq = m_recordedSeq;
+        }
+
+        if (m_beforeWrite) {
+            m_beforeWrite();
+        }
+
+        QString error;
+        {
+            QMutexLocker fileLocker(&m_fileMutex);
+            if (groupSeq <= m_compactedSeq) {
+                // Compacted into the snapshot while this group was in flight
+                continue;
+            }
+            if (m_file.write(group) != group.size() || !syncToDisk(m_file)) {
+                error = m_file.errorString();
+            }
+        }
+        if (!error.isEmpty()) {
+            qWarning(appModels) << "Journal write failed:" << error;
+            emit writeFailed(error);
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_syncedSeq = qMax(m_syncedSeq, groupSeq);
+        m_synced.wakeAll();
+    }
+}
+
+bool DataJournal::fail(const QString &error)
+{
+    m_errorString = error;
+    qWarning(appModels) << "Journal" << m_basePath << "failed:" << error;
+    m_file.close();
+    return false;
+}
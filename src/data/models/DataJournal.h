@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <functional>
+#include "DataModel.h"
+
+class QThread;
+
+// Crash-safe persistence for a DataModel: <basePath>.dms holds a snapshot
+// and <basePath>.journal the changes made since. The journal follows the
+// model's signals and records one compact entry per inserted, removed or
+// changed row; rows inserted before the end keep their position. Only a
+// reset (clear() or loading a snapshot) is logged as a clear and a full dump. A writer thread appends and syncs whatever has accumulated
+// since its last sync (group commit), so the GUI thread never waits on disk.
+//
+// Journal layout, all integers little-endian:
+//   header   magic "QDMJ", u16 version, u16 flags
+//   records  u32 bodySize, u32 bodyCrc, body
+//   body     u8 op, then per op:
+//            Add         id, name, description, i32 value, u8 enabled
+//            Insert      i32 row, then as Add
+//            Remove      id
+//            SetValue    id, i32 value
+//            SetEnabled  id, u8 enabled
+//            Clear       -
+//            with each string as u32 length + UTF-16 units
+//
+// Replay is idempotent (adding a present id updates it, missing ids are
+// ignored), so a crash between writing a snapshot and truncating the
+// journal is harmless. A torn record at the end is cut off on open.
+// Groups the writer took before a compaction are already in the snapshot
+// and are dropped rather than written to the fresh journal.
+class DataJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataJournal(DataModel *model, QObject *parent = nullptr);
+    ~DataJournal();
+
+    // Loads the snapshot, replays the journal into the model and starts recording
+    bool open(const QString &basePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    // Blocks until every change recorded so far is on disk
+    void flush();
+    // Writes a snapshot of the model and empties the journal
+    bool compact();
+
+    // Journal size past which the next change triggers compaction
+    void setCompactThreshold(qint64 bytes);
+    qint64 compactThreshold() const;
+    qint64 journalSize() const;
+    int replayedCount() const;
+
+signals:
+    void compacted();
+    void writeFailed(const QString &error);
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onModelReset();
+
+private:
+    enum Op : quint8 {
+        AddOp = 1,
+        RemoveOp,
+        SetValueOp,
+        SetEnabledOp,
+        ClearOp,
+        InsertOp
+    };
+
+    DataModel *m_model;
+    QString m_basePath;
+    QString m_errorString;
+    bool m_replaying = false;
+    bool m_compactPending = false;
+    qint64 m_compactThreshold;
+    int m_replayedCount = 0;
+
+    // Shared with the writer thread
+    QThread *m_thread = nullptr;
+    QFile m_file;
+    QMutex m_fileMutex;
+    QMutex m_mutex;
+    QWaitCondition m_pendingReady;
+    QWaitCondition m_synced;
+    QByteArray m_pending;
+    quint64 m_recordedSeq = 0;
+    quint64 m_syncedSeq = 0;
+    bool m_stopRequested = false;
+    QAtomicInteger<qint64> m_journalSize;
+    // Last sequence number contained in the snapshot; guarded by m_fileMutex
+    quint64 m_compactedSeq = 0;
+    // Runs on the writer thread between taking a group and writing it (tests)
+    std::function<void()> m_beforeWrite;
+
+    QString snapshotPath() const;
+    QString journalPath() const;
+    bool replay();
+    void record(const QByteArray &body);
+    void scheduleCompaction();
+    void writerLoop();
+    bool fail(const QString &error);
+
+    friend class TestDataJournal;
+};
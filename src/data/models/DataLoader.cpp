@@ -0,0 +1,281 @@
+#include "DataLoader.h"
+#include "DataModel.h"
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+namespace {
+constexpr int kDefaultFrameBudgetMs = 2;
+constexpr int kPublishIntervalMs = 4;
+constexpr int kBlockSize = 1024;
+// Bounds staging memory; the worker waits once this many blocks are queued.
+constexpr int kMaxStagedBlocks = 64;
+constexpr int kProgressScale = 1000000;
+}
+
+DataLoader::DataLoader(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_thread(nullptr)
+    , m_publishTimer(new QTimer(this))
+    , m_frameBudget(kDefaultFrameBudgetMs)
+{
+    m_publishTimer->setInterval(kPublishIntervalMs);
+    connect(m_publishTimer, &QTimer::timeout, this, &DataLoader::publishChunk);
+}
+
+DataLoader::~DataLoader()
+{
+    stopWorker();
+}
+
+void DataLoader::start(Producer producer)
+{
+    if (isRunning()) {
+        cancel();
+    }
+
+    m_blocks.clear();
+    m_producerDone = false;
+    m_error.clear();
+    m_cancelRequested.storeRelaxed(0);
+    m_producedCount.storeRelaxed(0);
+    m_producerProgress.storeRelaxed(0);
+    m_loadedCount = 0;
+
+    m_thread = QThread::create([this, producer = std::move(producer)]() {
+        QList<DataItem> block;
+        block.reserve(kBlockSize);
+
+        auto pushBlock = [this, &block]() {
+            QMutexLocker locker(&m_mutex);
+            while (m_blocks.size() >= kMaxStagedBlocks && !m_cancelRequested.loadRelaxed()) {
+                m_drained.wait(&m_mutex);
+            }
+            m_blocks.append(std::move(block));
+            block = QList<DataItem>();
+            block.reserve(kBlockSize);
+        };
+
+        auto emitItem = [this, &block, &pushBlock](DataItem &&item) {
+            if (m_cancelRequested.loadRelaxed()) {
+                return false;
+            }
+            block.append(std::move(item));
+            m_producedCount.fetchAndAddRelaxed(1);
+            if (block.size() >= kBlockSize) {
+                pushBlock();
+            }
+            return !m_cancelRequested.loadRelaxed();
+        };
+
+        auto reportProgress = [this](qreal fraction) {
+            m_producerProgress.storeRelaxed(int(qBound(0.0, fraction, 1.0) * kProgressScale));
+        };
+
+        const QString error = producer(emitItem, reportProgress);
+        if (!block.isEmpty() && !m_cancelRequested.loadRelaxed()) {
+            pushBlock();
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_producerDone = true;
+        m_error = error;
+    });
+    m_thread->setObjectName("DataLoader");
+    m_thread->start(QThread::LowPriority);
+
+    m_publishTimer->start();
+    emit runningChanged();
+    emit progressChanged();
+}
+
+void DataLoader::loadFile(const QString &filePath)
+{
+    start([filePath](const EmitItem &emitItem, const ReportProgress &reportProgress) -> QString {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QStringLiteral("Cannot open %1: %2").arg(filePath, file.errorString());
+        }
+
+        const qint64 size = qMax<qint64>(1, file.size());
+        qint64 lineNumber = 0;
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            ++lineNumber;
+            if (line.isEmpty()) {
+                continue;
+            }
+
+            QJsonParseError parseError;
+            const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+            if (!document.isObject()) {
+                return QStringLiteral("%1:%2: %3").arg(filePath).arg(lineNumber).arg(parseError.errorString());
+            }
+
+            const QJsonObject object = document.object();
+            if (!emitItem({object.value("id").toString(),
+                           object.value("name").toString(),
+                           object.value("description").toString(),
+                           object.value("value").toInt(),
+                           object.value("enabled").toBool(true)})) {
+                return QString();
+            }
+
+            if ((lineNumber & 0x3ff) == 0) {
+                reportProgress(qreal(file.pos()) / size);
+            }
+        }
+
+        reportProgress(1.0);
+        return QString();
+    });
+}
+
+void DataLoader::loadGenerated(int count)
+{
+    start([count](const EmitItem &emitItem, const ReportProgress &reportProgress) -> QString {
+        for (int i = 0; i < count; ++i) {
+            if (!emitItem({QString(),
+                           QStringLiteral("Item %1").arg(i + 1),
+                           QStringLiteral("Generated item"),
+                           i % 1000,
+                           true})) {
+                break;
+            }
+            if ((i & 0x3ff) == 0) {
+                reportProgress(qreal(i) / count);
+            }
+        }
+        reportProgress(1.0);
+        return QString();
+    });
+}
+
+void DataLoader::cancel()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    stopWorker();
+    qDebug(appModels) << "Data load cancelled after" << m_loadedCount << "items";
+    emit runningChanged();
+    emit cancelled();
+}
+
+bool DataLoader::isRunning() const
+{
+    return m_thread != nullptr;
+}
+
+qreal DataLoader::progress() const
+{
+    const int produced = m_producedCount.loadRelaxed();
+    if (produced == 0) {
+        return 0.0;
+    }
+    // Producer progress, scaled by how much of what it produced has reached the model.
+    const qreal producerFraction = qreal(m_producerProgress.loadRelaxed()) / kProgressScale;
+    return producerFraction * m_loadedCount / produced;
+}
+
+int DataLoader::loadedCount() const
+{
+    return m_loadedCount;
+}
+
+void DataLoader::setFrameBudget(int msecs)
+{
+    m_frameBudget = qMax(1, msecs);
+}
+
+int DataLoader::frameBudget() const
+{
+    return m_frameBudget;
+}
+
+void DataLoader::publishChunk()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 budgetNs = qint64(m_frameBudget) * 1000000;
+
+    const int loadedBefore = m_loadedCount;
+    bool done = false;
+
+    // One batch per tick, so views see a single insert however many blocks fit in the budget.
+    // Loaded rows are not undoable: recording them would copy every row into the history.
+    m_model->suspendHistory();
+    m_model->beginBatch();
+    while (timer.nsecsElapsed() < budgetNs) {
+        QList<DataItem> block;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_blocks.isEmpty()) {
+                done = m_producerDone;
+                break;
+            }
+            block = m_blocks.takeFirst();
+            m_drained.wakeAll();
+        }
+        m_loadedCount += m_model->appendItems(block);
+    }
+    m_model->endBatch();
+    m_model->resumeHistory();
+
+    if (m_loadedCount != loadedBefore) {
+        emit progressChanged();
+    }
+    if (done) {
+        finish();
+    }
+}
+
+void DataLoader::stopWorker()
+{
+    m_publishTimer->stop();
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cancelRequested.storeRelaxed(1);
+        m_drained.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    QMutexLocker locker(&m_mutex);
+    m_blocks.clear();
+}
+
+void DataLoader::finish()
+{
+    QString error;
+    {
+        QMutexLocker locker(&m_mutex);
+        error = m_error;
+    }
+
+    stopWorker();
+    emit runningChanged();
+    emit progressChanged();
+
+    if (!error.isEmpty()) {
+        qWarning(appModels) << "Data load failed:" << error;
+        emit failed(error);
+        return;
+    }
+
+    qDebug(appModels) << "Data load finished:" << m_loadedCount << "items";
+    emit finished(m_loadedCount);
+}
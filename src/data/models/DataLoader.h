@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <functional>
+#include "DataModel.h"
+
+class QThread;
+class QTimer;
+
+// Streams items into a DataModel without blocking the GUI thread. A worker
+// thread produces items into a bounded staging buffer; the GUI thread moves
+// them into the model in time-sliced chunks, one insert per tick.
+class DataLoader : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(int loadedCount READ loadedCount NOTIFY progressChanged)
+
+public:
+    // Called on the worker thread. Hand each item to emitItem, which returns
+    // false once the load is cancelled; report progress in [0, 1]. Return an
+    // error message, or an empty string on success.
+    using EmitItem = std::function<bool(DataItem &&item)>;
+    using ReportProgress = std::function<void(qreal fraction)>;
+    using Producer = std::function<QString(const EmitItem &emitItem, const ReportProgress &reportProgress)>;
+
+    explicit DataLoader(DataModel *model, QObject *parent = nullptr);
+    ~DataLoader();
+
+    void start(Producer producer);
+    // JSON Lines: one {"id", "name", "description", "value", "enabled"} object per line
+    void loadFile(const QString &filePath);
+    void loadGenerated(int count);
+    void cancel();
+
+    bool isRunning() const;
+    qreal progress() const;
+    int loadedCount() const;
+
+    void setFrameBudget(int msecs);
+    int frameBudget() const;
+
+signals:
+    void runningChanged();
+    void progressChanged();
+    void finished(int count);
+    void failed(const QString &error);
+    void cancelled();
+
+private slots:
+    void publishChunk();
+
+private:
+    DataModel *m_model;
+    QThread *m_thread;
+    QTimer *m_publishTimer;
+    int m_frameBudget;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_drained;
+    QList<QList<DataItem>> m_blocks;
+    bool m_producerDone = false;
+    QString m_error;
+
+    QAtomicInt m_cancelRequested;
+    QAtomicInt m_producedCount;
+    QAtomicInt m_producerProgress;
+    int m_loadedCount = 0;
+
+    void stopWorker();
+    void finish();
+};
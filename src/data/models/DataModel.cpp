@@ -1,5 +1,8 @@
 #include "DataModel.h"
+#include "DataSnapshot.h"
+#include "DataAggregates.h"
 #include <QUuid>
+#include <algorithm>
 
 Q_LOGGING_CATEGORY(appModels, "app.models")
 
@@ -17,28 +20,29 @@ DataModel::~DataModel()
 int DataModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
-    return m_items.size();
+    // Rows appended inside a batch stay hidden from views until endBatch().
+    return m_publishedRows;
 }
 
 QVariant DataModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_items.size()) {
+    if (!index.isValid() || index.row() >= m_publishedRows) {
         return QVariant();
     }
 
-    const DataItem &item = m_items[index.row()];
+    const int row = index.row();
 
     switch (role) {
     case IdRole:
-        return item.id;
+        return m_columns.id(row);
     case NameRole:
-        return item.name;
+        return m_columns.name(row);
     case DescriptionRole:
-        return item.description;
+        return m_columns.description(row);
     case ValueRole:
-        return item.value;
+        return m_columns.value(row);
     case EnabledRole:
-        return item.enabled;
+        return m_columns.enabled(row);
     default:
         return QVariant();
     }
@@ -59,80 +63,707 @@ void DataModel::addItem(const QString &name, const QString &description, int val
 {
     QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
 
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items.append({id, name, description, value, true});
-    endInsertRows();
+    const int row = m_columns.size();
+    if (!isBatching()) {
+        beginInsertRows(QModelIndex(), row, row);
+    }
+    appendItem({id, name, description, value, true});
+    if (!isBatching()) {
+        m_publishedRows = m_columns.size();
+        endInsertRows();
+        qDebug(appModels) << "Added item:" << id << name;
+    }
+    recordInsert(row);
+}
+
+QStringList DataModel::addItems(const QVariantList &items)
+{
+    QList<DataItem> parsed;
+    parsed.reserve(items.size());
+    for (const QVariant &entry : items) {
+        const QVariantMap map = entry.toMap();
+        parsed.append({map.value("id").toString(),
+                       map.value("name").toString(),
+                       map.value("description").toString(),
+                       map.value("value").toInt(),
+                       map.value("enabled", true).toBool()});
+    }
+
+    const int first = m_columns.size();
+    const int added = appendItems(parsed);
 
-    qDebug(appModels) << "Added item:" << id << name;
+    QStringList ids;
+    ids.reserve(added);
+    for (int row = first; row < first + added; ++row) {
+        ids.append(m_columns.id(row));
+    }
+    qDebug(appModels) << "Added" << ids.size() << "items";
+    return ids;
+}
+
+int DataModel::appendItems(const QList<DataItem> &items)
+{
+    if (items.isEmpty()) {
+        return 0;
+    }
+
+    const int first = m_columns.size();
+    if (!isBatching()) {
+        beginInsertRows(QModelIndex(), first, first + items.size() - 1);
+    }
+
+    m_columns.reserve(first + items.size());
+    m_baseById.reserve(first + items.size());
+    for (const DataItem &item : items) {
+        if (item.id.isEmpty() || contains(item.id)) {
+            DataItem copy = item;
+            copy.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            appendItem(copy);
+        } else {
+            appendItem(item);
+        }
+    }
+
+    if (!isBatching()) {
+        m_publishedRows = m_columns.size();
+        endInsertRows();
+    }
+    recordInsert(first);
+    return items.size();
+}
+
+int DataModel::insertItems(int row, const QList<DataItem> &items)
+{
+    if (row >= m_columns.size()) {
+        return appendItems(items);
+    }
+    if (items.isEmpty()) {
+        return 0;
+    }
+
+    QList<int> rows;
+    QList<DataItem> inserted;
+    rows.reserve(items.size());
+    inserted.reserve(items.size());
+    QSet<QString> ids;
+    for (const DataItem &item : items) {
+        rows.append(qMax(row, 0) + int(rows.size()));
+        inserted.append(item);
+        if (item.id.isEmpty() || contains(item.id) || ids.contains(item.id)) {
+            inserted.last().id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        }
+        ids.insert(inserted.last().id);
+    }
+
+    if (isRecordingHistory()) {
+        DataHistory::Command command;
+        command.kind = DataHistory::Command::Insert;
+        command.rows = rows;
+        command.items = inserted;
+        recordHistory(std::move(command));
+    }
+    insertRowList(rows, inserted);
+    return items.size();
 }
 
 void DataModel::removeItem(const QString &id)
 {
     int index = findItemIndex(id);
     if (index >= 0) {
-        beginRemoveRows(QModelIndex(), index, index);
-        m_items.removeAt(index);
-        endRemoveRows();
+        removeRowList({index});
         qDebug(appModels) << "Removed item:" << id;
     }
 }
 
+int DataModel::removeItems(const QStringList &ids)
+{
+    QList<int> rows;
+    rows.reserve(ids.size());
+    for (const QString &id : ids) {
+        const int row = findItemIndex(id);
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    if (rows.isEmpty()) {
+        return 0;
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    removeRowList(rows);
+
+    qDebug(appModels) << "Removed" << rows.size() << "items";
+    return rows.size();
+}
+
 void DataModel::updateItemValue(const QString &id, int value)
 {
     int index = findItemIndex(id);
     if (index >= 0) {
-        m_items[index].value = value;
-        emit dataChanged(createIndex(index, 0), createIndex(index, 0), {ValueRole});
+        recordChanges({{id, ValueRole, m_columns.value(index), value}});
+        m_columns.setValue(index, value);
+        notifyRowsChanged({index}, {ValueRole});
         qDebug(appModels) << "Updated item value:" << id << value;
     }
 }
 
+int DataModel::updateValues(const QVariantMap &values)
+{
+    QList<int> rows;
+    QList<DataHistory::FieldChange> changes;
+    rows.reserve(values.size());
+    changes.reserve(values.size());
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        const int row = findItemIndex(it.key());
+        if (row >= 0) {
+            changes.append({it.key(), ValueRole, m_columns.value(row), it.value().toInt()});
+            m_columns.setValue(row, it.value().toInt());
+            rows.append(row);
+        }
+    }
+
+    recordChanges(std::move(changes));
+    notifyRowsChanged(rows, {ValueRole});
+    qDebug(appModels) << "Updated" << rows.size() << "item values";
+    return rows.size();
+}
+
 void DataModel::setItemEnabled(const QString &id, bool enabled)
 {
     int index = findItemIndex(id);
     if (index >= 0) {
-        m_items[index].enabled = enabled;
-        emit dataChanged(createIndex(index, 0), createIndex(index, 0), {EnabledRole});
+        recordChanges({{id, EnabledRole, int(m_columns.enabled(index)), int(enabled)}});
+        m_columns.setEnabled(index, enabled);
+        notifyRowsChanged({index}, {EnabledRole});
         qDebug(appModels) << "Set item enabled:" << id << enabled;
     }
 }
 
 void DataModel::clear()
 {
+    if (isRecordingHistory() && m_columns.size() > 0 && !fitsHistory(m_columns.size())) {
+        // Copying every row only for the history to evict it (and every older
+        // step) at once would waste the copy; the clear is not undoable.
+        qDebug(appModels) << "Clearing" << m_columns.size() << "items is too large to undo";
+        clearHistory();
+    } else if (isRecordingHistory() && m_columns.size() > 0) {
+        DataHistory::Command command;
+        command.kind = DataHistory::Command::Remove;
+        command.rows.reserve(m_columns.size());
+        command.items.reserve(m_columns.size());
+        for (int row = 0; row < m_columns.size(); ++row) {
+            command.rows.append(row);
+            command.items.append(m_columns.item(row));
+        }
+        recordHistory(std::move(command));
+    }
+
     beginResetModel();
-    m_items.clear();
+    m_columns.clear();
+    m_baseById.clear();
+    m_removedTree.clear();
+    m_removedCount = 0;
+    m_indexStale = false;
+    m_publishedRows = 0;
+    m_batchChangedIds.clear();
+    m_batchChangedRoles.clear();
     endResetModel();
     qDebug(appModels) << "Cleared all items";
 }
 
+bool DataModel::saveSnapshot(const QString &filePath) const
+{
+    QString error;
+    if (!DataSnapshot::save(m_columns, filePath, &error)) {
+        qWarning(appModels) << "Failed to save snapshot:" << error;
+        return false;
+    }
+    return true;
+}
+
+bool DataModel::loadSnapshot(const QString &filePath)
+{
+    DataSnapshot snapshot;
+    if (!snapshot.open(filePath)) {
+        return false;
+    }
+
+    const int rows = snapshot.rowCount();
+    beginResetModel();
+    m_columns.clear();
+    m_columns.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_columns.append(snapshot.id(row), snapshot.name(row), snapshot.description(row),
+                         snapshot.value(row), snapshot.enabled(row));
+    }
+    // The id index is rebuilt by the first lookup rather than up front.
+    m_baseById.clear();
+    m_removedTree.clear();
+    m_removedCount = 0;
+    m_indexStale = true;
+    m_publishedRows = m_columns.size();
+    m_batchChangedIds.clear();
+    m_batchChangedRoles.clear();
+    endResetModel();
+    clearHistory();
+
+    qDebug(appModels) << "Loaded" << rows << "items from snapshot" << filePath;
+    return true;
+}
+
+void DataModel::beginBatch()
+{
+    ++m_batchDepth;
+    m_history.beginGroup();
+}
+
+void DataModel::endBatch()
+{
+    if (m_batchDepth == 0) {
+        qWarning(appModels) << "endBatch() called without a matching beginBatch()";
+        return;
+    }
+    const bool couldUndo = m_history.canUndo();
+    m_history.endGroup();
+    if (couldUndo != m_history.canUndo()) {
+        emit historyChanged();
+    }
+    if (--m_batchDepth > 0) {
+        return;
+    }
+
+    // Changes to rows that were already visible, resolved after any removals.
+    QList<int> changedRows;
+    changedRows.reserve(m_batchChangedIds.size());
+    for (const QString &id : std::as_const(m_batchChangedIds)) {
+        const int row = findItemIndex(id);
+        if (row >= 0 && row < m_publishedRows) {
+            changedRows.append(row);
+        }
+    }
+    const QList<int> roles(m_batchChangedRoles.cbegin(), m_batchChangedRoles.cend());
+    m_batchChangedIds.clear();
+    m_batchChangedRoles.clear();
+    notifyRowsChanged(changedRows, roles);
+
+    const int added = m_columns.size() - m_publishedRows;
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), m_publishedRows, m_columns.size() - 1);
+        m_publishedRows = m_columns.size();
+        endInsertRows();
+    }
+
+    qDebug(appModels) << "Batch committed:" << added << "added," << changedRows.size() << "changed";
+}
+
+bool DataModel::isBatching() const
+{
+    return m_batchDepth > 0;
+}
+
+bool DataModel::undo()
+{
+    if (isBatching() || !m_history.canUndo()) {
+        return false;
+    }
+
+    DataHistory::Entry entry = m_history.takeUndo();
+    m_applyingHistory = true;
+    for (auto it = entry.commands.crbegin(); it != entry.commands.crend(); ++it) {
+        applyCommand(*it, true);
+    }
+    m_applyingHistory = false;
+    m_history.pushRedo(std::move(entry));
+    emit historyChanged();
+    return true;
+}
+
+bool DataModel::redo()
+{
+    if (isBatching() || !m_history.canRedo()) {
+        return false;
+    }
+
+    DataHistory::Entry entry = m_history.takeRedo();
+    m_applyingHistory = true;
+    for (const DataHistory::Command &command : std::as_const(entry.commands)) {
+        applyCommand(command, false);
+    }
+    m_applyingHistory = false;
+    m_history.pushUndo(std::move(entry));
+    emit historyChanged();
+    return true;
+}
+
+void DataModel::clearHistory()
+{
+    const bool hadHistory = canUndo() || canRedo();
+    m_history.clear();
+    if (hadHistory) {
+        emit historyChanged();
+    }
+}
+
+bool DataModel::canUndo() const
+{
+    return m_history.canUndo();
+}
+
+bool DataModel::canRedo() const
+{
+    return m_history.canRedo();
+}
+
+void DataModel::suspendHistory()
+{
+    ++m_historySuspended;
+}
+
+void DataModel::resumeHistory()
+{
+    if (m_historySuspended == 0) {
+        qWarning(appModels) << "resumeHistory() called without a matching suspendHistory()";
+        return;
+    }
+    --m_historySuspended;
+}
+
+bool DataModel::isRecordingHistory() const
+{
+    return !m_applyingHistory && m_historySuspended == 0;
+}
+
+DataAggregates *DataModel::aggregates()
+{
+    if (!m_aggregates) {
+        m_aggregates = new DataAggregates(this, this);
+    }
+    return m_aggregates;
+}
+
 QJsonObject DataModel::getItem(const QString &id) const
 {
     int index = findItemIndex(id);
     if (index >= 0) {
-        const DataItem &item = m_items[index];
-        QJsonObject obj;
-        obj["id"] = item.id;
-        obj["name"] = item.name;
-        obj["description"] = item.description;
-        obj["value"] = item.value;
-        obj["enabled"] = item.enabled;
-        return obj;
+        return toJson(m_columns.item(index));
     }
     return QJsonObject();
 }
 
+QJsonObject DataModel::getItem(int row) const
+{
+    if (row < 0 || row >= m_columns.size()) {
+        return QJsonObject();
+    }
+    return toJson(m_columns.item(row));
+}
+
 int DataModel::getCount() const
 {
-    return m_items.size();
+    return m_columns.size();
+}
+
+bool DataModel::contains(const QString &id) const
+{
+    return findItemIndex(id) >= 0;
+}
+
+int DataModel::rowOf(const QString &id) const
+{
+    return findItemIndex(id);
 }
 
 int DataModel::findItemIndex(const QString &id) const
 {
-    for (int i = 0; i < m_items.size(); ++i) {
-        if (m_items[i].id == id) {
-            return i;
+    if (m_indexStale) {
+        rebuildIndex();
+    }
+
+    auto it = m_baseById.constFind(id);
+    if (it == m_baseById.constEnd()) {
+        return -1;
+    }
+    return m_removedCount == 0 ? it.value() : it.value() - removedBefore(it.value());
+}
+
+void DataModel::appendItem(const DataItem &item)
+{
+    m_columns.append(item);
+    if (!m_indexStale) {
+        m_baseById.insert(item.id, m_removedTree.size());
+        appendBase();
+    }
+}
+
+void DataModel::removeRowList(const QList<int> &rows)
+{
+    if (isRecordingHistory()) {
+        DataHistory::Command command;
+        command.kind = DataHistory::Command::Remove;
+        command.rows = rows;
+        command.items.reserve(rows.size());
+        for (int row : rows) {
+            command.items.append(m_columns.item(row));
+        }
+        recordHistory(std::move(command));
+    }
+
+    if (!m_indexStale) {
+        // Rows after a removed one shift down; marking the removed base
+        // positions is enough for lookups to account for that.
+        for (int row : rows) {
+            const int base = m_baseById.take(m_columns.id(row));
+            markRemoved(base);
+        }
+        if (m_removedCount > kMinIndexRebuild && m_removedCount > m_removedTree.size() / 2) {
+            m_indexStale = true;
+        }
+    }
+
+    // Remove runs back to front so earlier row numbers stay valid. Views keep
+    // their state across the runs, which a reset would throw away.
+    int last = rows.size() - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && rows[first - 1] == rows[first] - 1) {
+            --first;
+        }
+        const int firstRow = rows[first];
+        const int lastRow = rows[last];
+
+        // Rows still hidden inside a batch go without signals.
+        const int hiddenFirst = qMax(firstRow, m_publishedRows);
+        if (hiddenFirst <= lastRow) {
+            m_columns.remove(hiddenFirst, lastRow - hiddenFirst + 1);
+        }
+        if (firstRow < m_publishedRows) {
+            const int visibleLast = qMin(lastRow, m_publishedRows - 1);
+            beginRemoveRows(QModelIndex(), firstRow, visibleLast);
+            m_columns.remove(firstRow, visibleLast - firstRow + 1);
+            m_publishedRows -= visibleLast - firstRow + 1;
+            endRemoveRows();
+        }
+        last = first - 1;
+    }
+}
+
+void DataModel::notifyRowsChanged(QList<int> rows, const QList<int> &roles)
+{
+    if (isBatching()) {
+        for (int row : std::as_const(rows)) {
+            if (row < m_publishedRows) {
+                m_batchChangedIds.insert(m_columns.id(row));
+            }
+        }
+        for (int role : roles) {
+            m_batchChangedRoles.insert(role);
+        }
+        return;
+    }
+
+    if (rows.isEmpty()) {
+        return;
+    }
+    std::sort(rows.begin(), rows.end());
+
+    // One dataChanged per contiguous run of rows.
+    int first = 0;
+    for (int i = 1; i <= rows.size(); ++i) {
+        if (i == rows.size() || rows[i] > rows[i - 1] + 1) {
+            emit dataChanged(createIndex(rows[first], 0), createIndex(rows[i - 1], 0), roles);
+            first = i;
+        }
+    }
+}
+
+void DataModel::rebuildIndex() const
+{
+    const int rows = m_columns.size();
+    m_baseById.clear();
+    m_baseById.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_baseById.insert(m_columns.id(row), row);
+    }
+    m_removedTree = QList<int>(rows, 0);
+    m_removedCount = 0;
+    m_indexStale = false;
+}
+
+int DataModel::removedBefore(int base) const
+{
+    int count = 0;
+    for (int i = base; i > 0; i &= i - 1) {
+        count += m_removedTree[i - 1];
+    }
+    return count;
+}
+
+void DataModel::markRemoved(int base)
+{
+    for (int i = base + 1; i <= m_removedTree.size(); i += i & -i) {
+        ++m_removedTree[i - 1];
+    }
+    ++m_removedCount;
+}
+
+void DataModel::appendBase()
+{
+    // Fenwick node i covers positions (i - lowbit(i), i]; the new position itself is live.
+    const int node = m_removedTree.size() + 1;
+    const int covered = m_removedCount == 0 ? 0 : removedBefore(node - 1) - removedBefore(node - (node & -node));
+    m_removedTree.append(covered);
+}
+
+void DataModel::insertRowList(const QList<int> &rows, const QList<DataItem> &items)
+{
+    // Inserts in the middle (undoing a removal) shift rows the tree cannot
+    // express; the next lookup rebuilds the index.
+    m_indexStale = true;
+
+    // Rows are final positions, so runs are inserted front to back: each one lands
+    // where the earlier runs have already made room for it.
+    int first = 0;
+    for (int i = 1; i <= rows.size(); ++i) {
+        if (i < rows.size() && rows[i] == rows[i - 1] + 1) {
+            continue;
+        }
+        const int count = i - first;
+        // Runs past the published rows stay hidden until the batch ends.
+        if (rows[first] > m_publishedRows) {
+            m_columns.insertSorted(rows.mid(first, count), items.mid(first, count));
+        } else {
+            beginInsertRows(QModelIndex(), rows[first], rows[i - 1]);
+            m_columns.insertSorted(rows.mid(first, count), items.mid(first, count));
+            m_publishedRows += count;
+            endInsertRows();
+        }
+        first = i;
+    }
+}
+
+QList<int> DataModel::rowsOf(const QList<DataItem> &items) const
+{
+    QList<int> rows;
+    rows.reserve(items.size());
+    for (const DataItem &item : items) {
+        const int row = findItemIndex(item.id);
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+void DataModel::recordInsert(int first)
+{
+    if (!isRecordingHistory() || first >= m_columns.size()) {
+        return;
+    }
+    DataHistory::Command command;
+    command.kind = DataHistory::Command::Insert;
+    command.items.reserve(m_columns.size() - first);
+    for (int row = first; row < m_columns.size(); ++row) {
+        command.items.append(m_columns.item(row));
+    }
+    recordHistory(std::move(command));
+}
+
+bool DataModel::fitsHistory(int rows) const
+{
+    qint64 bytes = qint64(sizeof(DataHistory::Entry)) + qint64(sizeof(DataHistory::Command));
+    for (int row = 0; row < rows; ++row) {
+        bytes += DataHistory::estimateItemBytes(m_columns.idView(row).size() + m_columns.nameView(row).size()
+                                                + m_columns.descriptionView(row).size())
+            + qint64(sizeof(int));
+        if (bytes > m_history.memoryLimit()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DataModel::recordChanges(QList<DataHistory::FieldChange> changes)
+{
+    if (!isRecordingHistory() || changes.isEmpty()) {
+        return;
+    }
+    DataHistory::Command command;
+    command.kind = DataHistory::Command::Change;
+    command.mergeable = changes.size() == 1 && changes.first().role == ValueRole;
+    command.changes = std::move(changes);
+    recordHistory(std::move(command));
+}
+
+void DataModel::recordHistory(DataHistory::Command command)
+{
+    const bool couldUndo = m_history.canUndo();
+    const bool couldRedo = m_history.canRedo();
+    m_history.record(std::move(command));
+    if (couldUndo != m_history.canUndo() || couldRedo != m_history.canRedo()) {
+        emit historyChanged();
+    }
+}
+
+void DataModel::applyCommand(const DataHistory::Command &command, bool inverse)
+{
+    switch (command.kind) {
+    case DataHistory::Command::Insert:
+        if (inverse) {
+            const QList<int> rows = rowsOf(command.items);
+            if (!rows.isEmpty()) {
+                removeRowList(rows);
+            }
+        } else if (!command.rows.isEmpty()) {
+            insertRowList(command.rows, command.items);
+        } else {
+            appendItems(command.items);
+        }
+        break;
+    case DataHistory::Command::Remove:
+        if (inverse) {
+            insertRowList(command.rows, command.items);
+        } else {
+            const QList<int> rows = rowsOf(command.items);
+            if (!rows.isEmpty()) {
+                removeRowList(rows);
+            }
+        }
+        break;
+    case DataHistory::Command::Change: {
+        QList<int> rows;
+        QList<int> roles;
+        for (const DataHistory::FieldChange &change : command.changes) {
+            const int row = findItemIndex(change.id);
+            if (row < 0) {
+                continue;
+            }
+            const int value = inverse ? change.before : change.after;
+            if (change.role == ValueRole) {
+                m_columns.setValue(row, value);
+            } else {
+                m_columns.setEnabled(row, value != 0);
+            }
+            if (!roles.contains(change.role)) {
+                roles.append(change.role);
+            }
+            rows.append(row);
         }
+        // One dataChanged per contiguous run, like the edits being undone.
+        notifyRowsChanged(std::move(rows), roles);
+        break;
+    }
     }
-    return -1;
 }
 
+QJsonObject DataModel::toJson(const DataItem &item)
+{
+    QJsonObject obj;
+    obj["id"] = item.id;
+    obj["name"] = item.name;
+    obj["description"] = item.description;
+    obj["value"] = item.value;
+    obj["enabled"] = item.enabled;
+    return obj;
+}
@@ -4,27 +4,28 @@
 #include <QtQml/qqmlregistration.h>
 #include <QAbstractListModel>
 #include <QList>
+#include <QHash>
+#include <QSet>
+#include <QVariantList>
+#include <QVariantMap>
 #include <QJsonObject>
 #include <QLoggingCategory>
+#include "DataItem.h"
+#include "DataColumns.h"
+#include "DataHistory.h"
 
-Q_DECLARE_LOGGING_CATEGORY(appModels)
-
-struct DataItem {
-    QString id;
-    QString name;
-    QString description;
-    int value;
-    bool enabled;
+class DataAggregates;
 
-    bool operator==(const DataItem &other) const {
-        return id == other.id;
-    }
-};
+Q_DECLARE_LOGGING_CATEGORY(appModels)
 
 class DataModel : public QAbstractListModel
 {
     Q_OBJECT
     QML_ELEMENT
+    Q_PROPERTY(bool canUndo READ canUndo NOTIFY historyChanged)
+    Q_PROPERTY(bool canRedo READ canRedo NOTIFY historyChanged)
+    Q_PROPERTY(DataAggregates *aggregates READ aggregates CONSTANT)
+    Q_MOC_INCLUDE("DataAggregates.h")
 
 public:
     enum DataRoles {
@@ -48,11 +49,90 @@ public:
     Q_INVOKABLE void setItemEnabled(const QString &id, bool enabled);
     Q_INVOKABLE void clear();
 
+    // Batch mutations; each emits one insert range or one signal per contiguous run
+    Q_INVOKABLE QStringList addItems(const QVariantList &items);
+    Q_INVOKABLE int removeItems(const QStringList &ids);
+    Q_INVOKABLE int updateValues(const QVariantMap &values);
+    // Items without an id, or whose id is taken, get a fresh one
+    int appendItems(const QList<DataItem> &items);
+    // The same, inserted before the item at row
+    int insertItems(int row, const QList<DataItem> &items);
+
+    // Defers inserts and change notifications until the outermost endBatch()
+    Q_INVOKABLE void beginBatch();
+    Q_INVOKABLE void endBatch();
+    bool isBatching() const;
+
+    // Binary snapshot of every row; loading replaces the contents in one reset
+    Q_INVOKABLE bool saveSnapshot(const QString &filePath) const;
+    Q_INVOKABLE bool loadSnapshot(const QString &filePath);
+
+    // Every mutation is recorded as its inverse; a batch undoes as one step
+    Q_INVOKABLE bool undo();
+    Q_INVOKABLE bool redo();
+    Q_INVOKABLE void clearHistory();
+    bool canUndo() const;
+    bool canRedo() const;
+    DataHistory &history() { return m_history; }
+    // Mutations between the outermost suspend/resume are not recorded (bulk
+    // loads); edits recorded before stay undoable
+    void suspendHistory();
+    void resumeHistory();
+    bool isRecordingHistory() const;
+
     Q_INVOKABLE QJsonObject getItem(const QString &id) const;
+    QJsonObject getItem(int row) const;
     Q_INVOKABLE int getCount() const;
+    Q_INVOKABLE bool contains(const QString &id) const;
+    Q_INVOKABLE int rowOf(const QString &id) const;
+
+    const DataColumns &columns() const { return m_columns; }
+    // Sum, count, min/max and histograms of ValueRole, created on first use
+    DataAggregates *aggregates();
+
+signals:
+    void historyChanged();
 
 private:
-    QList<DataItem> m_items;
+    DataColumns m_columns;
+    // id -> base position, the row an item had when the index was last built
+    // (or it was appended). Removals only mark their base position in a
+    // Fenwick tree, so an item's row is its base position minus the marked
+    // positions before it. Middle inserts and loads flag the index stale and
+    // the next lookup rebuilds it; so does a tree that is mostly removals.
+    mutable QHash<QString, int> m_baseById;
+    mutable QList<int> m_removedTree;
+    mutable int m_removedCount = 0;
+    mutable bool m_indexStale = false;
+
+    // Removals past half the index (and this many) trigger a rebuild on the next lookup
+    static constexpr int kMinIndexRebuild = 1024;
+    int m_publishedRows = 0;
+    int m_batchDepth = 0;
+    QSet<QString> m_batchChangedIds;
+    QSet<int> m_batchChangedRoles;
+
+    DataHistory m_history;
+    bool m_applyingHistory = false;
+    int m_historySuspended = 0;
+
+    DataAggregates *m_aggregates = nullptr;
 
     int findItemIndex(const QString &id) const;
+    void rebuildIndex() const;
+    int removedBefore(int base) const;
+    void markRemoved(int base);
+    void appendBase();
+    void appendItem(const DataItem &item);
+    void removeRowList(const QList<int> &rows);
+    void notifyRowsChanged(QList<int> rows, const QList<int> &roles);
+    void insertRowList(const QList<int> &rows, const QList<DataItem> &items);
+    QList<int> rowsOf(const QList<DataItem> &items) const;
+    void recordInsert(int first);
+    // Whether the first rows, stored as one undo step, stay within the history's memory limit
+    bool fitsHistory(int rows) const;
+    void recordChanges(QList<DataHistory::FieldChange> changes);
+    void recordHistory(DataHistory::Command command);
+    void applyCommand(const DataHistory::Command &command, bool inverse);
+    static QJsonObject toJson(const DataItem &item);
 };
\ No newline at end of file
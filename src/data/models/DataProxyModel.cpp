@@ -0,0 +1,210 @@
+#include "DataProxyModel.h"
+#include <algorithm>
+
+DataProxyModel::DataProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_dataModel(nullptr)
+    , m_sortRole(-1)
+    , m_ascending(true)
+{
+    setDynamicSortFilter(true);
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &DataProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &DataProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &DataProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &DataProxyModel::countChanged);
+
+    qDebug(appModels) << "DataProxyModel initialized";
+}
+
+DataProxyModel::~DataProxyModel()
+{
+}
+
+void DataProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (m_dataModel) {
+        disconnect(m_dataModel, nullptr, this, nullptr);
+    }
+
+    m_dataModel = qobject_cast<DataModel *>(sourceModel);
+    if (sourceModel && !m_dataModel) {
+        qWarning(appModels) << "DataProxyModel only supports DataModel sources";
+    }
+
+    // Connected before the base class hooks the source, so keys are current
+    // by the time the proxy sorts or filters the affected rows.
+    if (m_dataModel) {
+        connect(m_dataModel, &QAbstractItemModel::rowsInserted, this, &DataProxyModel::onSourceRowsInserted);
+        connect(m_dataModel, &QAbstractItemModel::rowsRemoved, this, &DataProxyModel::onSourceRowsRemoved);
+        connect(m_dataModel, &QAbstractItemModel::dataChanged, this, &DataProxyModel::onSourceDataChanged);
+        connect(m_dataModel, &QAbstractItemModel::modelReset, this, &DataProxyModel::onSourceModelReset);
+    }
+    onSourceModelReset();
+
+    QSortFilterProxyModel::setSourceModel(m_dataModel);
+    applySort();
+}
+
+QString DataProxyModel::filterText() const
+{
+    return m_filterText;
+}
+
+void DataProxyModel::setFilterText(const QString &filterText)
+{
+    if (m_filterText == filterText) {
+        return;
+    }
+
+    m_filterText = filterText;
+    m_foldedFilter = filterText.toCaseFolded();
+    invalidateRowsFilter();
+    emit filterTextChanged();
+}
+
+QString DataProxyModel::sortBy() const
+{
+    return m_sortBy;
+}
+
+void DataProxyModel::setSortBy(const QString &sortBy)
+{
+    if (m_sortBy == sortBy) {
+        return;
+    }
+    m_sortBy = sortBy;
+    applySort();
+    emit sortByChanged();
+}
+
+bool DataProxyModel::ascending() const
+{
+    return m_ascending;
+}
+
+void DataProxyModel::setAscending(bool ascending)
+{
+    if (m_ascending == ascending) {
+        return;
+    }
+    m_ascending = ascending;
+    applySort();
+    emit ascendingChanged();
+}
+
+QString DataProxyModel::idAt(int proxyRow) const
+{
+    return data(index(proxyRow, 0), DataModel::IdRole).toString();
+}
+
+bool DataProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+    if (m_foldedFilter.isEmpty()) {
+        return true;
+    }
+    if (sourceRow >= m_keys.size()) {
+        return false;
+    }
+
+    const SortKeys &keys = m_keys[sourceRow];
+    return keys.name.contains(m_foldedFilter) || keys.description.contains(m_foldedFilter);
+}
+
+bool DataProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const int leftRow = left.row();
+    const int rightRow = right.row();
+
+    switch (m_sortRole) {
+    case DataModel::ValueRole: {
+        const DataColumns &columns = m_dataModel->columns();
+        return columns.value(leftRow) < columns.value(rightRow);
+    }
+    case DataModel::NameRole:
+        return m_keys[leftRow].name < m_keys[rightRow].name;
+    case DataModel::DescriptionRole:
+        return m_keys[leftRow].description < m_keys[rightRow].description;
+    default:
+        return leftRow < rightRow;
+    }
+}
+
+void DataProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    QList<SortKeys> inserted;
+    inserted.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        inserted.append(keysForRow(row));
+    }
+
+    if (first == m_keys.size()) {
+        m_keys.append(std::move(inserted));
+    } else {
+        m_keys.insert(first, inserted.size(), SortKeys());
+        std::move(inserted.begin(), inserted.end(), m_keys.begin() + first);
+    }
+}
+
+void DataProxyModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    m_keys.remove(first, last - first + 1);
+}
+
+void DataProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (!roles.isEmpty() && !roles.contains(DataModel::NameRole) && !roles.contains(DataModel::DescriptionRole)) {
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        m_keys[row] = keysForRow(row);
+    }
+}
+
+void DataProxyModel::onSourceModelReset()
+{
+    m_keys.clear();
+    if (!m_dataModel) {
+        return;
+    }
+
+    const int rows = m_dataModel->rowCount();
+    m_keys.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_keys.append(keysForRow(row));
+    }
+}
+
+DataProxyModel::SortKeys DataProxyModel::keysForRow(int sourceRow) const
+{
+    const DataColumns &columns = m_dataModel->columns();
+    return {columns.name(sourceRow).toCaseFolded(), columns.description(sourceRow).toCaseFolded()};
+}
+
+void DataProxyModel::applySort()
+{
+    if (m_sortBy == QLatin1String("name")) {
+        m_sortRole = DataModel::NameRole;
+    } else if (m_sortBy == QLatin1String("description")) {
+        m_sortRole = DataModel::DescriptionRole;
+    } else if (m_sortBy == QLatin1String("value")) {
+        m_sortRole = DataModel::ValueRole;
+    } else {
+        m_sortRole = -1;
+    }
+
+    if (!m_dataModel) {
+        return;
+    }
+    if (m_sortRole < 0) {
+        // Column -1 restores source order.
+        sort(-1);
+        return;
+    }
+    // Lets dynamic sorting re-place rows when exactly this role changes.
+    setSortRole(m_sortRole);
+    sort(0, m_ascending ? Qt::AscendingOrder : Qt::DescendingOrder);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QObject>
+#include <QtQml/qqmlregistration.h>
+#include <QSortFilterProxyModel>
+#include <QList>
+#include "DataModel.h"
+
+// Filtered, sorted view over a DataModel. Case-folded name/description keys
+// are computed once per source row and kept in step with the source, so
+// comparisons and filter checks never go through data() or re-fold strings.
+// Inserted and changed rows are placed incrementally (dynamic sort/filter).
+class DataProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+    Q_PROPERTY(QString sortBy READ sortBy WRITE setSortBy NOTIFY sortByChanged)
+    Q_PROPERTY(bool ascending READ ascending WRITE setAscending NOTIFY ascendingChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    explicit DataProxyModel(QObject *parent = nullptr);
+    ~DataProxyModel();
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QString filterText() const;
+    void setFilterText(const QString &filterText);
+    // "name", "description" or "value"; empty keeps source order
+    QString sortBy() const;
+    void setSortBy(const QString &sortBy);
+    bool ascending() const;
+    void setAscending(bool ascending);
+
+    Q_INVOKABLE QString idAt(int proxyRow) const;
+
+signals:
+    void filterTextChanged();
+    void sortByChanged();
+    void ascendingChanged();
+    void countChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private slots:
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onSourceModelReset();
+
+private:
+    struct SortKeys {
+        QString name;
+        QString description;
+    };
+
+    DataModel *m_dataModel;
+    QList<SortKeys> m_keys;
+    QString m_filterText;
+    QString m_foldedFilter;
+    QString m_sortBy;
+    int m_sortRole;
+    bool m_ascending;
+
+    SortKeys keysForRow(int sourceRow) const;
+    void applySort();
+};
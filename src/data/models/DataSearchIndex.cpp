@@ -0,0 +1,295 @@
+#include "DataSearchIndex.h"
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+// Dead handles are purged by a rebuild once there are more of them than live ones.
+constexpr int kMinDeadToPurge = 1024;
+
+void sortUnique(QList<quint64> &keys)
+{
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+QList<quint32> intersect(const QList<quint32> &a, const QList<quint32> &b)
+{
+    QList<quint32> result;
+    result.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(result));
+    return result;
+}
+
+bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber();
+}
+}
+
+DataSearchIndex::DataSearchIndex(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+{
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &DataSearchIndex::onRowsInserted);
+    connect(m_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DataSearchIndex::onRowsAboutToBeRemoved);
+    connect(m_model, &QAbstractItemModel::rowsRemoved, this, [this]() {
+        purgeIfWasteful();
+    });
+    connect(m_model, &QAbstractItemModel::dataChanged, this, &DataSearchIndex::onDataChanged);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &DataSearchIndex::rebuild);
+
+    rebuild();
+}
+
+DataSearchIndex::~DataSearchIndex()
+{
+}
+
+QList<int> DataSearchIndex::search(const QString &query) const
+{
+    static const QRegularExpression whitespace(QStringLiteral("\\s+"));
+    QStringList terms = query.split(whitespace, Qt::SkipEmptyParts);
+
+    QList<int> rows;
+    if (terms.isEmpty()) {
+        rows.reserve(m_model->rowCount());
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            rows.append(row);
+        }
+        return rows;
+    }
+
+    QList<Postings> candidates;
+    candidates.reserve(terms.size());
+    for (QString &term : terms) {
+        term = term.toCaseFolded();
+        candidates.append(candidatesFor(term));
+        if (candidates.last().isEmpty()) {
+            return rows;
+        }
+    }
+
+    // Intersect smallest first so the working set only shrinks.
+    std::sort(candidates.begin(), candidates.end(), [](const Postings &a, const Postings &b) {
+        return a.size() < b.size();
+    });
+    Postings handles = candidates.first();
+    for (int i = 1; i < candidates.size() && !handles.isEmpty(); ++i) {
+        handles = intersect(handles, candidates[i]);
+    }
+
+    // Trigram hits are candidates only; confirm the substring on the live row.
+    const DataColumns &columns = m_model->columns();
+    const int publishedRows = m_model->rowCount();
+    rows.reserve(handles.size());
+    for (quint32 handle : std::as_const(handles)) {
+        if (!m_alive.testBit(handle)) {
+            continue;
+        }
+        const int row = m_model->rowOf(m_idByHandle[handle]);
+        if (row < 0 || row >= publishedRows) {
+            continue;
+        }
+
+        bool matches = true;
+        for (const QString &term : std::as_const(terms)) {
+            if (term.size() >= 3
+                && !columns.nameView(row).contains(term, Qt::CaseInsensitive)
+                && !columns.descriptionView(row).contains(term, Qt::CaseInsensitive)) {
+                matches = false;
+                break;
+            }
+        }
+        if (matches) {
+            rows.append(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+QStringList DataSearchIndex::searchIds(const QString &query) const
+{
+    QStringList ids;
+    const QList<int> rows = search(query);
+    ids.reserve(rows.size());
+    for (int row : rows) {
+        ids.append(m_model->columns().id(row));
+    }
+    return ids;
+}
+
+int DataSearchIndex::documentCount() const
+{
+    return m_handleById.size();
+}
+
+void DataSearchIndex::rebuild()
+{
+    m_trigrams.clear();
+    m_prefixes.clear();
+    m_idByHandle.clear();
+    m_handleById.clear();
+    m_alive.clear();
+    m_deadCount = 0;
+
+    const int rows = m_model->rowCount();
+    m_idByHandle.reserve(rows);
+    m_handleById.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        indexRow(row);
+    }
+
+    qDebug(appModels) << "Search index built for" << rows << "rows," << m_trigrams.size() << "trigrams";
+}
+
+void DataSearchIndex::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    for (int row = first; row <= last; ++row) {
+        indexRow(row);
+    }
+}
+
+void DataSearchIndex::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    const DataColumns &columns = m_model->columns();
+    for (int row = first; row <= last; ++row) {
+        auto it = m_handleById.constFind(columns.id(row));
+        if (it != m_handleById.constEnd()) {
+            removeHandle(it.value());
+        }
+    }
+}
+
+void DataSearchIndex::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (!roles.isEmpty() && !roles.contains(DataModel::NameRole) && !roles.contains(DataModel::DescriptionRole)) {
+        return;
+    }
+
+    // Changed text gets a fresh handle; the old one is skipped until purged.
+    const DataColumns &columns = m_model->columns();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        auto it = m_handleById.constFind(columns.id(row));
+        if (it != m_handleById.constEnd()) {
+            removeHandle(it.value());
+        }
+        indexRow(row);
+    }
+    purgeIfWasteful();
+}
+
+void DataSearchIndex::indexRow(int row)
+{
+    const DataColumns &columns = m_model->columns();
+    const quint32 handle = quint32(m_idByHandle.size());
+    const QString id = columns.id(row);
+
+    m_idByHandle.append(id);
+    m_handleById.insert(id, handle);
+    if (m_alive.size() <= int(handle)) {
+        m_alive.resize(qMax(1024, m_alive.size() * 2));
+    }
+    m_alive.setBit(handle);
+
+    QList<quint64> trigrams;
+    QList<quint64> prefixes;
+    collectKeys(columns.nameView(row).toString().toCaseFolded(), trigrams, prefixes);
+    collectKeys(columns.descriptionView(row).toString().toCaseFolded(), trigrams, prefixes);
+    sortUnique(trigrams);
+    sortUnique(prefixes);
+
+    // Handles only grow, so appending keeps every posting list sorted.
+    for (quint64 key : std::as_const(trigrams)) {
+        m_trigrams[key].append(handle);
+    }
+    for (quint64 key : std::as_const(prefixes)) {
+        m_prefixes[key].append(handle);
+    }
+}
+
+void DataSearchIndex::removeHandle(quint32 handle)
+{
+    if (!m_alive.testBit(handle)) {
+        return;
+    }
+    m_alive.clearBit(handle);
+    m_handleById.remove(m_idByHandle[handle]);
+    m_idByHandle[handle].clear();
+    ++m_deadCount;
+}
+
+DataSearchIndex::Postings DataSearchIndex::candidatesFor(const QString &term) const
+{
+    if (term.size() < 3) {
+        return m_prefixes.value(prefixKey(term));
+    }
+
+    QList<quint64> keys;
+    for (int i = 0; i + 2 < term.size(); ++i) {
+        keys.append(trigramKey(term[i], term[i + 1], term[i + 2]));
+    }
+    sortUnique(keys);
+
+    QList<const Postings *> lists;
+    lists.reserve(keys.size());
+    for (quint64 key : std::as_const(keys)) {
+        auto it = m_trigrams.constFind(key);
+        if (it == m_trigrams.constEnd()) {
+            return Postings();
+        }
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const Postings *a, const Postings *b) {
+        return a->size() < b->size();
+    });
+
+    Postings result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        result = intersect(result, *lists[i]);
+    }
+    return result;
+}
+
+void DataSearchIndex::purgeIfWasteful()
+{
+    if (m_deadCount >= kMinDeadToPurge && m_deadCount > m_handleById.size()) {
+        rebuild();
+    }
+}
+
+void DataSearchIndex::collectKeys(QStringView folded, QList<quint64> &trigrams, QList<quint64> &prefixes)
+{
+    const qsizetype length = folded.size();
+    for (qsizetype i = 0; i + 2 < length; ++i) {
+        trigrams.append(trigramKey(folded[i], folded[i + 1], folded[i + 2]));
+    }
+
+    for (qsizetype i = 0; i < length; ++i) {
+        if (!isWordChar(folded[i]) || (i > 0 && isWordChar(folded[i - 1]))) {
+            continue;
+        }
+        prefixes.append(prefixKey(folded.mid(i, 1)));
+        if (i + 1 < length && isWordChar(folded[i + 1])) {
+            prefixes.append(prefixKey(folded.mid(i, 2)));
+        }
+    }
+}
+
+quint64 DataSearchIndex::trigramKey(QChar a, QChar b, QChar c)
+{
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+quint64 DataSearchIndex::prefixKey(QStringView prefix)
+{
+    // Length in the top bits keeps one-character prefixes apart from two-character ones.
+    quint64 key = quint64(prefix.size()) << 48;
+    for (qsizetype i = 0; i < prefix.size(); ++i) {
+        key |= quint64(prefix[i].unicode()) << (16 * (1 - i));
+    }
+    return key;
+}
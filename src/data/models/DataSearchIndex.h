@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QBitArray>
+#include <QStringList>
+#include "DataModel.h"
+
+// Inverted index over the case-folded name and description of a DataModel's
+// rows. Terms of three or more characters match as substrings through
+// trigram postings; shorter terms match word prefixes. Multi-term queries
+// are ANDed. The index follows the model's signals, so it never rescans.
+//
+// Documents are addressed by handles that never move; removed handles are
+// skipped at query time and purged once they outnumber the live ones.
+class DataSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataSearchIndex(DataModel *model, QObject *parent = nullptr);
+    ~DataSearchIndex();
+
+    // Rows matching every whitespace-separated term, in ascending row order
+    QList<int> search(const QString &query) const;
+    QStringList searchIds(const QString &query) const;
+
+    int documentCount() const;
+    void rebuild();
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+private:
+    using Postings = QList<quint32>;
+
+    DataModel *m_model;
+    QHash<quint64, Postings> m_trigrams;
+    QHash<quint64, Postings> m_prefixes;
+    QList<QString> m_idByHandle;
+    QHash<QString, quint32> m_handleById;
+    QBitArray m_alive;
+    int m_deadCount = 0;
+
+    void indexRow(int row);
+    void removeHandle(quint32 handle);
+    Postings candidatesFor(const QString &term) const;
+    void purgeIfWasteful();
+
+    static void collectKeys(QStringView folded, QList<quint64> &trigrams, QList<quint64> &prefixes);
+    static quint64 trigramKey(QChar a, QChar b, QChar c);
+    static quint64 prefixKey(QStringView prefix);
+};
@@ -0,0 +1,439 @@
+#include "DataSnapshot.h"
+#include "DataColumns.h"
+#include "DataModel.h"
+#include <QSaveFile>
+#include <QHash>
+#include <QtEndian>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr char kMagic[4] = {'Q', 'D', 'M', 'S'};
+constexpr quint16 kVersion = 1;
+constexpr qint64 kHeaderSize = 48;
+constexpr qint64 kHeaderCrcOffset = 44;
+constexpr qsizetype kWriteChunk = 1 << 20;
+
+template <typename T>
+T readLE(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+template <typename T>
+void appendLE(QByteArray &buffer, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    buffer.append(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+qint64 align8(qint64 offset)
+{
+    return (offset + 7) & ~qint64(7);
+}
+
+// Slicing-by-8 tables: eight bytes per step instead of one.
+using CrcTables = std::array<std::array<quint32, 256>, 8>;
+
+const CrcTables &crcTables()
+{
+    static const CrcTables tables = [] {
+        CrcTables t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+            t[0][i] = crc;
+        }
+        for (quint32 i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                t[slice][i] = (t[slice - 1][i] >> 8) ^ t[0][t[slice - 1][i] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// Buffers output, checksums it on the way out and flushes in large writes.
+class ChecksummedWriter
+{
+public:
+    explicit ChecksummedWriter(QIODevice *device)
+        : m_device(device)
+    {
+        m_buffer.reserve(kWriteChunk + 64);
+    }
+
+    QByteArray &buffer() { return m_buffer; }
+
+    bool maybeFlush()
+    {
+        return m_buffer.size() < kWriteChunk || flush();
+    }
+
+    bool flush()
+    {
+        m_crc = DataSnapshot::crc32(m_buffer.constData(), m_buffer.size(), m_crc);
+        m_written += m_buffer.size();
+        const bool ok = m_device->write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+        return ok;
+    }
+
+    void padTo8()
+    {
+        const qint64 offset = kHeaderSize + m_written + m_buffer.size();
+        m_buffer.append(QByteArray(qsizetype(align8(offset) - offset), '\0'));
+    }
+
+    bool writeIndexes(const QList<quint32> &indexes)
+    {
+        for (quint32 index : indexes) {
+            appendLE<quint32>(m_buffer, index);
+            if (!maybeFlush()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    quint32 crc() const { return m_crc; }
+    qint64 written() const { return m_written; }
+
+private:
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    quint32 m_crc = 0;
+    qint64 m_written = 0;
+};
+}
+
+DataSnapshot::DataSnapshot()
+{
+}
+
+DataSnapshot::~DataSnapshot()
+{
+    close();
+}
+
+bool DataSnapshot::open(const QString &snapshotPath)
+{
+    close();
+
+    m_file.setFileName(snapshotPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("Cannot open snapshot: ") + m_file.errorString());
+    }
+
+    m_size = m_file.size();
+    if (m_size < kHeaderSize) {
+        return fail(QStringLiteral("Snapshot is truncated"));
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        // Not mappable (e.g. a pipe or a filesystem without mmap); read it instead.
+        m_buffer = m_file.readAll();
+        if (m_buffer.size() != m_size) {
+            return fail(QStringLiteral("Cannot read snapshot: ") + m_file.errorString());
+        }
+        m_data = reinterpret_cast<const uchar *>(m_buffer.constData());
+    }
+
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+        return fail(QStringLiteral("Not a data snapshot"));
+    }
+    if (readLE<quint16>(m_data + 4) != kVersion) {
+        return fail(QStringLiteral("Unsupported snapshot version"));
+    }
+    if (crc32(reinterpret_cast<const char *>(m_data), kHeaderCrcOffset) != readLE<quint32>(m_data + kHeaderCrcOffset)) {
+        return fail(QStringLiteral("Snapshot header is corrupt"));
+    }
+
+    m_rowCount = readLE<quint32>(m_data + 8);
+    m_stringCount = readLE<quint32>(m_data + 12);
+    const quint64 charsOffset = readLE<quint64>(m_data + 16);
+    const quint64 columnsOffset = readLE<quint64>(m_data + 24);
+    const quint64 payloadSize = readLE<quint64>(m_data + 32);
+    const quint32 payloadCrc = readLE<quint32>(m_data + 40);
+
+    if (payloadSize != quint64(m_size - kHeaderSize)) {
+        return fail(QStringLiteral("Snapshot is truncated"));
+    }
+    if (crc32(reinterpret_cast<const char *>(m_data + kHeaderSize), qsizetype(payloadSize)) != payloadCrc) {
+        return fail(QStringLiteral("Snapshot data is corrupt"));
+    }
+
+    // The checksum guards against damage; these bounds guard against files we did not write.
+    const quint64 rows = m_rowCount;
+    const quint64 startsEnd = quint64(kHeaderSize) + (quint64(m_stringCount) + 1) * 4;
+    const quint64 valuesEnd = columnsOffset + rows * 16;
+    const quint64 enabledOffset = quint64(align8(qint64(valuesEnd)));
+    const quint64 columnsEnd = enabledOffset + (rows + 63) / 64 * 8;
+    if (startsEnd > charsOffset || charsOffset > columnsOffset || columnsEnd > quint64(m_size)
+        || charsOffset % 8 != 0 || columnsOffset % 8 != 0) {
+        return fail(QStringLiteral("Snapshot sections are out of bounds"));
+    }
+
+    m_starts = m_data + kHeaderSize;
+    const quint64 maxChars = (columnsOffset - charsOffset) / 2;
+    quint32 previous = 0;
+    for (quint32 i = 0; i <= m_stringCount; ++i) {
+        const quint32 start = readLE<quint32>(m_starts + qint64(i) * 4);
+        if (start < previous || start > maxChars) {
+            return fail(QStringLiteral("Snapshot string table is out of bounds"));
+        }
+        previous = start;
+    }
+
+    m_idColumn = m_data + columnsOffset;
+    m_nameColumn = m_idColumn + rows * 4;
+    m_descriptionColumn = m_nameColumn + rows * 4;
+    m_valueColumn = m_descriptionColumn + rows * 4;
+    m_enabledColumn = m_data + enabledOffset;
+    for (quint64 i = 0; i < rows * 3; ++i) {
+        if (readLE<quint32>(m_idColumn + i * 4) >= m_stringCount) {
+            return fail(QStringLiteral("Snapshot row references a missing string"));
+        }
+    }
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    m_swappedChars.resize(qsizetype(previous));
+    qFromLittleEndian<quint16>(m_data + charsOffset, qsizetype(previous), m_swappedChars.data());
+    m_chars = m_swappedChars.constData();
+#else
+    m_chars = reinterpret_cast<const QChar *>(m_data + charsOffset);
+#endif
+
+    m_errorString.clear();
+    return true;
+}
+
+void DataSnapshot::close()
+{
+    if (m_data && m_buffer.isEmpty()) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+    m_file.close();
+    m_buffer.clear();
+    m_swappedChars.clear();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_rowCount = 0;
+    m_stringCount = 0;
+    m_starts = nullptr;
+    m_chars = nullptr;
+    m_idColumn = nullptr;
+    m_nameColumn = nullptr;
+    m_descriptionColumn = nullptr;
+    m_valueColumn = nullptr;
+    m_enabledColumn = nullptr;
+}
+
+bool DataSnapshot::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString DataSnapshot::errorString() const
+{
+    return m_errorString;
+}
+
+int DataSnapshot::rowCount() const
+{
+    return int(m_rowCount);
+}
+
+QStringView DataSnapshot::id(int row) const
+{
+    return string(m_idColumn, row);
+}
+
+QStringView DataSnapshot::name(int row) const
+{
+    return string(m_nameColumn, row);
+}
+
+QStringView DataSnapshot::description(int row) const
+{
+    return string(m_descriptionColumn, row);
+}
+
+int DataSnapshot::value(int row) const
+{
+    return readLE<qint32>(m_valueColumn + qint64(row) * 4);
+}
+
+bool DataSnapshot::enabled(int row) const
+{
+    return (readLE<quint64>(m_enabledColumn + qint64(row >> 6) * 8) >> (row & 63)) & 1u;
+}
+
+bool DataSnapshot::save(const DataColumns &columns, const QString &snapshotPath, QString *errorString)
+{
+    auto setError = [errorString](const QString &error) {
+        if (errorString) {
+            *errorString = error;
+        }
+        return false;
+    };
+
+    // Ids are unique, so only names and descriptions go through the intern table.
+    const int rows = columns.size();
+    QList<QStringView> strings;
+    QHash<QStringView, quint32> interned;
+    QList<quint32> idIndexes;
+    QList<quint32> nameIndexes;
+    QList<quint32> descriptionIndexes;
+    strings.reserve(rows * 2);
+    idIndexes.reserve(rows);
+    nameIndexes.reserve(rows);
+    descriptionIndexes.reserve(rows);
+
+    auto intern = [&](QStringView text) {
+        auto it = interned.constFind(text);
+        if (it != interned.constEnd()) {
+            return it.value();
+        }
+        const quint32 index = quint32(strings.size());
+        strings.append(text);
+        interned.insert(text, index);
+        return index;
+    };
+
+    qint64 charCount = 0;
+    for (int row = 0; row < rows; ++row) {
+        idIndexes.append(quint32(strings.size()));
+        strings.append(columns.idView(row));
+        nameIndexes.append(intern(columns.nameView(row)));
+        descriptionIndexes.append(intern(columns.descriptionView(row)));
+    }
+    for (QStringView text : std::as_const(strings)) {
+        charCount += text.size();
+    }
+    if (charCount > std::numeric_limits<quint32>::max()) {
+        return setError(QStringLiteral("Too much text for one snapshot"));
+    }
+
+    const quint32 stringCount = quint32(strings.size());
+    const qint64 charsOffset = align8(kHeaderSize + (qint64(stringCount) + 1) * 4);
+    const qint64 columnsOffset = align8(charsOffset + charCount * 2);
+
+    QSaveFile file(snapshotPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return setError(QStringLiteral("Cannot create snapshot: ") + file.errorString());
+    }
+
+    // The header carries the payload checksum, so it is written last.
+    file.write(QByteArray(kHeaderSize, '\0'));
+
+    ChecksummedWriter writer(&file);
+    QByteArray &buffer = writer.buffer();
+    bool ok = true;
+
+    quint32 start = 0;
+    for (QStringView text : std::as_const(strings)) {
+        appendLE<quint32>(buffer, start);
+        start += quint32(text.size());
+        ok = ok && writer.maybeFlush();
+    }
+    appendLE<quint32>(buffer, start);
+    writer.padTo8();
+
+    for (QStringView text : std::as_const(strings)) {
+        const qsizetype offset = buffer.size();
+        buffer.resize(offset + text.size() * 2);
+        qToLittleEndian<quint16>(text.utf16(), text.size(), buffer.data() + offset);
+        ok = ok && writer.maybeFlush();
+    }
+    writer.padTo8();
+
+    ok = ok && writer.writeIndexes(idIndexes)
+        && writer.writeIndexes(nameIndexes)
+        && writer.writeIndexes(descriptionIndexes);
+    for (int row = 0; ok && row < rows; ++row) {
+        appendLE<qint32>(buffer, columns.value(row));
+        ok = writer.maybeFlush();
+    }
+    writer.padTo8();
+    for (int word = 0; ok && word < (rows + 63) / 64; ++word) {
+        quint64 bits = 0;
+        for (int row = word * 64; row < qMin(rows, word * 64 + 64); ++row) {
+            bits |= quint64(columns.enabled(row)) << (row & 63);
+        }
+        appendLE<quint64>(buffer, bits);
+        ok = writer.maybeFlush();
+    }
+    ok = ok && writer.flush();
+
+    if (!ok) {
+        file.cancelWriting();
+        return setError(QStringLiteral("Failed to write snapshot: ") + file.errorString());
+    }
+
+    QByteArray header;
+    header.append(kMagic, sizeof(kMagic));
+    appendLE<quint16>(header, kVersion);
+    appendLE<quint16>(header, 0);
+    appendLE<quint32>(header, quint32(rows));
+    appendLE<quint32>(header, stringCount);
+    appendLE<quint64>(header, quint64(charsOffset));
+    appendLE<quint64>(header, quint64(columnsOffset));
+    appendLE<quint64>(header, quint64(writer.written()));
+    appendLE<quint32>(header, writer.crc());
+    appendLE<quint32>(header, crc32(header.constData(), header.size()));
+
+    if (!file.seek(0) || file.write(header) != header.size()) {
+        file.cancelWriting();
+        return setError(QStringLiteral("Failed to write snapshot header: ") + file.errorString());
+    }
+
+    if (!file.commit()) {
+        return setError(QStringLiteral("Failed to commit snapshot: ") + file.errorString());
+    }
+
+    qDebug(appModels) << "Saved snapshot of" << rows << "rows," << stringCount << "strings to" << snapshotPath;
+    return true;
+}
+
+quint32 DataSnapshot::crc32(const char *data, qsizetype size, quint32 crc)
+{
+    const CrcTables &t = crcTables();
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        const quint32 low = qFromLittleEndian<quint32>(p) ^ crc;
+        const quint32 high = qFromLittleEndian<quint32>(p + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return ~crc;
+}
+
+QStringView DataSnapshot::string(const uchar *column, int row) const
+{
+    const quint32 index = readLE<quint32>(column + qint64(row) * 4);
+    const quint32 start = readLE<quint32>(m_starts + qint64(index) * 4);
+    const quint32 end = readLE<quint32>(m_starts + qint64(index) * 4 + 4);
+    return QStringView(m_chars + start, qsizetype(end - start));
+}
+
+bool DataSnapshot::fail(const QString &error)
+{
+    m_errorString = error;
+    qWarning(appModels) << "Snapshot" << m_file.fileName() << "rejected:" << error;
+    close();
+    return false;
+}
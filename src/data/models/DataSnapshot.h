@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QFile>
+
+class DataColumns;
+
+// Read-only view of a binary DataModel snapshot (.dms).
+//
+// Layout, all integers little-endian, every section 8-byte aligned:
+//   header   magic "QDMS", u16 version, u16 flags, u32 rowCount,
+//            u32 stringCount, u64 charsOffset, u64 columnsOffset,
+//            u64 payloadSize, u32 payloadCrc, u32 headerCrc
+//   strings  (stringCount + 1) x u32 start, in UTF-16 units into chars
+//   chars    UTF-16 text of every string, back to back
+//   columns  rowCount x u32 id string, rowCount x u32 name string,
+//            rowCount x u32 description string, rowCount x i32 value,
+//            ceil(rowCount / 64) x u64 enabled bits
+//
+// Names and descriptions are interned, so repeated text is stored once.
+// The file is memory-mapped when possible and read whole otherwise; the
+// views returned stay valid for as long as the snapshot is open.
+class DataSnapshot
+{
+public:
+    DataSnapshot();
+    ~DataSnapshot();
+
+    bool open(const QString &snapshotPath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    int rowCount() const;
+    QStringView id(int row) const;
+    QStringView name(int row) const;
+    QStringView description(int row) const;
+    int value(int row) const;
+    bool enabled(int row) const;
+
+    static bool save(const DataColumns &columns, const QString &snapshotPath,
+                     QString *errorString = nullptr);
+
+    // CRC-32 (IEEE); pass the previous result to checksum data in pieces
+    static quint32 crc32(const char *data, qsizetype size, quint32 crc = 0);
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_rowCount = 0;
+    quint32 m_stringCount = 0;
+    const uchar *m_starts = nullptr;
+    const QChar *m_chars = nullptr;
+    const uchar *m_idColumn = nullptr;
+    const uchar *m_nameColumn = nullptr;
+    const uchar *m_descriptionColumn = nullptr;
+    const uchar *m_valueColumn = nullptr;
+    const uchar *m_enabledColumn = nullptr;
+    // Byte-swapped copy of the text on big-endian hosts
+    QString m_swappedChars;
+    QString m_errorString;
+
+    QStringView string(const uchar *column, int row) const;
+    bool fail(const QString &error);
+
+    Q_DISABLE_COPY(DataSnapshot)
+};
@@ -0,0 +1,117 @@
+#include "DataSource.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+GeneratorDataSource::GeneratorDataSource(int count, Generator generator)
+    : m_count(count)
+    , m_generator(std::move(generator))
+{
+}
+
+int GeneratorDataSource::count() const
+{
+    return m_count;
+}
+
+QList<DataItem> GeneratorDataSource::fetch(int first, int count)
+{
+    QList<DataItem> items;
+    const int last = qMin(first + count, m_count);
+    items.reserve(qMax(0, last - first));
+    for (int row = first; row < last; ++row) {
+        items.append(m_generator(row));
+    }
+    return items;
+}
+
+JsonLinesDataSource::JsonLinesDataSource(const QString &filePath)
+    : m_file(filePath)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        qWarning(appModels) << "Cannot open data source" << filePath << m_errorString;
+        return;
+    }
+    buildIndex();
+}
+
+bool JsonLinesDataSource::isValid() const
+{
+    return m_file.isOpen();
+}
+
+QString JsonLinesDataSource::errorString() const
+{
+    return m_errorString;
+}
+
+int JsonLinesDataSource::count() const
+{
+    return m_count;
+}
+
+QList<DataItem> JsonLinesDataSource::fetch(int first, int count)
+{
+    QList<DataItem> items;
+    if (!isValid() || first < 0 || first >= m_count) {
+        return items;
+    }
+    const int last = qMin(first + count, m_count);
+    items.reserve(last - first);
+
+    QMutexLocker locker(&m_mutex);
+    const int checkpoint = first / kCheckpointInterval;
+    m_file.seek(m_checkpoints[checkpoint]);
+
+    // Skip from the checkpoint to the first requested row; blank lines carry no row.
+    int row = checkpoint * kCheckpointInterval;
+    while (row < last && !m_file.atEnd()) {
+        const QByteArray line = m_file.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (row >= first) {
+            items.append(parseLine(line, row));
+        }
+        ++row;
+    }
+    return items;
+}
+
+void JsonLinesDataSource::buildIndex()
+{
+    m_checkpoints.clear();
+    m_count = 0;
+
+    qint64 offset = 0;
+    while (!m_file.atEnd()) {
+        const QByteArray line = m_file.readLine();
+        const qint64 lineStart = offset;
+        offset += line.size();
+        if (line.trimmed().isEmpty()) {
+            continue;
+        }
+        if (m_count % kCheckpointInterval == 0) {
+            m_checkpoints.append(lineStart);
+        }
+        ++m_count;
+    }
+
+    qDebug(appModels) << "Indexed" << m_count << "rows in" << m_file.fileName();
+}
+
+DataItem JsonLinesDataSource::parseLine(const QByteArray &line, int row)
+{
+    const QJsonObject object = QJsonDocument::fromJson(line).object();
+    QString id = object.value("id").toString();
+    if (id.isEmpty()) {
+        // Stable across evictions, unlike a fresh UUID per fetch.
+        id = QString::number(row);
+    }
+    return {id,
+            object.value("name").toString(),
+            object.value("description").toString(),
+            object.value("value").toInt(),
+            object.value("enabled").toBool(true)};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QFile>
+#include <QMutex>
+#include <functional>
+#include "DataModel.h"
+
+// Random-access backing store for PagedDataModel. Implementations only need
+// to produce a window of rows on demand; nothing is kept resident here.
+class DataSource
+{
+public:
+    virtual ~DataSource() = default;
+
+    virtual int count() const = 0;
+    virtual QList<DataItem> fetch(int first, int count) = 0;
+};
+
+// Rows computed from their index, e.g. for demos and load tests.
+class GeneratorDataSource : public DataSource
+{
+public:
+    using Generator = std::function<DataItem(int row)>;
+
+    GeneratorDataSource(int count, Generator generator);
+
+    int count() const override;
+    QList<DataItem> fetch(int first, int count) override;
+
+private:
+    int m_count;
+    Generator m_generator;
+};
+
+// JSON Lines file, one item object per line. Only the offset of every
+// kCheckpointInterval-th line is kept, so the index stays small for large files.
+class JsonLinesDataSource : public DataSource
+{
+public:
+    explicit JsonLinesDataSource(const QString &filePath);
+
+    bool isValid() const;
+    QString errorString() const;
+
+    int count() const override;
+    QList<DataItem> fetch(int first, int count) override;
+
+private:
+    static constexpr int kCheckpointInterval = 256;
+
+    QFile m_file;
+    QMutex m_mutex;
+    QList<qint64> m_checkpoints;
+    int m_count = 0;
+    QString m_errorString;
+
+    void buildIndex();
+    static DataItem parseLine(const QByteArray &line, int row);
+};
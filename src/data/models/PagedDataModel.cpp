@@ -0,0 +1,208 @@
+#include "PagedDataModel.h"
+
+namespace {
+constexpr int kDefaultPageSize = 256;
+constexpr int kDefaultMaxCachedPages = 8;
+}
+
+PagedDataModel::PagedDataModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_pageSize(kDefaultPageSize)
+    , m_maxCachedPages(kDefaultMaxCachedPages)
+{
+    qDebug(appModels) << "PagedDataModel initialized";
+}
+
+PagedDataModel::~PagedDataModel()
+{
+}
+
+void PagedDataModel::setSource(DataSource *source)
+{
+    beginResetModel();
+    m_source.reset(source);
+    m_fetchedRows = 0;
+    m_pages.clear();
+    endResetModel();
+
+    emit countChanged();
+    qDebug(appModels) << "Paged source set with" << getCount() << "rows";
+}
+
+DataSource *PagedDataModel::source() const
+{
+    return m_source.data();
+}
+
+bool PagedDataModel::openFile(const QString &filePath)
+{
+    auto *source = new JsonLinesDataSource(filePath);
+    if (!source->isValid()) {
+        delete source;
+        return false;
+    }
+    setSource(source);
+    return true;
+}
+
+int PagedDataModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_fetchedRows;
+}
+
+QVariant PagedDataModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_fetchedRows) {
+        return QVariant();
+    }
+
+    const DataItem *item = itemAt(index.row());
+    if (!item) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case DataModel::IdRole:
+        return item->id;
+    case DataModel::NameRole:
+        return item->name;
+    case DataModel::DescriptionRole:
+        return item->description;
+    case DataModel::ValueRole:
+        return item->value;
+    case DataModel::EnabledRole:
+        return item->enabled;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> PagedDataModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[DataModel::IdRole] = "id";
+    roles[DataModel::NameRole] = "name";
+    roles[DataModel::DescriptionRole] = "description";
+    roles[DataModel::ValueRole] = "value";
+    roles[DataModel::EnabledRole] = "enabled";
+    return roles;
+}
+
+bool PagedDataModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_source) {
+        return false;
+    }
+    return m_fetchedRows < m_source->count();
+}
+
+void PagedDataModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    // Rows are only announced here; their page is read when a view asks for it.
+    const int count = qMin(m_pageSize, m_source->count() - m_fetchedRows);
+    beginInsertRows(QModelIndex(), m_fetchedRows, m_fetchedRows + count - 1);
+    m_fetchedRows += count;
+    endInsertRows();
+}
+
+int PagedDataModel::getCount() const
+{
+    return m_source ? m_source->count() : 0;
+}
+
+QJsonObject PagedDataModel::getItem(int row) const
+{
+    if (!m_source || row < 0 || row >= m_source->count()) {
+        return QJsonObject();
+    }
+
+    const DataItem *item = itemAt(row);
+    if (!item) {
+        return QJsonObject();
+    }
+
+    QJsonObject obj;
+    obj["id"] = item->id;
+    obj["name"] = item->name;
+    obj["description"] = item->description;
+    obj["value"] = item->value;
+    obj["enabled"] = item->enabled;
+    return obj;
+}
+
+int PagedDataModel::pageSize() const
+{
+    return m_pageSize;
+}
+
+void PagedDataModel::setPageSize(int pageSize)
+{
+    pageSize = qMax(1, pageSize);
+    if (m_pageSize == pageSize) {
+        return;
+    }
+    m_pageSize = pageSize;
+    m_pages.clear();
+    emit pageSizeChanged();
+}
+
+int PagedDataModel::maxCachedPages() const
+{
+    return m_maxCachedPages;
+}
+
+void PagedDataModel::setMaxCachedPages(int pages)
+{
+    pages = qMax(1, pages);
+    if (m_maxCachedPages == pages) {
+        return;
+    }
+    m_maxCachedPages = pages;
+    evictFarPages(-1);
+    emit maxCachedPagesChanged();
+}
+
+int PagedDataModel::cachedPageCount() const
+{
+    return m_pages.size();
+}
+
+const DataItem *PagedDataModel::itemAt(int row) const
+{
+    const int page = row / m_pageSize;
+    if (!m_pages.contains(page)) {
+        m_pages.insert(page, m_source->fetch(page * m_pageSize, m_pageSize));
+        evictFarPages(page);
+    }
+
+    const QList<DataItem> &items = m_pages[page];
+    const int offset = row - page * m_pageSize;
+    return offset < items.size() ? &items[offset] : nullptr;
+}
+
+void PagedDataModel::evictFarPages(int currentPage) const
+{
+    // Drop the pages furthest from the one just read; views scroll, so distance beats recency.
+    while (m_pages.size() > m_maxCachedPages) {
+        int farthest = -1;
+        int farthestDistance = -1;
+        for (auto it = m_pages.constBegin(); it != m_pages.constEnd(); ++it) {
+            const int distance = qAbs(it.key() - currentPage);
+            if (it.key() != currentPage && distance > farthestDistance) {
+                farthest = it.key();
+                farthestDistance = distance;
+            }
+        }
+        if (farthest < 0) {
+            break;
+        }
+        m_pages.remove(farthest);
+    }
+}
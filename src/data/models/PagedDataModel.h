@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <QtQml/qqmlregistration.h>
+#include <QAbstractListModel>
+#include <QHash>
+#include <QScopedPointer>
+#include <QJsonObject>
+#include "DataModel.h"
+#include "DataSource.h"
+
+// List model over a DataSource that materializes rows page by page. Views
+// grow it through canFetchMore()/fetchMore(); pages far from the rows being
+// read are evicted, so memory follows the viewport rather than the data set.
+class PagedDataModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(int count READ getCount NOTIFY countChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    Q_PROPERTY(int maxCachedPages READ maxCachedPages WRITE setMaxCachedPages NOTIFY maxCachedPagesChanged)
+
+public:
+    explicit PagedDataModel(QObject *parent = nullptr);
+    ~PagedDataModel();
+
+    // Takes ownership of the source
+    void setSource(DataSource *source);
+    DataSource *source() const;
+    Q_INVOKABLE bool openFile(const QString &filePath);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    // Logical total of the source, not just the rows fetched so far
+    Q_INVOKABLE int getCount() const;
+    Q_INVOKABLE QJsonObject getItem(int row) const;
+
+    int pageSize() const;
+    void setPageSize(int pageSize);
+    int maxCachedPages() const;
+    void setMaxCachedPages(int pages);
+    int cachedPageCount() const;
+
+signals:
+    void countChanged();
+    void pageSizeChanged();
+    void maxCachedPagesChanged();
+
+private:
+    QScopedPointer<DataSource> m_source;
+    int m_fetchedRows = 0;
+    int m_pageSize;
+    int m_maxCachedPages;
+    mutable QHash<int, QList<DataItem>> m_pages;
+
+    const DataItem *itemAt(int row) const;
+    void evictFarPages(int currentPage) const;
+};
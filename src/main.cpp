@@ -7,6 +7,9 @@
 
 #include "core/Application.h"
 #include "core/QmlTypeRegistry.h"
+#include "core/ResourceManager.h"
+#include "core/ResourceImageProvider.h"
+#include "core/TranslationManager.h"
 #include "plugin/PluginLoader.h"
 
 
@@ -30,7 +33,11 @@ int main(int argc, char *argv[])
         auto *pluginLoader = PluginLoader::instance();
         pluginLoader->loadPluginSystem(pluginConfig);
 
+        ResourceManager::instance()->initialize();
+
         QQmlApplicationEngine engine;
+        engine.addImageProvider(ResourceImageProvider::providerId(), new ResourceImageProvider());
+        ResourceManager::instance()->translations()->setEngine(&engine);
 
         // Register QML types
         auto* qmlRegistry = QmlTypeRegistry::instance();
@@ -0,0 +1,164 @@
+#include "PluginCache.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+PluginCache::PluginCache(const QString &filePath)
+    : m_filePath(filePath)
+{
+    if (m_filePath.isEmpty()) {
+        m_filePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                     + "/plugin-cache.json";
+    }
+}
+
+QString PluginCache::filePath() const
+{
+    return m_filePath;
+}
+
+void PluginCache::setFilePath(const QString &filePath)
+{
+    m_filePath = filePath;
+}
+
+bool PluginCache::load()
+{
+    m_entries.clear();
+    m_dirty = false;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Ignoring unreadable plugin cache:" << m_filePath << parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    if (root.value("version").toInt() != kVersion) {
+        qDebug() << "Ignoring plugin cache of another version:" << m_filePath;
+        return false;
+    }
+
+    const QJsonArray plugins = root.value("plugins").toArray();
+    m_entries.reserve(plugins.size());
+    for (const QJsonValue &value : plugins) {
+        const QJsonObject object = value.toObject();
+        const QString path = object.value("path").toString();
+        if (path.isEmpty()) {
+            continue;
+        }
+        Entry entry;
+        entry.size = object.value("size").toInteger();
+        entry.modified = object.value("modified").toInteger();
+        entry.metaData = object.value("metaData").toObject();
+        m_entries.insert(path, entry);
+    }
+    return true;
+}
+
+bool PluginCache::save()
+{
+    if (!m_dirty) {
+        return true;
+    }
+
+    QStringList paths = m_entries.keys();
+    paths.sort();
+
+    QJsonArray plugins;
+    for (const QString &path : paths) {
+        const Entry &entry = m_entries[path];
+        QJsonObject object;
+        object["path"] = path;
+        object["size"] = entry.size;
+        object["modified"] = entry.modified;
+        object["metaData"] = entry.metaData;
+        plugins.append(object);
+    }
+
+    QJsonObject root;
+    root["version"] = kVersion;
+    root["plugins"] = plugins;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) == -1
+        || !file.commit()) {
+        qWarning() << "Failed to write plugin cache:" << m_filePath << file.errorString();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool PluginCache::lookup(const QFileInfo &file, QJsonObject *metaData) const
+{
+    const auto it = m_entries.constFind(file.absoluteFilePath());
+    if (it == m_entries.constEnd()
+        || it->size != file.size()
+        || it->modified != file.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    *metaData = it->metaData;
+    return true;
+}
+
+void PluginCache::insert(const QFileInfo &file, const QJsonObject &metaData)
+{
+    Entry entry;
+    entry.size = file.size();
+    entry.modified = file.lastModified().toMSecsSinceEpoch();
+    entry.metaData = metaData;
+    m_entries.insert(file.absoluteFilePath(), entry);
+    m_dirty = true;
+}
+
+void PluginCache::retain(const QStringList &paths)
+{
+    const QSet<QString> keep(paths.cbegin(), paths.cend());
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (keep.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+void PluginCache::clear()
+{
+    m_dirty = m_dirty || !m_entries.isEmpty();
+    m_entries.clear();
+}
+
+int PluginCache::size() const
+{
+    return m_entries.size();
+}
+
+QJsonObject PluginCache::pluginData(const QJsonObject &metaData)
+{
+    return metaData.value("MetaData").toObject();
+}
+
+QString PluginCache::pluginName(const QJsonObject &metaData, const QString &fallback)
+{
+    const QString name = pluginData(metaData).value("name").toString();
+    return name.isEmpty() ? fallback : name;
+}
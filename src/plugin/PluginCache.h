@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonObject>
+
+class QFileInfo;
+
+// Persistent index of plugin metadata. Each entry holds the JSON that
+// QPluginLoader::metaData() read from a library file, keyed by the file's
+// path and valid while its size and modification time are unchanged, so a
+// warm start learns every plugin's name and description without opening
+// the libraries.
+//
+// File layout:
+//   { "version": 1,
+//     "plugins": [ { "path", "size", "modified", "metaData" }, ... ] }
+class PluginCache
+{
+public:
+    explicit PluginCache(const QString &filePath = QString());
+
+    QString filePath() const;
+    void setFilePath(const QString &filePath);
+
+    bool load();
+    // Writes the cache if anything changed since it was loaded
+    bool save();
+
+    // Metadata recorded for the file, if it has not changed since
+    bool lookup(const QFileInfo &file, QJsonObject *metaData) const;
+    void insert(const QFileInfo &file, const QJsonObject &metaData);
+    // Drops entries of files that are gone
+    void retain(const QStringList &paths);
+    void clear();
+    int size() const;
+
+    // "MetaData" object of a plugin's metadata (the plugin's JSON file)
+    static QJsonObject pluginData(const QJsonObject &metaData);
+    static QString pluginName(const QJsonObject &metaData, const QString &fallback);
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        QJsonObject metaData;
+    };
+
+    static constexpr int kVersion = 1;
+
+    QString m_filePath;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+};
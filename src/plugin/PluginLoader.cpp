@@ -45,6 +45,11 @@ bool PluginLoader::loadPluginSystem(const QVariantMap &config)
         qDebug() << "Created plugin directory:" << pluginDir;
     }
 
+    if (config.contains("pluginCache")) {
+        manager->setCachePath(config.value("pluginCache").toString());
+    }
+    manager->setDisabledPlugins(config.value("disabledPlugins").toStringList());
+
     if (!manager->loadPlugins(pluginDir)) {
         qWarning() << "Failed to load plugins from:" << pluginDir;
     }
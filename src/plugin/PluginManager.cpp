@@ -3,6 +3,9 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QLoggingCategory>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 PluginManager* PluginManager::s_instance = nullptr;
 
@@ -16,6 +19,7 @@ PluginManager* PluginManager::instance()
 
 PluginManager::PluginManager(QObject *parent)
     : QObject(parent)
+    , m_pool(new QThreadPool(this))
 {
     m_pluginDir = QCoreApplication::applicationDirPath() + "/plugins";
 }
@@ -26,7 +30,7 @@ PluginManager::~PluginManager()
     s_instance = nullptr;
 }
 
-bool PluginManager::loadPlugins(const QString &pluginDir)
+bool PluginManager::scanPlugins(const QString &pluginDir)
 {
     if (!pluginDir.isEmpty()) {
         m_pluginDir = pluginDir;
@@ -42,12 +46,96 @@ bool PluginManager::loadPlugins(const QString &pluginDir)
     filters << "*.dll" << "*.so" << "*.dylib";
     dir.setNameFilters(filters);
 
-    QStringList pluginFiles = dir.entryList(QDir::Files);
-    bool success = true;
+    m_cache.load();
 
+    const QStringList pluginFiles = dir.entryList(QDir::Files, QDir::Name);
+    QList<Candidate> candidates;
+    QStringList paths;
+    QList<int> misses;
+    candidates.reserve(pluginFiles.size());
+    paths.reserve(pluginFiles.size());
     for (const QString &pluginFile : pluginFiles) {
-        QString fullPath = dir.absoluteFilePath(pluginFile);
-        if (!loadPlugin(fullPath)) {
+        const QFileInfo info(dir.absoluteFilePath(pluginFile));
+        Candidate candidate;
+        candidate.path = info.absoluteFilePath();
+        if (!m_cache.lookup(info, &candidate.metaData)) {
+            misses.append(candidates.size());
+        }
+        candidates.append(candidate);
+        paths.append(candidate.path);
+    }
+
+    // metaData() reads the library file without opening it
+    QtConcurrent::blockingMap(m_pool, misses, [&candidates](int index) {
+        QPluginLoader loader(candidates[index].path);
+        candidates[index].metaData = loader.metaData();
+    });
+
+    for (int index : std::as_const(misses)) {
+        m_cache.insert(QFileInfo(candidates[index].path), candidates[index].metaData);
+    }
+    m_cache.retain(paths);
+    m_cache.save();
+
+    for (Candidate &candidate : candidates) {
+        candidate.name = PluginCache::pluginName(candidate.metaData, QFileInfo(candidate.path).baseName());
+    }
+    m_discovered = candidates;
+
+    qDebug() << "Scanned" << candidates.size() << "plugin files," << misses.size() << "not cached";
+    return true;
+}
+
+bool PluginManager::loadPlugins(const QString &pluginDir)
+{
+    if (!scanPlugins(pluginDir)) {
+        return false;
+    }
+
+    bool success = true;
+    QList<Candidate> candidates;
+    QSet<QString> names;
+    for (const Candidate &discovered : std::as_const(m_discovered)) {
+        if (discovered.metaData.isEmpty()) {
+            qWarning() << "Failed to load plugin:" << discovered.path
+                                    << "Error: Not a Qt plugin";
+            emit pluginError(discovered.name, "Not a Qt plugin");
+            success = false;
+            continue;
+        }
+        if (m_plugins.contains(discovered.name) || !shouldLoad(discovered)) {
+            continue;
+        }
+        // Only the first file by a name is loaded; a second one would be
+        // opened in parallel just to be refused by registerPlugin().
+        if (names.contains(discovered.name)) {
+            qWarning() << "Failed to load plugin:" << discovered.path
+                                    << "Error: Duplicate plugin name" << discovered.name;
+            emit pluginError(discovered.name, "Duplicate plugin name");
+            success = false;
+            continue;
+        }
+        names.insert(discovered.name);
+        Candidate candidate = discovered;
+        candidate.loader = new QPluginLoader(candidate.path, this);
+        candidates.append(candidate);
+    }
+
+    // dlopen (with the library's static constructors) is independent per
+    // file; only instance() has to run on this thread.
+    QtConcurrent::blockingMap(m_pool, candidates, &PluginManager::loadLibrary);
+
+    for (const Candidate &candidate : std::as_const(candidates)) {
+        QPluginLoader *loader = candidate.loader;
+        if (!candidate.loaded) {
+            qWarning() << "Failed to load plugin:" << candidate.path
+                                    << "Error:" << loader->errorString();
+            emit pluginError(candidate.name, loader->errorString());
+            delete loader;
+            success = false;
+            continue;
+        }
+        if (!registerPlugin(loader, candidate.path, candidate.name)) {
             success = false;
         }
     }
@@ -55,6 +143,27 @@ bool PluginManager::loadPlugins(const QString &pluginDir)
     return success;
 }
 
+void PluginManager::loadLibrary(Candidate &candidate)
+{
+    candidate.loaded = candidate.loader->load();
+}
+
+const PluginManager::Candidate *PluginManager::findDiscovered(const QString &name) const
+{
+    for (const Candidate &candidate : m_discovered) {
+        if (candidate.name == name && !candidate.metaData.isEmpty()) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+bool PluginManager::shouldLoad(const Candidate &candidate) const
+{
+    return !m_disabledPlugins.contains(candidate.name)
+           && PluginCache::pluginData(candidate.metaData).value("loadOnStartup").toBool(true);
+}
+
 bool PluginManager::loadPlugin(const QString &pluginPath)
 {
     QPluginLoader *loader = new QPluginLoader(pluginPath, this);
@@ -66,6 +175,26 @@ bool PluginManager::loadPlugin(const QString &pluginPath)
         return false;
     }
 
+    return registerPlugin(loader, pluginPath,
+                          PluginCache::pluginName(loader->metaData(), QFileInfo(pluginPath).baseName()));
+}
+
+bool PluginManager::loadPluginByName(const QString &name)
+{
+    if (m_plugins.contains(name)) {
+        return true;
+    }
+
+    const Candidate *candidate = findDiscovered(name);
+    if (!candidate) {
+        qWarning() << "Plugin not found:" << name;
+        return false;
+    }
+    return loadPlugin(candidate->path);
+}
+
+bool PluginManager::registerPlugin(QPluginLoader *loader, const QString &pluginPath, const QString &pluginName)
+{
     QObject *pluginObj = loader->instance();
     if (!pluginObj) {
         qWarning() << "Failed to get plugin instance:" << pluginPath
@@ -85,7 +214,12 @@ bool PluginManager::loadPlugin(const QString &pluginPath)
         return false;
     }
 
-    QString pluginName = plugin->name();
+    // Registered under the metadata name, which scanning, disabling and
+    // loadPluginByName() all go by.
+    if (plugin->name() != pluginName) {
+        qWarning() << "Plugin" << pluginPath << "calls itself" << plugin->name()
+                   << "but its metadata names it" << pluginName;
+    }
     if (m_plugins.contains(pluginName)) {
         qWarning() << "Plugin already loaded:" << pluginName;
         emit pluginError(pluginName, "Plugin already loaded");
@@ -187,7 +321,18 @@ bool PluginManager::initializePlugin(const QString &name, const QVariantMap &con
 
 QStringList PluginManager::availablePlugins() const
 {
-    return m_plugins.keys();
+    QStringList names;
+    for (const Candidate &candidate : m_discovered) {
+        if (!candidate.metaData.isEmpty() && !names.contains(candidate.name)) {
+            names.append(candidate.name);
+        }
+    }
+    for (auto it = m_plugins.constBegin(); it != m_plugins.constEnd(); ++it) {
+        if (!names.contains(it.key())) {
+            names.append(it.key());
+        }
+    }
+    return names;
 }
 
 bool PluginManager::isPluginLoaded(const QString &name) const
@@ -201,6 +346,16 @@ QVariantMap PluginManager::getPluginInfo(const QString &name) const
 
     IPlugin *plugin = m_plugins.value(name);
     if (!plugin) {
+        const Candidate *candidate = findDiscovered(name);
+        if (!candidate) {
+            return info;
+        }
+
+        info = PluginCache::pluginData(candidate->metaData).toVariantMap();
+        info["name"] = candidate->name;
+        info["enabled"] = !m_disabledPlugins.contains(name);
+        info["hasSettings"] = info.value("hasSettings", false);
+        info["loaded"] = false;
         return info;
     }
 
@@ -210,10 +365,31 @@ QVariantMap PluginManager::getPluginInfo(const QString &name) const
     info["author"] = plugin->author();
     info["enabled"] = plugin->isEnabled();
     info["hasSettings"] = plugin->hasSettings();
+    info["loaded"] = true;
 
     return info;
 }
 
+void PluginManager::setDisabledPlugins(const QStringList &names)
+{
+    m_disabledPlugins = names;
+}
+
+QStringList PluginManager::disabledPlugins() const
+{
+    return m_disabledPlugins;
+}
+
+void PluginManager::setCachePath(const QString &filePath)
+{
+    m_cache.setFilePath(filePath);
+}
+
+QString PluginManager::cachePath() const
+{
+    return m_cache.filePath();
+}
+
 void PluginManager::cleanup()
 {
     unloadAllPlugins();
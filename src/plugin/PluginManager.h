@@ -6,7 +6,11 @@
 #include <QMap>
 #include <QPluginLoader>
 #include <QDir>
+#include <QJsonObject>
 #include "IPlugin.h"
+#include "PluginCache.h"
+
+class QThreadPool;
 
 class PluginManager : public QObject
 {
@@ -18,10 +22,18 @@ public:
     explicit PluginManager(QObject *parent = nullptr);
     ~PluginManager();
 
+    // Lists the plugins of a directory from their metadata, taken from the
+    // plugin cache when a file is unchanged; no library is opened
+    bool scanPlugins(const QString &pluginDir = QString());
+    // Scans, then loads the plugins that should run on a thread pool and
+    // creates and registers the instances on this thread in file-name order.
+    // Disabled plugins and those whose metadata sets "loadOnStartup": false
+    // stay unloaded until loadPluginByName().
     bool loadPlugins(const QString &pluginDir = QString());
     bool unloadAllPlugins();
 
     bool loadPlugin(const QString &pluginPath);
+    bool loadPluginByName(const QString &name);
     bool unloadPlugin(const QString &pluginName);
 
     QList<IPlugin*> loadedPlugins() const;
@@ -33,8 +45,14 @@ public:
     QStringList availablePlugins() const;
     bool isPluginLoaded(const QString &name) const;
 
+    // Answered from the scanned metadata for plugins that are not loaded
     QVariantMap getPluginInfo(const QString &name) const;
 
+    void setDisabledPlugins(const QStringList &names);
+    QStringList disabledPlugins() const;
+    void setCachePath(const QString &filePath);
+    QString cachePath() const;
+
 signals:
     void pluginLoaded(const QString &name);
     void pluginUnloaded(const QString &name);
@@ -47,6 +65,24 @@ private:
     QMap<QString, IPlugin*> m_plugins;
     QMap<QString, QPluginLoader*> m_loaders;
     QString m_pluginDir;
+    QThreadPool *m_pool;
+    PluginCache m_cache;
+    QStringList m_disabledPlugins;
+
+    struct Candidate {
+        QString path;
+        QString name;
+        QPluginLoader *loader = nullptr;
+        QJsonObject metaData;
+        bool loaded = false;
+    };
+
+    // Result of the last scan, in file-name order
+    QList<Candidate> m_discovered;
 
+    const Candidate *findDiscovered(const QString &name) const;
+    bool shouldLoad(const Candidate &candidate) const;
+    static void loadLibrary(Candidate &candidate);
+    bool registerPlugin(QPluginLoader *loader, const QString &pluginPath, const QString &pluginName);
     void cleanup();
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QUuid>
+#include "models/DataModel.h"
+
+// Compares the columnar DataModel store against the previous row layout
+// (QList<DataItem>) for memory per row and for scans over value/enabled.
+class BenchDataColumns : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void memoryPerRow_data();
+    void memoryPerRow();
+
+    void scanValuesRows_data();
+    void scanValuesRows();
+    void scanValuesColumns_data();
+    void scanValuesColumns();
+
+    void scanEnabledRows_data();
+    void scanEnabledRows();
+    void scanEnabledColumns_data();
+    void scanEnabledColumns();
+
+private:
+    static void addSizes();
+    static DataItem makeItem(int i);
+    static QList<DataItem> makeRows(int count);
+    static DataColumns makeColumns(int count);
+    static qsizetype stringBytes(const QString &text);
+};
+
+void BenchDataColumns::addSizes()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("1e3") << 1000;
+    QTest::newRow("1e5") << 100000;
+    QTest::newRow("1e6") << 1000000;
+}
+
+DataItem BenchDataColumns::makeItem(int i)
+{
+    return {QUuid::createUuid().toString(QUuid::WithoutBraces),
+            QStringLiteral("Item %1").arg(i),
+            QStringLiteral("Generated row for layout benchmarks"),
+            i % 1000,
+            (i % 3) != 0};
+}
+
+QList<DataItem> BenchDataColumns::makeRows(int count)
+{
+    QList<DataItem> rows;
+    rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        rows.append(makeItem(i));
+    }
+    return rows;
+}
+
+DataColumns BenchDataColumns::makeColumns(int count)
+{
+    DataColumns columns;
+    columns.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        columns.append(makeItem(i));
+    }
+    return columns;
+}
+
+qsizetype BenchDataColumns::stringBytes(const QString &text)
+{
+    // Heap block of a detached QString: array header plus UTF-16 payload and terminator.
+    return text.isEmpty() ? 0 : qsizetype(sizeof(QArrayData)) + (text.capacity() + 1) * qsizetype(sizeof(QChar));
+}
+
+void BenchDataColumns::memoryPerRow_data()
+{
+    addSizes();
+}
+
+void BenchDataColumns::memoryPerRow()
+{
+    QFETCH(int, rows);
+
+    const QList<DataItem> rowLayout = makeRows(rows);
+    qsizetype rowBytes = rowLayout.capacity() * qsizetype(sizeof(DataItem));
+    for (const DataItem &item : rowLayout) {
+        rowBytes += stringBytes(item.id) + stringBytes(item.name) + stringBytes(item.description);
+    }
+
+    const DataColumns columns = makeColumns(rows);
+    const qsizetype columnBytes = columns.memoryUsage();
+
+    qInfo("rows=%d  row layout: %.1f B/row  columns: %.1f B/row",
+          rows, double(rowBytes) / rows, double(columnBytes) / rows);
+    QVERIFY(columnBytes < rowBytes);
+}
+
+void BenchDataColumns::scanValuesRows_data()
+{
+    addSizes();
+}
+
+void BenchDataColumns::scanValuesRows()
+{
+    QFETCH(int, rows);
+    const QList<DataItem> rowLayout = makeRows(rows);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        for (const DataItem &item : rowLayout) {
+            sum += item.value;
+        }
+    }
+    QVERIFY(sum >= 0);
+}
+
+void BenchDataColumns::scanValuesColumns_data()
+{
+    addSizes();
+}
+
+void BenchDataColumns::scanValuesColumns()
+{
+    QFETCH(int, rows);
+    const DataColumns columns = makeColumns(rows);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum = columns.sumValues();
+    }
+    QVERIFY(sum >= 0);
+}
+
+void BenchDataColumns::scanEnabledRows_data()
+{
+    addSizes();
+}
+
+void BenchDataColumns::scanEnabledRows()
+{
+    QFETCH(int, rows);
+    const QList<DataItem> rowLayout = makeRows(rows);
+
+    int count = 0;
+    QBENCHMARK {
+        count = 0;
+        for (const DataItem &item : rowLayout) {
+            count += item.enabled ? 1 : 0;
+        }
+    }
+    QVERIFY(count > 0);
+}
+
+void BenchDataColumns::scanEnabledColumns_data()
+{
+    addSizes();
+}
+
+void BenchDataColumns::scanEnabledColumns()
+{
+    QFETCH(int, rows);
+    const DataColumns columns = makeColumns(rows);
+
+    int count = 0;
+    QBENCHMARK {
+        count = columns.enabledCount();
+    }
+    QVERIFY(count > 0);
+}
+
+QTEST_APPLESS_MAIN(BenchDataColumns)
+#include "bench_data_columns.moc"
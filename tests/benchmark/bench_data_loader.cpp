@@ -0,0 +1,72 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "models/DataModel.h"
+#include "models/DataLoader.h"
+
+class BenchDataLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchLoadGenerated_data();
+    void benchLoadGenerated();
+};
+
+namespace {
+// One frame at 60 fps
+constexpr qint64 kFrameNs = 1000000000 / 60;
+}
+
+void BenchDataLoader::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.models.debug=false"));
+}
+
+void BenchDataLoader::benchLoadGenerated_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("1e4") << 10000;
+    QTest::newRow("1e5") << 100000;
+    QTest::newRow("1e6") << 1000000;
+}
+
+void BenchDataLoader::benchLoadGenerated()
+{
+    QFETCH(int, rows);
+
+    QBENCHMARK_ONCE {
+        DataModel model;
+        DataLoader loader(&model);
+        QSignalSpy finishedSpy(&loader, &DataLoader::finished);
+
+        // Stands in for the render loop: the longest gap between two of its
+        // ticks is the longest frame the GUI thread could have missed.
+        QElapsedTimer sinceTick;
+        qint64 longestGap = 0;
+        QTimer frame;
+        frame.setInterval(0);
+        connect(&frame, &QTimer::timeout, &frame, [&sinceTick, &longestGap]() {
+            longestGap = qMax(longestGap, sinceTick.nsecsElapsed());
+            sinceTick.start();
+        });
+
+        sinceTick.start();
+        frame.start();
+        loader.loadGenerated(rows);
+        QVERIFY(finishedSpy.wait(120000));
+        frame.stop();
+
+        QCOMPARE(model.getCount(), rows);
+        QVERIFY(!model.canUndo());
+        QVERIFY2(longestGap < kFrameNs,
+                 qPrintable(QStringLiteral("GUI thread blocked for %1 ms").arg(longestGap / 1e6)));
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchDataLoader)
+#include "bench_data_loader.moc"
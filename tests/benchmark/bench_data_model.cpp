@@ -0,0 +1,135 @@
+#include <QtTest>
+#include <QLoggingCategory>
+#include "models/DataModel.h"
+
+class BenchDataModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchLookup_data();
+    void benchLookup();
+    void benchUpdateValue_data();
+    void benchUpdateValue();
+    void benchRemoveAndLookup_data();
+    void benchRemoveAndLookup();
+    void benchFrontRemoveAndLookup_data();
+    void benchFrontRemoveAndLookup();
+
+private:
+    static void addSizes();
+    static QStringList fill(DataModel &model, int count);
+};
+
+void BenchDataModel::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.models.debug=false"));
+}
+
+void BenchDataModel::addSizes()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("1e3") << 1000;
+    QTest::newRow("1e4") << 10000;
+    QTest::newRow("1e5") << 100000;
+    QTest::newRow("1e6") << 1000000;
+}
+
+QStringList BenchDataModel::fill(DataModel &model, int count)
+{
+    QStringList ids;
+    ids.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        model.addItem(QStringLiteral("Item"), QStringLiteral("Benchmark"), i);
+        ids.append(model.getItem(i)["id"].toString());
+    }
+    return ids;
+}
+
+void BenchDataModel::benchLookup_data()
+{
+    addSizes();
+}
+
+void BenchDataModel::benchLookup()
+{
+    QFETCH(int, rows);
+    DataModel model;
+    const QStringList ids = fill(model, rows);
+
+    int probe = 0;
+    QBENCHMARK {
+        // Stride through the ids so each iteration hits a different row.
+        probe = (probe + 7919) % rows;
+        QVERIFY(model.rowOf(ids[probe]) == probe);
+    }
+}
+
+void BenchDataModel::benchUpdateValue_data()
+{
+    addSizes();
+}
+
+void BenchDataModel::benchUpdateValue()
+{
+    QFETCH(int, rows);
+    DataModel model;
+    const QStringList ids = fill(model, rows);
+
+    int probe = 0;
+    QBENCHMARK {
+        probe = (probe + 7919) % rows;
+        model.updateItemValue(ids[probe], probe);
+    }
+}
+
+void BenchDataModel::benchRemoveAndLookup_data()
+{
+    addSizes();
+}
+
+void BenchDataModel::benchRemoveAndLookup()
+{
+    QFETCH(int, rows);
+    DataModel model;
+    const QStringList ids = fill(model, rows);
+
+    // Removing from the tail keeps every index entry valid; lookups after it
+    // must not trigger a repair.
+    int next = rows - 1;
+    QBENCHMARK {
+        if (next > rows / 2) {
+            model.removeItem(ids[next--]);
+        }
+        QVERIFY(model.rowOf(ids[0]) == 0);
+    }
+}
+
+void BenchDataModel::benchFrontRemoveAndLookup_data()
+{
+    addSizes();
+}
+
+void BenchDataModel::benchFrontRemoveAndLookup()
+{
+    QFETCH(int, rows);
+    DataModel model;
+    const QStringList ids = fill(model, rows);
+
+    // Every front removal shifts all remaining rows; the lookup that follows
+    // must not pay for re-indexing them.
+    int front = 0;
+    int probe = 0;
+    QBENCHMARK {
+        if (front < rows / 2) {
+            model.removeItem(ids[front++]);
+        }
+        probe = (probe + 7919) % (rows - front);
+        QVERIFY(model.rowOf(ids[front + probe]) == probe);
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchDataModel)
+#include "bench_data_model.moc"
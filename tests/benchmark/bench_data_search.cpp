@@ -0,0 +1,113 @@
+#include <QtTest>
+#include <QLoggingCategory>
+#include "models/DataSearchIndex.h"
+
+// Query latency of DataSearchIndex against a linear case-insensitive scan at 10^6 rows.
+class BenchDataSearch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void search_data();
+    void search();
+    void linearScan_data();
+    void linearScan();
+
+private:
+    static constexpr int kRows = 1000000;
+    DataModel *m_model = nullptr;
+    DataSearchIndex *m_index = nullptr;
+
+    static void addQueries();
+};
+
+void BenchDataSearch::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.models.debug=false"));
+
+    static const char *const words[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot",
+                                        "golf", "hotel", "india", "juliett", "kilo", "lima"};
+    QList<DataItem> items;
+    items.reserve(kRows);
+    quint32 seed = 42;
+    for (int i = 0; i < kRows; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        items.append({QString(),
+                      QStringLiteral("%1 %2 %3").arg(QLatin1String(words[seed % 12]),
+                                                     QLatin1String(words[(seed >> 8) % 12]))
+                                                .arg(seed % 100000),
+                      QLatin1String(words[(seed >> 16) % 12]),
+                      int(seed % 1000),
+                      true});
+    }
+
+    m_model = new DataModel();
+    m_model->appendItems(items);
+    m_index = new DataSearchIndex(m_model);
+}
+
+void BenchDataSearch::cleanupTestCase()
+{
+    delete m_index;
+    delete m_model;
+}
+
+void BenchDataSearch::addQueries()
+{
+    QTest::addColumn<QString>("query");
+    QTest::newRow("rare number") << QStringLiteral("54321");
+    QTest::newRow("two terms") << QStringLiteral("kilo 4321");
+    QTest::newRow("short prefix and term") << QStringLiteral("ju 9876");
+}
+
+void BenchDataSearch::search_data()
+{
+    addQueries();
+}
+
+void BenchDataSearch::search()
+{
+    QFETCH(QString, query);
+    QList<int> rows;
+    QBENCHMARK {
+        rows = m_index->search(query);
+    }
+    QVERIFY(rows.size() < kRows);
+}
+
+void BenchDataSearch::linearScan_data()
+{
+    addQueries();
+}
+
+void BenchDataSearch::linearScan()
+{
+    QFETCH(QString, query);
+    const QStringList terms = query.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    const DataColumns &columns = m_model->columns();
+
+    QList<int> rows;
+    QBENCHMARK {
+        rows.clear();
+        for (int row = 0; row < columns.size(); ++row) {
+            bool matches = true;
+            for (const QString &term : terms) {
+                if (!columns.nameView(row).contains(term, Qt::CaseInsensitive)
+                    && !columns.descriptionView(row).contains(term, Qt::CaseInsensitive)) {
+                    matches = false;
+                    break;
+                }
+            }
+            if (matches) {
+                rows.append(row);
+            }
+        }
+    }
+    QVERIFY(rows.size() < kRows);
+}
+
+QTEST_APPLESS_MAIN(BenchDataSearch)
+#include "bench_data_search.moc"
@@ -0,0 +1,109 @@
+#include <QtTest>
+#include "services/DataService.h"
+#include "models/DataModel.h"
+
+// Thread scaling of DataService's bulk queries over 500k rows.
+class BenchDataService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void filterRows_data();
+    void filterRows();
+    void sortRowsByName_data();
+    void sortRowsByName();
+    void sortRowsByValue_data();
+    void sortRowsByValue();
+
+private:
+    static constexpr int kRows = 500000;
+    DataColumns m_columns;
+    QList<int> m_allRows;
+
+    static void addThreadCounts();
+};
+
+void BenchDataService::initTestCase()
+{
+    static const char *const words[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel"};
+    m_columns.reserve(kRows);
+    m_allRows.reserve(kRows);
+    quint32 seed = 12345;
+    for (int i = 0; i < kRows; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const QString name = QStringLiteral("%1 %2").arg(QLatin1String(words[seed % 8])).arg(seed % 100000);
+        m_columns.append({QString::number(i), name, QLatin1String(words[(seed >> 8) % 8]), int(seed % 1000), true});
+        m_allRows.append(i);
+    }
+}
+
+void BenchDataService::addThreadCounts()
+{
+    QTest::addColumn<int>("threads");
+    for (int threads : {1, 2, 4, 8, 16}) {
+        QTest::newRow(qPrintable(QStringLiteral("%1 threads").arg(threads))) << threads;
+    }
+}
+
+void BenchDataService::filterRows_data()
+{
+    addThreadCounts();
+}
+
+void BenchDataService::filterRows()
+{
+    QFETCH(int, threads);
+    DataService service;
+    service.setMaxThreads(threads);
+
+    QList<int> rows;
+    QBENCHMARK {
+        rows = service.filterRows(m_columns, QStringLiteral("ECHO"));
+    }
+    QVERIFY(!rows.isEmpty());
+    QVERIFY(std::is_sorted(rows.cbegin(), rows.cend()));
+}
+
+void BenchDataService::sortRowsByName_data()
+{
+    addThreadCounts();
+}
+
+void BenchDataService::sortRowsByName()
+{
+    QFETCH(int, threads);
+    DataService service;
+    service.setMaxThreads(threads);
+
+    QList<int> rows;
+    QBENCHMARK {
+        rows = service.sortRows(m_columns, m_allRows, DataService::SortByName);
+    }
+    QCOMPARE(rows.size(), kRows);
+}
+
+void BenchDataService::sortRowsByValue_data()
+{
+    addThreadCounts();
+}
+
+void BenchDataService::sortRowsByValue()
+{
+    QFETCH(int, threads);
+    DataService service;
+    service.setMaxThreads(threads);
+
+    QList<int> rows;
+    QBENCHMARK {
+        rows = service.sortRows(m_columns, m_allRows, DataService::SortByValue, false);
+    }
+    QCOMPARE(rows.size(), kRows);
+    for (int i = 1; i < rows.size(); ++i) {
+        QVERIFY(m_columns.value(rows[i - 1]) >= m_columns.value(rows[i]));
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchDataService)
+#include "bench_data_service.moc"
@@ -0,0 +1,54 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "models/DataModel.h"
+
+// Save and restart cost of a million-row model.
+class BenchDataSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void save();
+    void load();
+
+private:
+    static constexpr int kRows = 1000000;
+    QTemporaryDir m_dir;
+    DataModel m_model;
+
+    QString snapshotPath() const { return m_dir.filePath("bench.dms"); }
+};
+
+void BenchDataSnapshot::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    static const char *const words[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel"};
+    QList<DataItem> items;
+    items.reserve(kRows);
+    for (int i = 0; i < kRows; ++i) {
+        items.append({QString(), QStringLiteral("%1 %2").arg(QLatin1String(words[i % 8])).arg(i % 5000),
+                      QLatin1String(words[(i / 8) % 8]), i % 1000, i % 3 != 0});
+    }
+    m_model.appendItems(items);
+    QVERIFY(m_model.saveSnapshot(snapshotPath()));
+}
+
+void BenchDataSnapshot::save()
+{
+    QBENCHMARK {
+        QVERIFY(m_model.saveSnapshot(snapshotPath()));
+    }
+}
+
+void BenchDataSnapshot::load()
+{
+    DataModel restored;
+    QBENCHMARK {
+        QVERIFY(restored.loadSnapshot(snapshotPath()));
+    }
+    QCOMPARE(restored.getCount(), kRows);
+}
+
+QTEST_GUILESS_MAIN(BenchDataSnapshot)
+#include "bench_data_snapshot.moc"
@@ -0,0 +1,45 @@
+#include <QtTest>
+#include "services/IdGenerator.h"
+
+// Id generation cost with a million ids already claimed.
+class BenchIdGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void nextId_data();
+    void nextId();
+};
+
+void BenchIdGenerator::nextId_data()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::addColumn<int>("existing");
+    for (int existing : {0, 1000000}) {
+        QTest::newRow(qPrintable(QStringLiteral("counter/%1").arg(existing))) << int(IdGenerator::Counter) << existing;
+        QTest::newRow(qPrintable(QStringLiteral("snowflake/%1").arg(existing))) << int(IdGenerator::Snowflake) << existing;
+        QTest::newRow(qPrintable(QStringLiteral("random64/%1").arg(existing))) << int(IdGenerator::Random64) << existing;
+    }
+}
+
+void BenchIdGenerator::nextId()
+{
+    QFETCH(int, strategy);
+    QFETCH(int, existing);
+
+    IdGenerator generator(IdGenerator::Strategy(strategy));
+    for (int i = 0; i < existing; ++i) {
+        generator.next();
+    }
+
+    QString id;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            id = generator.nextId();
+        }
+    }
+    QVERIFY(generator.isTaken(id));
+}
+
+QTEST_GUILESS_MAIN(BenchIdGenerator)
+#include "bench_id_generator.moc"
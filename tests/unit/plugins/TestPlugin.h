@@ -0,0 +1,25 @@
+#pragma once
+
+#include "IPlugin.h"
+
+// Minimal IPlugin for the plugin manager tests; each library names itself.
+class TestPlugin : public IPlugin
+{
+public:
+    explicit TestPlugin(const QString &name) : m_name(name) {}
+
+    QString name() const override { return m_name; }
+    QString version() const override { return QStringLiteral("1.0.0"); }
+    QString description() const override { return QStringLiteral("Loaded test plugin"); }
+    QString author() const override { return QStringLiteral("Tests"); }
+
+    bool initialize(const QVariantMap &config) override
+    {
+        Q_UNUSED(config)
+        return true;
+    }
+    void shutdown() override {}
+
+private:
+    QString m_name;
+};
@@ -0,0 +1,12 @@
+#include "TestPlugin.h"
+
+class AlphaPlugin : public TestPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "com.template.testplugin" FILE "alpha.json")
+
+public:
+    AlphaPlugin() : TestPlugin(QStringLiteral("Alpha")) {}
+};
+
+#include "alpha_plugin.moc"
@@ -0,0 +1,12 @@
+#include "TestPlugin.h"
+
+class BetaPlugin : public TestPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "com.template.testplugin" FILE "beta.json")
+
+public:
+    BetaPlugin() : TestPlugin(QStringLiteral("Beta")) {}
+};
+
+#include "beta_plugin.moc"
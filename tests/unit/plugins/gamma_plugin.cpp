@@ -0,0 +1,12 @@
+#include "TestPlugin.h"
+
+class GammaPlugin : public TestPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "com.template.testplugin" FILE "gamma.json")
+
+public:
+    GammaPlugin() : TestPlugin(QStringLiteral("GammaRuntime")) {}
+};
+
+#include "gamma_plugin.moc"
@@ -0,0 +1,12 @@
+#include "TestPlugin.h"
+
+class LazyPlugin : public TestPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "com.template.testplugin" FILE "lazy.json")
+
+public:
+    LazyPlugin() : TestPlugin(QStringLiteral("Lazy")) {}
+};
+
+#include "lazy_plugin.moc"
@@ -0,0 +1,264 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include "models/DataModel.h"
+#include "models/DataAggregates.h"
+
+class TestDataAggregates : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testEmpty();
+    void testAddAndRemove();
+    void testValueAndEnabledChanges();
+    void testMinMaxAfterRemovingExtremes();
+    void testHistogram();
+    void testHistogramLayout();
+    void testBatchAndUndo();
+    void testClearAndSnapshot();
+    void testChangedSignal();
+    void testMatchesRescan();
+
+private:
+    DataModel *m_model = nullptr;
+
+    void addValues(const QList<int> &values);
+    void verifyAgainstScan();
+};
+
+void TestDataAggregates::init()
+{
+    m_model = new DataModel();
+}
+
+void TestDataAggregates::cleanup()
+{
+    delete m_model;
+}
+
+void TestDataAggregates::addValues(const QList<int> &values)
+{
+    QVariantList items;
+    for (int value : values) {
+        items.append(QVariantMap{{"name", QString::number(value)}, {"value", value}});
+    }
+    m_model->addItems(items);
+}
+
+void TestDataAggregates::verifyAgainstScan()
+{
+    const DataColumns &columns = m_model->columns();
+    const int rows = m_model->getCount();
+    qint64 sum = 0;
+    qint64 enabledSum = 0;
+    int enabledCount = 0;
+    int minimum = 0, maximum = 0, enabledMinimum = 0, enabledMaximum = 0;
+    for (int row = 0; row < rows; ++row) {
+        const int value = columns.value(row);
+        minimum = row == 0 ? value : qMin(minimum, value);
+        maximum = row == 0 ? value : qMax(maximum, value);
+        sum += value;
+        if (columns.enabled(row)) {
+            enabledMinimum = enabledCount == 0 ? value : qMin(enabledMinimum, value);
+            enabledMaximum = enabledCount == 0 ? value : qMax(enabledMaximum, value);
+            enabledSum += value;
+            ++enabledCount;
+        }
+    }
+
+    DataAggregates *aggregates = m_model->aggregates();
+    QCOMPARE(aggregates->count(), rows);
+    QCOMPARE(aggregates->sum(), sum);
+    QCOMPARE(aggregates->minimum(), minimum);
+    QCOMPARE(aggregates->maximum(), maximum);
+    QCOMPARE(aggregates->enabledCount(), enabledCount);
+    QCOMPARE(aggregates->enabledSum(), enabledSum);
+    QCOMPARE(aggregates->enabledMinimum(), enabledMinimum);
+    QCOMPARE(aggregates->enabledMaximum(), enabledMaximum);
+}
+
+void TestDataAggregates::testEmpty()
+{
+    DataAggregates *aggregates = m_model->aggregates();
+    QCOMPARE(aggregates->count(), 0);
+    QCOMPARE(aggregates->sum(), 0);
+    QCOMPARE(aggregates->minimum(), 0);
+    QCOMPARE(aggregates->maximum(), 0);
+    QCOMPARE(aggregates->average(), 0.0);
+    QCOMPARE(aggregates->histogram().size(), aggregates->bucketCount());
+}
+
+void TestDataAggregates::testAddAndRemove()
+{
+    addValues({10, 20, 30});
+    DataAggregates *aggregates = m_model->aggregates();
+    QCOMPARE(aggregates->count(), 3);
+    QCOMPARE(aggregates->sum(), 60);
+    QCOMPARE(aggregates->average(), 20.0);
+
+    // Created before the next mutations: kept current from the signals
+    m_model->addItem("forty", "", 40);
+    m_model->removeItem(m_model->getItem(0).value("id").toString());
+    QCOMPARE(aggregates->count(), 3);
+    QCOMPARE(aggregates->sum(), 90);
+    QCOMPARE(aggregates->minimum(), 20);
+    QCOMPARE(aggregates->maximum(), 40);
+    verifyAgainstScan();
+}
+
+void TestDataAggregates::testValueAndEnabledChanges()
+{
+    addValues({5, 15, 25});
+    DataAggregates *aggregates = m_model->aggregates();
+    const QString first = m_model->getItem(0).value("id").toString();
+    const QString last = m_model->getItem(2).value("id").toString();
+
+    m_model->updateItemValue(first, 50);
+    QCOMPARE(aggregates->sum(), 90);
+    QCOMPARE(aggregates->maximum(), 50);
+
+    m_model->setItemEnabled(first, false);
+    QCOMPARE(aggregates->count(), 3);
+    QCOMPARE(aggregates->enabledCount(), 2);
+    QCOMPARE(aggregates->enabledSum(), 40);
+    QCOMPARE(aggregates->enabledMaximum(), 25);
+    QCOMPARE(aggregates->maximum(), 50);
+
+    m_model->updateValues({{last, 1}});
+    QCOMPARE(aggregates->enabledMinimum(), 1);
+    verifyAgainstScan();
+}
+
+void TestDataAggregates::testMinMaxAfterRemovingExtremes()
+{
+    addValues({7, 3, 3, 9});
+    DataAggregates *aggregates = m_model->aggregates();
+    QCOMPARE(aggregates->minimum(), 3);
+
+    // One of the two 3s goes: the minimum must stay
+    m_model->removeItem(m_model->getItem(1).value("id").toString());
+    QCOMPARE(aggregates->minimum(), 3);
+    m_model->removeItem(m_model->getItem(1).value("id").toString());
+    QCOMPARE(aggregates->minimum(), 7);
+    m_model->removeItem(m_model->getItem(1).value("id").toString());
+    QCOMPARE(aggregates->maximum(), 7);
+}
+
+void TestDataAggregates::testHistogram()
+{
+    DataAggregates *aggregates = m_model->aggregates();
+    aggregates->setHistogramLayout(0, 10, 3);
+    addValues({-5, 0, 9, 10, 25, 100});
+
+    QCOMPARE(aggregates->histogram(), (QVariantList{3, 1, 2}));
+    m_model->setItemEnabled(m_model->getItem(5).value("id").toString(), false);
+    QCOMPARE(aggregates->enabledHistogram(), (QVariantList{3, 1, 1}));
+    QCOMPARE(aggregates->histogram(), (QVariantList{3, 1, 2}));
+}
+
+void TestDataAggregates::testHistogramLayout()
+{
+    addValues({1, 11, 21, 31});
+    DataAggregates *aggregates = m_model->aggregates();
+    aggregates->setHistogramLayout(0, 20, 2);
+    QCOMPARE(aggregates->histogram(), (QVariantList{2, 2}));
+
+    // Invalid layouts are ignored
+    aggregates->setHistogramLayout(0, 0, 4);
+    QCOMPARE(aggregates->bucketWidth(), 20);
+    QCOMPARE(aggregates->bucketCount(), 2);
+}
+
+void TestDataAggregates::testBatchAndUndo()
+{
+    DataAggregates *aggregates = m_model->aggregates();
+    m_model->beginBatch();
+    addValues({1, 2, 3});
+    m_model->updateItemValue(m_model->columns().id(0), 100);
+    // Rows stay hidden until the batch ends
+    QCOMPARE(aggregates->count(), 0);
+    m_model->endBatch();
+    QCOMPARE(aggregates->sum(), 105);
+
+    m_model->removeItem(m_model->columns().id(1));
+    QCOMPARE(aggregates->sum(), 103);
+    QVERIFY(m_model->undo());
+    QCOMPARE(aggregates->sum(), 105);
+    verifyAgainstScan();
+}
+
+void TestDataAggregates::testClearAndSnapshot()
+{
+    addValues({4, 8});
+    DataAggregates *aggregates = m_model->aggregates();
+    QTemporaryDir dir;
+    const QString path = dir.filePath("aggregates.dms");
+    QVERIFY(m_model->saveSnapshot(path));
+
+    m_model->clear();
+    QCOMPARE(aggregates->count(), 0);
+    QCOMPARE(aggregates->sum(), 0);
+
+    QVERIFY(m_model->loadSnapshot(path));
+    QCOMPARE(aggregates->count(), 2);
+    QCOMPARE(aggregates->sum(), 12);
+    verifyAgainstScan();
+}
+
+void TestDataAggregates::testChangedSignal()
+{
+    addValues({1, 2});
+    DataAggregates *aggregates = m_model->aggregates();
+    QSignalSpy spy(aggregates, &DataAggregates::changed);
+
+    m_model->addItem("three", "", 3);
+    QCOMPARE(spy.count(), 1);
+
+    // Rewriting a value with itself changes nothing
+    const QString id = m_model->columns().id(0);
+    m_model->updateItemValue(id, 1);
+    QCOMPARE(spy.count(), 1);
+
+    m_model->updateItemValue(id, 10);
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestDataAggregates::testMatchesRescan()
+{
+    QRandomGenerator random(48);
+    m_model->aggregates();
+    addValues({0});
+    for (int step = 0; step < 2000; ++step) {
+        const int rows = m_model->getCount();
+        const QString id = rows > 0 ? m_model->columns().id(random.bounded(rows)) : QString();
+        switch (random.bounded(4)) {
+        case 0:
+            m_model->addItem("item", "", random.bounded(-50, 50));
+            break;
+        case 1:
+            if (!id.isEmpty()) {
+                m_model->removeItem(id);
+            }
+            break;
+        case 2:
+            if (!id.isEmpty()) {
+                m_model->updateItemValue(id, random.bounded(-50, 50));
+            }
+            break;
+        default:
+            if (!id.isEmpty()) {
+                m_model->setItemEnabled(id, random.bounded(2) == 0);
+            }
+            break;
+        }
+    }
+    verifyAgainstScan();
+}
+
+QTEST_GUILESS_MAIN(TestDataAggregates)
+#include "test_data_aggregates.moc"
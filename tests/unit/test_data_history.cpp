@@ -0,0 +1,292 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include "models/DataModel.h"
+
+class TestDataHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testUndoRedoAdd();
+    void testUndoRemoveRestoresPosition();
+    void testUndoRedoInsert();
+    void testValueEditsMerge();
+    void testEditsOfOtherItemsDoNotMerge();
+    void testNewEditClearsRedo();
+    void testBatchIsOneStep();
+    void testBulkUndoSignals();
+    void testUndoClear();
+    void testClearOverMemoryLimit();
+    void testMemoryLimit();
+    void testCanUndoNotifies();
+
+private:
+    DataModel *m_model = nullptr;
+
+    QStringList names() const;
+    void addNumbered(int count);
+};
+
+void TestDataHistory::init()
+{
+    m_model = new DataModel();
+    m_model->history().setMergeInterval(-1);
+}
+
+void TestDataHistory::cleanup()
+{
+    delete m_model;
+}
+
+QStringList TestDataHistory::names() const
+{
+    QStringList result;
+    for (int row = 0; row < m_model->getCount(); ++row) {
+        result.append(m_model->columns().name(row));
+    }
+    return result;
+}
+
+void TestDataHistory::addNumbered(int count)
+{
+    QVariantList items;
+    for (int i = 0; i < count; ++i) {
+        items.append(QVariantMap{{"name", QString::number(i)}, {"value", i}});
+    }
+    m_model->addItems(items);
+}
+
+void TestDataHistory::testUndoRedoAdd()
+{
+    m_model->addItem("Alpha", "", 1);
+    const QString id = m_model->columns().id(0);
+    QVERIFY(m_model->canUndo());
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(m_model->getCount(), 0);
+    QVERIFY(m_model->canRedo());
+
+    QVERIFY(m_model->redo());
+    QCOMPARE(m_model->getCount(), 1);
+    QCOMPARE(m_model->columns().id(0), id);
+    QVERIFY(!m_model->redo());
+}
+
+void TestDataHistory::testUndoRedoInsert()
+{
+    addNumbered(3);
+    QCOMPARE(m_model->insertItems(1, {{QString(), "a", "", 0, true}, {QString(), "b", "", 0, true}}), 2);
+    const QStringList inserted = names();
+    QCOMPARE(inserted, (QStringList{"0", "a", "b", "1", "2"}));
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(names(), (QStringList{"0", "1", "2"}));
+
+    // Redo puts them back where they were, not at the end
+    QVERIFY(m_model->redo());
+    QCOMPARE(names(), inserted);
+}
+
+void TestDataHistory::testUndoRemoveRestoresPosition()
+{
+    addNumbered(5);
+    const QString id = m_model->columns().id(2);
+    m_model->setItemEnabled(id, false);
+    m_model->removeItem(id);
+    QCOMPARE(names(), QStringList({"0", "1", "3", "4"}));
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(names(), QStringList({"0", "1", "2", "3", "4"}));
+    QCOMPARE(m_model->rowOf(id), 2);
+    QVERIFY(!m_model->columns().enabled(2));
+    QVERIFY(m_model->columns().enabled(3));
+}
+
+void TestDataHistory::testValueEditsMerge()
+{
+    m_model->addItem("Slider", "", 10);
+    const QString id = m_model->columns().id(0);
+    for (int value = 11; value <= 20; ++value) {
+        m_model->updateItemValue(id, value);
+    }
+    QCOMPARE(m_model->history().undoCount(), 2);
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(m_model->columns().value(0), 10);
+    QVERIFY(m_model->redo());
+    QCOMPARE(m_model->columns().value(0), 20);
+}
+
+void TestDataHistory::testEditsOfOtherItemsDoNotMerge()
+{
+    addNumbered(2);
+    m_model->updateItemValue(m_model->columns().id(0), 100);
+    m_model->updateItemValue(m_model->columns().id(1), 200);
+    m_model->updateItemValue(m_model->columns().id(0), 300);
+    QCOMPARE(m_model->history().undoCount(), 4);
+
+    m_model->history().setMergeInterval(0);
+    QTest::qWait(5);
+    m_model->updateItemValue(m_model->columns().id(0), 400);
+    QCOMPARE(m_model->history().undoCount(), 5);
+}
+
+void TestDataHistory::testNewEditClearsRedo()
+{
+    addNumbered(3);
+    m_model->removeItem(m_model->columns().id(0));
+    QVERIFY(m_model->undo());
+    QVERIFY(m_model->canRedo());
+
+    m_model->addItem("New", "", 0);
+    QVERIFY(!m_model->canRedo());
+}
+
+void TestDataHistory::testBatchIsOneStep()
+{
+    addNumbered(3);
+    const QStringList before = names();
+
+    m_model->beginBatch();
+    m_model->addItem("Batch A", "", 1);
+    m_model->removeItem(m_model->columns().id(0));
+    m_model->updateItemValue(m_model->columns().id(1), 99);
+    m_model->endBatch();
+    QCOMPARE(m_model->history().undoCount(), 2);
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(names(), before);
+    QCOMPARE(m_model->columns().value(1), 1);
+}
+
+void TestDataHistory::testBulkUndoSignals()
+{
+    addNumbered(100);
+
+    // 50 scattered rows: one signal per row each way, and no reset
+    QStringList everyOther;
+    for (int row = 0; row < 100; row += 2) {
+        everyOther.append(m_model->columns().id(row));
+    }
+    {
+        QSignalSpy removeSpy(m_model, &DataModel::rowsRemoved);
+        QSignalSpy resetSpy(m_model, &DataModel::modelReset);
+        m_model->removeItems(everyOther);
+        QCOMPARE(removeSpy.count(), 50);
+        QCOMPARE(resetSpy.count(), 0);
+        // Back to front
+        QCOMPARE(removeSpy.first()[1].toInt(), 98);
+        QCOMPARE(removeSpy.last()[1].toInt(), 0);
+    }
+    {
+        QSignalSpy insertSpy(m_model, &DataModel::rowsInserted);
+        QSignalSpy resetSpy(m_model, &DataModel::modelReset);
+        QVERIFY(m_model->undo());
+        QCOMPARE(insertSpy.count(), 50);
+        QCOMPARE(resetSpy.count(), 0);
+        QCOMPARE(insertSpy.first()[1].toInt(), 0);
+        QCOMPARE(insertSpy.last()[1].toInt(), 98);
+        QCOMPARE(m_model->getCount(), 100);
+        for (int row = 0; row < 100; ++row) {
+            QCOMPARE(m_model->columns().name(row), QString::number(row));
+        }
+    }
+
+    // A contiguous run comes back as one insert
+    QStringList run;
+    for (int row = 10; row < 30; ++row) {
+        run.append(m_model->columns().id(row));
+    }
+    m_model->removeItems(run);
+    {
+        QSignalSpy insertSpy(m_model, &DataModel::rowsInserted);
+        QVERIFY(m_model->undo());
+        QCOMPARE(insertSpy.count(), 1);
+        QCOMPARE(insertSpy[0][1].toInt(), 10);
+        QCOMPARE(insertSpy[0][2].toInt(), 29);
+    }
+
+    // Value edits are undone with one dataChanged per run of rows, never
+    // spanning rows that did not change
+    QVariantMap values;
+    for (int row = 0; row < 100; row += 3) {
+        values.insert(m_model->columns().id(row), -row);
+    }
+    for (int row = 50; row <= 58; ++row) {
+        values.insert(m_model->columns().id(row), -row);
+    }
+    m_model->updateValues(values);
+    {
+        QSignalSpy changedSpy(m_model, &DataModel::dataChanged);
+        QVERIFY(m_model->undo());
+        // 34 rows every third one, of which 51, 54 and 57 fall inside the run 50..58
+        QCOMPARE(changedSpy.count(), 34 - 3 + 1);
+        for (const QList<QVariant> &arguments : std::as_const(changedSpy)) {
+            const int first = arguments[0].toModelIndex().row();
+            const int last = arguments[1].toModelIndex().row();
+            QVERIFY(first == last || (first == 50 && last == 58));
+        }
+        QCOMPARE(m_model->columns().value(99), 99);
+        QCOMPARE(m_model->columns().value(55), 55);
+    }
+}
+
+void TestDataHistory::testUndoClear()
+{
+    addNumbered(10);
+    m_model->clear();
+    QCOMPARE(m_model->getCount(), 0);
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(m_model->getCount(), 10);
+    QCOMPARE(m_model->columns().name(9), QStringLiteral("9"));
+}
+
+void TestDataHistory::testClearOverMemoryLimit()
+{
+    addNumbered(1000);
+    m_model->history().setMemoryLimit(16 * 1024);
+    m_model->updateItemValue(m_model->columns().id(0), 42);
+    QCOMPARE(m_model->history().undoCount(), 1);
+
+    // The rows would not fit: the clear is not undoable and older steps go with it
+    QSignalSpy historySpy(m_model, &DataModel::historyChanged);
+    m_model->clear();
+    QCOMPARE(m_model->getCount(), 0);
+    QVERIFY(!m_model->canUndo());
+    QCOMPARE(m_model->history().memoryUsage(), 0);
+    QCOMPARE(historySpy.count(), 1);
+}
+
+void TestDataHistory::testMemoryLimit()
+{
+    m_model->history().setMemoryLimit(4096);
+    for (int i = 0; i < 200; ++i) {
+        m_model->addItem(QStringLiteral("Item %1").arg(i), QStringLiteral("Description"), i);
+    }
+    QVERIFY(m_model->history().memoryUsage() <= 4096);
+    QVERIFY(m_model->history().undoCount() > 0);
+    QVERIFY(m_model->history().undoCount() < 200);
+
+    // The newest steps survive
+    QVERIFY(m_model->undo());
+    QCOMPARE(m_model->getCount(), 199);
+}
+
+void TestDataHistory::testCanUndoNotifies()
+{
+    QSignalSpy historySpy(m_model, &DataModel::historyChanged);
+    m_model->addItem("One", "", 1);
+    QCOMPARE(historySpy.count(), 1);
+    m_model->addItem("Two", "", 2);
+    QCOMPARE(historySpy.count(), 1);
+    m_model->clearHistory();
+    QCOMPARE(historySpy.count(), 2);
+    QVERIFY(!m_model->canUndo());
+}
+
+QTEST_GUILESS_MAIN(TestDataHistory)
+#include "test_data_history.moc"
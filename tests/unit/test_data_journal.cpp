@@ -0,0 +1,260 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QSemaphore>
+#include "models/DataModel.h"
+#include "models/DataJournal.h"
+
+class TestDataJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testReplay();
+    void testBatchesAndResets();
+    void testStructuralChanges();
+    void testTornTail();
+    void testCompaction();
+    void testReplayAfterInterruptedCompaction();
+    void testCompactionWhileGroupInFlight();
+    void testRejectsForeignFile();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+
+    QString basePath() const;
+    static QList<QJsonObject> contents(const DataModel &model);
+    static void makeEdits(DataModel &model);
+    static QList<QJsonObject> reopened(const QString &basePath, int *replayed = nullptr);
+};
+
+void TestDataJournal::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void TestDataJournal::cleanup()
+{
+    delete m_dir;
+}
+
+QString TestDataJournal::basePath() const
+{
+    return m_dir->filePath("store");
+}
+
+QList<QJsonObject> TestDataJournal::contents(const DataModel &model)
+{
+    QList<QJsonObject> items;
+    for (int row = 0; row < model.getCount(); ++row) {
+        items.append(model.getItem(row));
+    }
+    return items;
+}
+
+void TestDataJournal::makeEdits(DataModel &model)
+{
+    model.addItem("Alpha", "First", 1);
+    model.addItem("Beta", "Second", 2);
+    model.addItem("Gamma", "Third", 3);
+    const QString alpha = model.columns().id(0);
+    const QString beta = model.columns().id(1);
+    model.updateItemValue(alpha, 10);
+    model.setItemEnabled(beta, false);
+    model.removeItem(model.columns().id(2));
+    model.addItem("Delta", "Fourth", 4);
+}
+
+QList<QJsonObject> TestDataJournal::reopened(const QString &basePath, int *replayed)
+{
+    DataModel model;
+    DataJournal journal(&model);
+    if (!journal.open(basePath)) {
+        return {};
+    }
+    if (replayed) {
+        *replayed = journal.replayedCount();
+    }
+    return contents(model);
+}
+
+void TestDataJournal::testReplay()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(journal.open(basePath()));
+    makeEdits(model);
+    journal.flush();
+
+    int replayed = 0;
+    QCOMPARE(reopened(basePath(), &replayed), contents(model));
+    QCOMPARE(replayed, 7);
+    QCOMPARE(model.getCount(), 3);
+}
+
+void TestDataJournal::testBatchesAndResets()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(journal.open(basePath()));
+    makeEdits(model);
+    model.clear();
+
+    model.beginBatch();
+    model.addItems({QVariantMap{{"name", "One"}, {"value", 1}}, QVariantMap{{"name", "Two"}, {"value", 2}}});
+    model.updateValues({{model.columns().id(0), 100}});
+    model.endBatch();
+    journal.flush();
+
+    QCOMPARE(reopened(basePath()), contents(model));
+    QCOMPARE(model.columns().value(0), 100);
+}
+
+void TestDataJournal::testStructuralChanges()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(journal.open(basePath()));
+    QVariantList items;
+    for (int i = 0; i < 100; ++i) {
+        items.append(QVariantMap{{"name", QString::number(i)}, {"value", i}});
+    }
+    model.addItems(items);
+
+    // Scattered removes and their undo log the rows they touch, not a dump
+    QStringList everyOther;
+    for (int row = 0; row < 100; row += 2) {
+        everyOther.append(model.columns().id(row));
+    }
+    QCOMPARE(model.removeItems(everyOther), 50);
+    QVERIFY(model.undo());
+
+    // Inserts before the end come back at the same rows
+    model.insertItems(10, {{QString(), "Inserted", "", 7, true}, {QString(), "Also inserted", "", 8, true}});
+    model.insertItems(0, {{QString(), "First", "", 9, false}});
+    journal.flush();
+
+    int replayed = 0;
+    QCOMPARE(reopened(basePath(), &replayed), contents(model));
+    QCOMPARE(replayed, 100 + 50 + 50 + 3);
+    QCOMPARE(model.columns().name(0), QStringLiteral("First"));
+    QCOMPARE(model.columns().name(11), QStringLiteral("Inserted"));
+    QCOMPARE(model.columns().name(13), QStringLiteral("10"));
+}
+
+void TestDataJournal::testTornTail()
+{
+    {
+        DataModel model;
+        DataJournal journal(&model);
+        QVERIFY(journal.open(basePath()));
+        makeEdits(model);
+    }
+
+    QFile file(basePath() + ".journal");
+    const qint64 goodSize = file.size();
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray("\x20\x00\x00\x00garbage", 11));
+    file.close();
+
+    const QList<QJsonObject> items = reopened(basePath());
+    QCOMPARE(items.size(), 3);
+    QCOMPARE(QFileInfo(basePath() + ".journal").size(), goodSize);
+}
+
+void TestDataJournal::testCompaction()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QSignalSpy compactedSpy(&journal, &DataJournal::compacted);
+    journal.setCompactThreshold(4096);
+    QVERIFY(journal.open(basePath()));
+
+    model.addItem("Counter", "", 0);
+    const QString id = model.columns().id(0);
+    for (int i = 1; i <= 500; ++i) {
+        model.updateItemValue(id, i);
+    }
+    QTRY_VERIFY(compactedSpy.count() > 0);
+    QVERIFY(journal.journalSize() < 4096);
+    journal.flush();
+
+    QCOMPARE(reopened(basePath()), contents(model));
+    QVERIFY(QFileInfo::exists(basePath() + ".dms"));
+}
+
+void TestDataJournal::testReplayAfterInterruptedCompaction()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(journal.open(basePath()));
+    makeEdits(model);
+    journal.flush();
+
+    // Crash after the snapshot was written but before the journal was emptied
+    QFile file(basePath() + ".journal");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray staleJournal = file.readAll();
+    file.close();
+    QVERIFY(journal.compact());
+    journal.close();
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(staleJournal);
+    file.close();
+
+    QCOMPARE(reopened(basePath()), contents(model));
+}
+
+void TestDataJournal::testCompactionWhileGroupInFlight()
+{
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(journal.open(basePath()));
+    model.addItem("Keep", "", 1);
+    journal.flush();
+    const QString id = model.columns().id(0);
+
+    // Hold the writer after it has taken the next group, before it writes it
+    QSemaphore taken;
+    QSemaphore resume;
+    QAtomicInt armed(1);
+    journal.m_beforeWrite = [&]() {
+        if (armed.testAndSetRelaxed(1, 0)) {
+            taken.release();
+            resume.acquire();
+        }
+    };
+
+    model.removeItem(id);
+    taken.acquire();
+    QVERIFY(model.undo());
+    QVERIFY(journal.compact());
+    resume.release();
+    journal.close();
+
+    // The stale "Remove" must not replay over the snapshot that re-added the item
+    const QList<QJsonObject> items = reopened(basePath());
+    QCOMPARE(items.size(), 1);
+    QCOMPARE(items.first().value("id").toString(), id);
+}
+
+void TestDataJournal::testRejectsForeignFile()
+{
+    QFile file(basePath() + ".journal");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a journal at all");
+    file.close();
+
+    DataModel model;
+    DataJournal journal(&model);
+    QVERIFY(!journal.open(basePath()));
+    QVERIFY(!journal.isOpen());
+    QVERIFY(!journal.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestDataJournal)
+#include "test_data_journal.moc"
@@ -0,0 +1,163 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QLoggingCategory>
+#include "models/DataModel.h"
+#include "models/DataLoader.h"
+
+class TestDataLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testLoadFile();
+    void testProgress();
+    void testFailureMidFile();
+    void testCancel();
+    void testLoadIsNotRecorded();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    DataModel *m_model = nullptr;
+    DataLoader *m_loader = nullptr;
+
+    QString writeLines(const QString &name, int count, const QByteArray &brokenLine = QByteArray());
+};
+
+void TestDataLoader::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.models.debug=false"));
+}
+
+void TestDataLoader::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_model = new DataModel();
+    m_loader = new DataLoader(m_model);
+}
+
+void TestDataLoader::cleanup()
+{
+    delete m_loader;
+    delete m_model;
+    delete m_dir;
+}
+
+QString TestDataLoader::writeLines(const QString &name, int count, const QByteArray &brokenLine)
+{
+    const QString path = m_dir->filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    for (int i = 0; i < count; ++i) {
+        file.write(QStringLiteral("{\"name\":\"Item %1\",\"value\":%1}\n").arg(i).toUtf8());
+        if (!brokenLine.isEmpty() && i == count / 2) {
+            file.write(brokenLine + '\n');
+        }
+    }
+    return path;
+}
+
+void TestDataLoader::testLoadFile()
+{
+    const QString path = writeLines("items.jsonl", 3000);
+    QSignalSpy finishedSpy(m_loader, &DataLoader::finished);
+
+    m_loader->loadFile(path);
+    QVERIFY(m_loader->isRunning());
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(finishedSpy.first().first().toInt(), 3000);
+    QVERIFY(!m_loader->isRunning());
+    QCOMPARE(m_model->getCount(), 3000);
+    QCOMPARE(m_model->columns().name(0), QStringLiteral("Item 0"));
+    QCOMPARE(m_model->columns().value(2999), 2999);
+}
+
+void TestDataLoader::testProgress()
+{
+    QList<qreal> seen;
+    connect(m_loader, &DataLoader::progressChanged, this, [this, &seen]() {
+        seen.append(m_loader->progress());
+    });
+    QSignalSpy finishedSpy(m_loader, &DataLoader::finished);
+
+    m_loader->loadGenerated(50000);
+    QVERIFY(finishedSpy.wait(10000));
+
+    QVERIFY(seen.size() > 1);
+    for (int i = 0; i < seen.size(); ++i) {
+        QVERIFY(seen[i] >= 0.0 && seen[i] <= 1.0);
+    }
+    QCOMPARE(m_loader->progress(), 1.0);
+    QCOMPARE(m_loader->loadedCount(), 50000);
+}
+
+void TestDataLoader::testFailureMidFile()
+{
+    const QString path = writeLines("broken.jsonl", 4000, "{\"name\": ");
+    QSignalSpy failedSpy(m_loader, &DataLoader::failed);
+    QSignalSpy finishedSpy(m_loader, &DataLoader::finished);
+
+    m_loader->loadFile(path);
+    QVERIFY(failedSpy.wait(10000));
+
+    // Line 2002 is the broken one: the half before it may have been published, nothing after it
+    const QString error = failedSpy.first().first().toString();
+    QVERIFY2(error.contains(QStringLiteral(":2002:")), qPrintable(error));
+    QCOMPARE(finishedSpy.count(), 0);
+    QVERIFY(!m_loader->isRunning());
+    QVERIFY(m_model->getCount() <= 2001);
+    QCOMPARE(m_model->getCount(), m_loader->loadedCount());
+}
+
+void TestDataLoader::testCancel()
+{
+    QSignalSpy cancelledSpy(m_loader, &DataLoader::cancelled);
+    QSignalSpy finishedSpy(m_loader, &DataLoader::finished);
+
+    // Produces until told to stop; blocks on the staging bound in between
+    m_loader->start([](const DataLoader::EmitItem &emitItem, const DataLoader::ReportProgress &) {
+        for (int i = 0; emitItem({QString(), QStringLiteral("Endless"), QString(), i, true}); ++i) {
+        }
+        return QString();
+    });
+    QTRY_VERIFY_WITH_TIMEOUT(m_loader->loadedCount() > 0, 10000);
+
+    m_loader->cancel();
+    QCOMPARE(cancelledSpy.count(), 1);
+    QVERIFY(!m_loader->isRunning());
+
+    const int loaded = m_model->getCount();
+    QCOMPARE(loaded, m_loader->loadedCount());
+    QTest::qWait(50);
+    QCOMPARE(m_model->getCount(), loaded);
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
+void TestDataLoader::testLoadIsNotRecorded()
+{
+    m_model->addItem("Before", "", 1);
+    QSignalSpy finishedSpy(m_loader, &DataLoader::finished);
+
+    m_loader->loadGenerated(20000);
+    QVERIFY(finishedSpy.wait(10000));
+
+    // The history holds the edit before the load, not the loaded rows
+    QCOMPARE(m_model->history().undoCount(), 1);
+    QVERIFY(m_model->history().memoryUsage() < 4096);
+    QVERIFY(m_model->isRecordingHistory());
+
+    QVERIFY(m_model->undo());
+    QCOMPARE(m_model->getCount(), 20000);
+    QCOMPARE(m_model->columns().name(0), QStringLiteral("Item 1"));
+}
+
+QTEST_GUILESS_MAIN(TestDataLoader)
+#include "test_data_loader.moc"
@@ -9,6 +9,7 @@ class TestDataModel : public QObject
 private slots:
     void initTestCase();
     void cleanupTestCase();
+    void init();
 
     void testAddItem();
     void testRemoveItem();
@@ -17,6 +18,13 @@ private slots:
     void testClear();
     void testRowCount();
     void testData();
+    void testLookupAfterRemovals();
+    void testLookupAfterClear();
+    void testAddItems();
+    void testRemoveItemsRuns();
+    void testUpdateValuesRuns();
+    void testBatchScope();
+    void testColumnsAcrossRemovals();
 
 private:
     DataModel* m_model;
@@ -32,6 +40,11 @@ void TestDataModel::cleanupTestCase()
     delete m_model;
 }
 
+void TestDataModel::init()
+{
+    m_model->clear();
+}
+
 void TestDataModel::testAddItem()
 {
     QSignalSpy rowsInsertedSpy(m_model, &DataModel::rowsInserted);
@@ -121,5 +134,160 @@ void TestDataModel::testData()
     QCOMPARE(m_model->data(index, DataModel::EnabledRole).toBool(), true);
 }
 
+void TestDataModel::testLookupAfterRemovals()
+{
+    QStringList ids;
+    for (int i = 0; i < 10; ++i) {
+        m_model->addItem(QString("Item %1").arg(i), "Index", i);
+        ids.append(m_model->getItem(i)["id"].toString());
+    }
+
+    m_model->removeItem(ids[2]);
+    m_model->removeItem(ids[7]);
+    m_model->removeItem(ids[0]);
+    m_model->addItem("Appended", "Index", 10);
+    ids.append(m_model->getItem(m_model->getCount() - 1)["id"].toString());
+
+    QCOMPARE(m_model->getCount(), 8);
+    QCOMPARE(m_model->rowOf(ids[0]), -1);
+    QVERIFY(!m_model->contains(ids[2]));
+
+    const QList<int> remaining = {1, 3, 4, 5, 6, 8, 9, 10};
+    for (int row = 0; row < remaining.size(); ++row) {
+        const QString &id = ids[remaining[row]];
+        QCOMPARE(m_model->rowOf(id), row);
+        QCOMPARE(m_model->getItem(id)["value"].toInt(), remaining[row]);
+    }
+
+    m_model->updateItemValue(ids[9], 90);
+    QCOMPARE(m_model->getItem(6)["value"].toInt(), 90);
+}
+
+void TestDataModel::testLookupAfterClear()
+{
+    m_model->addItem("Before", "Clear", 1);
+    const QString id = m_model->getItem(0)["id"].toString();
+
+    m_model->clear();
+
+    QCOMPARE(m_model->rowOf(id), -1);
+    QVERIFY(m_model->getItem(id).isEmpty());
+
+    m_model->addItem("After", "Clear", 2);
+    QCOMPARE(m_model->rowOf(m_model->getItem(0)["id"].toString()), 0);
+}
+
+void TestDataModel::testAddItems()
+{
+    QSignalSpy rowsInsertedSpy(m_model, &DataModel::rowsInserted);
+
+    QVariantList items;
+    for (int i = 0; i < 100; ++i) {
+        items.append(QVariantMap{{"name", QString("Bulk %1").arg(i)}, {"value", i}});
+    }
+    const QStringList ids = m_model->addItems(items);
+
+    QCOMPARE(ids.size(), 100);
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(rowsInsertedSpy[0][1].toInt(), 0);
+    QCOMPARE(rowsInsertedSpy[0][2].toInt(), 99);
+    QCOMPARE(m_model->getItem(ids[42])["value"].toInt(), 42);
+}
+
+void TestDataModel::testRemoveItemsRuns()
+{
+    QVariantList items;
+    for (int i = 0; i < 10; ++i) {
+        items.append(QVariantMap{{"name", "Run"}, {"value", i}});
+    }
+    const QStringList ids = m_model->addItems(items);
+
+    QSignalSpy rowsRemovedSpy(m_model, &DataModel::rowsRemoved);
+
+    QCOMPARE(m_model->removeItems({ids[2], ids[3], ids[4], ids[8], "missing"}), 4);
+
+    QCOMPARE(rowsRemovedSpy.count(), 2);
+    QCOMPARE(m_model->rowCount(), 6);
+    QCOMPARE(m_model->rowOf(ids[9]), 5);
+    QCOMPARE(m_model->rowOf(ids[5]), 2);
+}
+
+void TestDataModel::testUpdateValuesRuns()
+{
+    QVariantList items;
+    for (int i = 0; i < 10; ++i) {
+        items.append(QVariantMap{{"name", "Update"}, {"value", i}});
+    }
+    const QStringList ids = m_model->addItems(items);
+
+    QSignalSpy dataChangedSpy(m_model, &DataModel::dataChanged);
+
+    QVariantMap values;
+    values[ids[1]] = 10;
+    values[ids[2]] = 20;
+    values[ids[3]] = 30;
+    values[ids[7]] = 70;
+    QCOMPARE(m_model->updateValues(values), 4);
+
+    QCOMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(m_model->getItem(ids[7])["value"].toInt(), 70);
+}
+
+void TestDataModel::testBatchScope()
+{
+    m_model->addItem("Existing", "Batch", 1);
+    const QString existing = m_model->getItem(0)["id"].toString();
+
+    QSignalSpy rowsInsertedSpy(m_model, &DataModel::rowsInserted);
+    QSignalSpy dataChangedSpy(m_model, &DataModel::dataChanged);
+
+    m_model->beginBatch();
+    for (int i = 0; i < 50; ++i) {
+        m_model->addItem("Batched", "Batch", i);
+    }
+    m_model->updateItemValue(existing, 2);
+    m_model->setItemEnabled(existing, false);
+
+    QCOMPARE(rowsInsertedSpy.count(), 0);
+    QCOMPARE(dataChangedSpy.count(), 0);
+    QCOMPARE(m_model->rowCount(), 1);
+    QCOMPARE(m_model->getCount(), 51);
+
+    m_model->endBatch();
+
+    QCOMPARE(rowsInsertedSpy.count(), 1);
+    QCOMPARE(rowsInsertedSpy[0][1].toInt(), 1);
+    QCOMPARE(rowsInsertedSpy[0][2].toInt(), 50);
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(m_model->rowCount(), 51);
+    QCOMPARE(m_model->getItem(existing)["enabled"].toBool(), false);
+}
+
+void TestDataModel::testColumnsAcrossRemovals()
+{
+    // Spans several 64-bit words of enabled flags.
+    QVariantList items;
+    for (int i = 0; i < 200; ++i) {
+        items.append(QVariantMap{{"name", QString("Column %1").arg(i)}, {"value", i}, {"enabled", i % 2 == 0}});
+    }
+    const QStringList ids = m_model->addItems(items);
+
+    QStringList toRemove;
+    for (int i = 10; i < 80; ++i) {
+        toRemove.append(ids[i]);
+    }
+    m_model->removeItems(toRemove);
+    m_model->removeItem(ids[150]);
+
+    QCOMPARE(m_model->getCount(), 129);
+    QCOMPARE(m_model->columns().enabledCount(), 64);
+    for (int i : {0, 9, 80, 149, 151, 199}) {
+        const QJsonObject item = m_model->getItem(ids[i]);
+        QCOMPARE(item["name"].toString(), QString("Column %1").arg(i));
+        QCOMPARE(item["value"].toInt(), i);
+        QCOMPARE(item["enabled"].toBool(), i % 2 == 0);
+    }
+}
+
 QTEST_APPLESS_MAIN(TestDataModel)
 #include "test_data_model.moc"
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <QtTest>
+#include "models/DataProxyModel.h"
+
+class TestDataProxyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testSortByName();
+    void testSortByValueFollowsUpdates();
+    void testFilterIsCaseInsensitive();
+    void testInsertedRowsArePlaced();
+
+private:
+    DataModel *m_model = nullptr;
+    DataProxyModel *m_proxy = nullptr;
+
+    QStringList proxyNames() const;
+};
+
+void TestDataProxyModel::init()
+{
+    m_model = new DataModel();
+    m_model->addItems({
+        QVariantMap{{"name", "banana"}, {"description", "Yellow fruit"}, {"value", 3}},
+        QVariantMap{{"name", "Apple"}, {"description", "Red fruit"}, {"value", 1}},
+        QVariantMap{{"name", "cherry"}, {"description", "Small and RED"}, {"value", 2}},
+    });
+    m_proxy = new DataProxyModel();
+    m_proxy->setSourceModel(m_model);
+}
+
+void TestDataProxyModel::cleanup()
+{
+    delete m_proxy;
+    delete m_model;
+}
+
+QStringList TestDataProxyModel::proxyNames() const
+{
+    QStringList names;
+    for (int row = 0; row < m_proxy->rowCount(); ++row) {
+        names.append(m_proxy->data(m_proxy->index(row, 0), DataModel::NameRole).toString());
+    }
+    return names;
+}
+
+void TestDataProxyModel::testSortByName()
+{
+    m_proxy->setSortBy("name");
+    QCOMPARE(proxyNames(), QStringList({"Apple", "banana", "cherry"}));
+
+    m_proxy->setAscending(false);
+    QCOMPARE(proxyNames(), QStringList({"cherry", "banana", "Apple"}));
+
+    m_proxy->setSortBy(QString());
+    QCOMPARE(proxyNames(), QStringList({"banana", "Apple", "cherry"}));
+}
+
+void TestDataProxyModel::testSortByValueFollowsUpdates()
+{
+    m_proxy->setSortBy("value");
+    QCOMPARE(proxyNames(), QStringList({"Apple", "cherry", "banana"}));
+
+    m_model->updateItemValue(m_model->getItem(1)["id"].toString(), 10);
+    QCOMPARE(proxyNames(), QStringList({"cherry", "banana", "Apple"}));
+}
+
+void TestDataProxyModel::testFilterIsCaseInsensitive()
+{
+    m_proxy->setFilterText("RED");
+    QCOMPARE(m_proxy->rowCount(), 2);
+
+    m_proxy->setFilterText("yellow");
+    QCOMPARE(proxyNames(), QStringList({"banana"}));
+
+    m_proxy->setFilterText(QString());
+    QCOMPARE(m_proxy->rowCount(), 3);
+}
+
+void TestDataProxyModel::testInsertedRowsArePlaced()
+{
+    m_proxy->setSortBy("name");
+    m_proxy->setFilterText("fruit");
+
+    m_model->addItems({
+        QVariantMap{{"name", "Avocado"}, {"description", "Green fruit"}, {"value", 4}},
+        QVariantMap{{"name", "Aubergine"}, {"description", "Vegetable"}, {"value", 5}},
+    });
+
+    QCOMPARE(proxyNames(), QStringList({"Apple", "Avocado", "banana"}));
+
+    m_model->removeItem(m_model->getItem(0)["id"].toString());
+    QCOMPARE(proxyNames(), QStringList({"Apple", "Avocado"}));
+}
+
+QTEST_APPLESS_MAIN(TestDataProxyModel)
+#include "test_data_proxy_model.moc"
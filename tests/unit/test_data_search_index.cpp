@@ -0,0 +1,92 @@
+#include <QtTest>
+#include "models/DataSearchIndex.h"
+
+class TestDataSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testSubstring();
+    void testShortPrefix();
+    void testMultiTermAnd();
+    void testFollowsRemovals();
+    void testFollowsBatches();
+
+private:
+    DataModel *m_model = nullptr;
+    DataSearchIndex *m_index = nullptr;
+
+    QStringList names(const QList<int> &rows) const;
+};
+
+void TestDataSearchIndex::init()
+{
+    m_model = new DataModel();
+    m_model->addItems({
+        QVariantMap{{"name", "Temperature Sensor"}, {"description", "Kitchen"}},
+        QVariantMap{{"name", "Humidity Sensor"}, {"description", "Bathroom"}},
+        QVariantMap{{"name", "Door Contact"}, {"description", "Kitchen entrance"}},
+    });
+    m_index = new DataSearchIndex(m_model);
+}
+
+void TestDataSearchIndex::cleanup()
+{
+    delete m_index;
+    delete m_model;
+}
+
+QStringList TestDataSearchIndex::names(const QList<int> &rows) const
+{
+    QStringList result;
+    for (int row : rows) {
+        result.append(m_model->getItem(row)["name"].toString());
+    }
+    return result;
+}
+
+void TestDataSearchIndex::testSubstring()
+{
+    QCOMPARE(names(m_index->search("SENS")), QStringList({"Temperature Sensor", "Humidity Sensor"}));
+    QCOMPARE(names(m_index->search("itche")), QStringList({"Temperature Sensor", "Door Contact"}));
+    QVERIFY(m_index->search("sensors").isEmpty());
+}
+
+void TestDataSearchIndex::testShortPrefix()
+{
+    QCOMPARE(names(m_index->search("d")), QStringList({"Door Contact"}));
+    QCOMPARE(names(m_index->search("ki")), QStringList({"Temperature Sensor", "Door Contact"}));
+    // Two-character terms match word starts only.
+    QVERIFY(m_index->search("or").isEmpty());
+}
+
+void TestDataSearchIndex::testMultiTermAnd()
+{
+    QCOMPARE(names(m_index->search("sensor kitchen")), QStringList({"Temperature Sensor"}));
+    QVERIFY(m_index->search("humidity kitchen").isEmpty());
+}
+
+void TestDataSearchIndex::testFollowsRemovals()
+{
+    m_model->removeItem(m_model->getItem(0)["id"].toString());
+
+    QCOMPARE(names(m_index->search("sensor")), QStringList({"Humidity Sensor"}));
+    QCOMPARE(m_index->search("kitchen"), QList<int>({1}));
+    QCOMPARE(m_index->documentCount(), 2);
+}
+
+void TestDataSearchIndex::testFollowsBatches()
+{
+    m_model->beginBatch();
+    m_model->addItem("Motion Sensor", "Hallway", 0);
+    QCOMPARE(m_index->search("motion").size(), 0);
+    m_model->endBatch();
+
+    QCOMPARE(names(m_index->search("motion sens")), QStringList({"Motion Sensor"}));
+}
+
+QTEST_APPLESS_MAIN(TestDataSearchIndex)
+#include "test_data_search_index.moc"
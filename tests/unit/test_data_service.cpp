@@ -0,0 +1,162 @@
+#include <QtTest>
+#include "services/DataService.h"
+
+class TestDataService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testSortRows_data();
+    void testSortRows();
+    void testSortItems_data();
+    void testSortItems();
+    void testSwitchingIdStrategyKeepsIds();
+
+private:
+    // Past the size at which the sorts go parallel, and not a multiple of any thread count
+    static constexpr int kRows = 20011;
+    DataColumns m_columns;
+    QVariantList m_items;
+    // A shuffled subset, so stability is about input order, not row order
+    QList<int> m_rows;
+
+    static void addThreadCounts();
+};
+
+void TestDataService::initTestCase()
+{
+    static const char *const words[] = {"alpha", "Alpha", "bravo", "BRAVO", "charlie"};
+    m_columns.reserve(kRows);
+    quint32 seed = 41;
+    for (int i = 0; i < kRows; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        // Few distinct keys, and names equal once case-folded: plenty of ties
+        const QString name = QStringLiteral("%1 %2").arg(QLatin1String(words[seed % 5])).arg((seed >> 8) % 7);
+        const QString description = QLatin1String(words[(seed >> 12) % 5]);
+        const int value = int((seed >> 16) % 17);
+        m_columns.append(QString::number(i), name, description, value, true);
+        m_items.append(QVariantMap{{"index", i}, {"name", name}, {"value", value}});
+        if (seed % 8 != 0) {
+            m_rows.append(i);
+        }
+    }
+    for (qsizetype i = m_rows.size() - 1; i > 0; --i) {
+        seed = seed * 1103515245u + 12345u;
+        m_rows.swapItemsAt(i, qsizetype(seed % quint32(i + 1)));
+    }
+}
+
+// The parallel sorts must give exactly what std::stable_sort gives, for every
+// thread count, including ones that leave an odd run to merge.
+void TestDataService::addThreadCounts()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("ascending");
+    for (int threads = 1; threads <= 8; ++threads) {
+        for (bool ascending : {true, false}) {
+            const char *order = ascending ? "ascending" : "descending";
+            QTest::addRow("%d threads, %s", threads, order) << threads << int(kRows) << ascending;
+            // Below the parallel threshold the serial path must agree too
+            QTest::addRow("%d threads, %s, small", threads, order) << threads << 300 << ascending;
+        }
+    }
+}
+
+void TestDataService::testSortRows_data()
+{
+    addThreadCounts();
+}
+
+void TestDataService::testSortRows()
+{
+    QFETCH(int, threads);
+    QFETCH(int, count);
+    QFETCH(bool, ascending);
+
+    DataService service;
+    service.setMaxThreads(threads);
+    const QList<int> rows = m_rows.mid(0, count);
+
+    auto expected = [&](auto key) {
+        QList<int> sorted = rows;
+        std::stable_sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+            return ascending ? key(a) < key(b) : key(b) < key(a);
+        });
+        return sorted;
+    };
+
+    QCOMPARE(service.sortRows(m_columns, rows, DataService::SortByValue, ascending),
+             expected([this](int row) { return m_columns.value(row); }));
+    QCOMPARE(service.sortRows(m_columns, rows, DataService::SortByName, ascending),
+             expected([this](int row) { return m_columns.name(row).toCaseFolded(); }));
+    QCOMPARE(service.sortRows(m_columns, rows, DataService::SortByDescription, ascending),
+             expected([this](int row) { return m_columns.description(row).toCaseFolded(); }));
+}
+
+void TestDataService::testSortItems_data()
+{
+    addThreadCounts();
+}
+
+void TestDataService::testSortItems()
+{
+    QFETCH(int, threads);
+    QFETCH(int, count);
+    QFETCH(bool, ascending);
+
+    DataService service;
+    service.setMaxThreads(threads);
+    QVariantList items;
+    for (int row : m_rows.mid(0, count)) {
+        items.append(m_items.at(row));
+    }
+
+    auto indexes = [](const QVariantList &sorted) {
+        QList<int> result;
+        for (const QVariant &item : sorted) {
+            result.append(item.toMap().value("index").toInt());
+        }
+        return result;
+    };
+    auto expected = [&](const QString &sortBy, auto key) {
+        QVariantList sorted = items;
+        std::stable_sort(sorted.begin(), sorted.end(), [&](const QVariant &a, const QVariant &b) {
+            const auto aKey = key(a.toMap().value(sortBy));
+            const auto bKey = key(b.toMap().value(sortBy));
+            return ascending ? aKey < bKey : bKey < aKey;
+        });
+        return indexes(sorted);
+    };
+
+    QCOMPARE(indexes(service.sortItems(items, "value", ascending)),
+             expected("value", [](const QVariant &v) { return v.toInt(); }));
+    // Names compare case-sensitively here
+    QCOMPARE(indexes(service.sortItems(items, "name", ascending)),
+             expected("name", [](const QVariant &v) { return v.toString(); }));
+}
+
+void TestDataService::testSwitchingIdStrategyKeepsIds()
+{
+    DataService service;
+    service.registerItemId(IdGenerator::format(5));
+    QStringList generated;
+    for (IdGenerator::Strategy strategy : {IdGenerator::Counter, IdGenerator::Random64, IdGenerator::Snowflake,
+                                           IdGenerator::Counter, IdGenerator::Random64, IdGenerator::Counter}) {
+        service.setIdStrategy(strategy);
+        for (int i = 0; i < 1000; ++i) {
+            generated.append(service.generateItemId());
+        }
+    }
+
+    QCOMPARE(QSet<QString>(generated.cbegin(), generated.cend()).size(), generated.size());
+    QVERIFY(!generated.contains(IdGenerator::format(5)));
+    for (const QString &id : std::as_const(generated)) {
+        QVERIFY(!service.isItemIdUnique(id));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestDataService)
+#include "test_data_service.moc"
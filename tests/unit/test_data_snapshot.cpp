@@ -0,0 +1,170 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "models/DataModel.h"
+#include "models/DataSnapshot.h"
+
+class TestDataSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRoundTrip();
+    void testEmptyModel();
+    void testInternsRepeatedText();
+    void testLoadIsOneReset();
+    void testRejectsCorruption_data();
+    void testRejectsCorruption();
+    void testChecksum();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    DataModel *m_model = nullptr;
+
+    QString path(const QString &name) const;
+    void fillModel(int rows);
+};
+
+void TestDataSnapshot::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_model = new DataModel();
+}
+
+void TestDataSnapshot::cleanup()
+{
+    delete m_model;
+    delete m_dir;
+}
+
+QString TestDataSnapshot::path(const QString &name) const
+{
+    return m_dir->filePath(name);
+}
+
+void TestDataSnapshot::fillModel(int rows)
+{
+    QVariantList items;
+    for (int i = 0; i < rows; ++i) {
+        items.append(QVariantMap{
+            {"name", QStringLiteral("Item %1").arg(i % 37)},
+            {"description", i % 5 == 0 ? QString() : QStringLiteral("Größe %1 ✓").arg(i)},
+            {"value", i * 7 - 100},
+        });
+    }
+    m_model->addItems(items);
+    for (int i = 0; i < rows; i += 3) {
+        m_model->setItemEnabled(m_model->columns().id(i), false);
+    }
+}
+
+void TestDataSnapshot::testRoundTrip()
+{
+    fillModel(1000);
+    QVERIFY(m_model->saveSnapshot(path("model.dms")));
+
+    DataModel restored;
+    QVERIFY(restored.loadSnapshot(path("model.dms")));
+    QCOMPARE(restored.getCount(), m_model->getCount());
+    for (int row = 0; row < m_model->getCount(); ++row) {
+        QCOMPARE(restored.getItem(row), m_model->getItem(row));
+    }
+
+    // The id index is rebuilt lazily after a load
+    const QString lastId = m_model->columns().id(999);
+    QCOMPARE(restored.rowOf(lastId), 999);
+    restored.updateItemValue(lastId, 5);
+    QCOMPARE(restored.columns().value(999), 5);
+}
+
+void TestDataSnapshot::testEmptyModel()
+{
+    QVERIFY(m_model->saveSnapshot(path("empty.dms")));
+    m_model->addItem("Stale", "", 1);
+    QVERIFY(m_model->loadSnapshot(path("empty.dms")));
+    QCOMPARE(m_model->getCount(), 0);
+}
+
+void TestDataSnapshot::testInternsRepeatedText()
+{
+    fillModel(2000);
+    QVERIFY(m_model->saveSnapshot(path("interned.dms")));
+
+    DataSnapshot snapshot;
+    QVERIFY(snapshot.open(path("interned.dms")));
+    QCOMPARE(snapshot.rowCount(), 2000);
+    QCOMPARE(snapshot.name(1).toString(), QStringLiteral("Item 1"));
+    QCOMPARE(snapshot.name(38).data(), snapshot.name(1).data());
+    QVERIFY(!snapshot.enabled(0));
+    QVERIFY(snapshot.enabled(1));
+}
+
+void TestDataSnapshot::testLoadIsOneReset()
+{
+    fillModel(500);
+    QVERIFY(m_model->saveSnapshot(path("reset.dms")));
+
+    DataModel restored;
+    QSignalSpy resetSpy(&restored, &DataModel::modelReset);
+    QSignalSpy insertSpy(&restored, &DataModel::rowsInserted);
+    QVERIFY(restored.loadSnapshot(path("reset.dms")));
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(insertSpy.count(), 0);
+}
+
+void TestDataSnapshot::testRejectsCorruption_data()
+{
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<int>("truncateTo");
+    QTest::newRow("magic") << 0 << -1;
+    QTest::newRow("row count") << 8 << -1;
+    QTest::newRow("string table") << 60 << -1;
+    QTest::newRow("last byte") << -1 << -1;
+    QTest::newRow("truncated") << -2 << 100;
+    QTest::newRow("header only") << -2 << 48;
+}
+
+void TestDataSnapshot::testRejectsCorruption()
+{
+    QFETCH(int, offset);
+    QFETCH(int, truncateTo);
+
+    fillModel(200);
+    QVERIFY(m_model->saveSnapshot(path("good.dms")));
+
+    QFile file(path("good.dms"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    if (truncateTo >= 0) {
+        bytes.truncate(truncateTo);
+    } else {
+        const int at = offset >= 0 ? offset : int(bytes.size()) - 1;
+        bytes[at] = char(bytes[at] ^ 0x5a);
+    }
+    QVERIFY(file.resize(0));
+    QVERIFY(file.seek(0));
+    file.write(bytes);
+    file.close();
+
+    DataModel restored;
+    restored.addItem("Keep me", "", 1);
+    DataSnapshot snapshot;
+    QVERIFY(!snapshot.open(path("good.dms")));
+    QVERIFY(!snapshot.errorString().isEmpty());
+    QVERIFY(!restored.loadSnapshot(path("good.dms")));
+    QCOMPARE(restored.getCount(), 1);
+}
+
+void TestDataSnapshot::testChecksum()
+{
+    QCOMPARE(DataSnapshot::crc32("123456789", 9), quint32(0xCBF43926));
+    const quint32 partial = DataSnapshot::crc32("1234", 4);
+    QCOMPARE(DataSnapshot::crc32("56789", 5, partial), quint32(0xCBF43926));
+}
+
+QTEST_GUILESS_MAIN(TestDataSnapshot)
+#include "test_data_snapshot.moc"
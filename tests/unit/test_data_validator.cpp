@@ -0,0 +1,158 @@
+#include <QtTest>
+#include "services/DataValidator.h"
+#include "models/DataModel.h"
+
+class TestDataValidator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testFailureMask();
+    void testSingleFields();
+    void testBatchBitmap();
+    void testColumns();
+    void testRuleLimit();
+    void testColumnsMatchRecords_data();
+    void testColumnsMatchRecords();
+
+private:
+    DataValidator m_validator;
+};
+
+void TestDataValidator::init()
+{
+    m_validator = DataValidator();
+    m_validator
+        .addTextRule("name", 2, 50, "[a-zA-Z0-9\\s\\-_.]+")
+        .addRangeRule("value", 0, 1000);
+}
+
+void TestDataValidator::testFailureMask()
+{
+    QCOMPARE(m_validator.ruleCount(), 2);
+    QCOMPARE(m_validator.validate({{"name", "Sensor 1"}, {"value", 10}}), quint64(0));
+    QCOMPARE(m_validator.validate({{"name", "Sensor!"}, {"value", 10}}), quint64(1));
+    QCOMPARE(m_validator.validate({{"name", "Sensor"}, {"value", 1001}}), quint64(2));
+    QCOMPARE(m_validator.validate({{"value", -1}}), quint64(3));
+}
+
+void TestDataValidator::testSingleFields()
+{
+    QVERIFY(m_validator.isValidText("name", "ok"));
+    QVERIFY(!m_validator.isValidText("name", "x"));
+    QVERIFY(!m_validator.isValidText("name", QString(51, 'a')));
+    // The pattern must match the whole text, not just a prefix
+    QVERIFY(!m_validator.isValidText("name", "abc$"));
+    QVERIFY(m_validator.isValidNumber("value", 1000));
+    QVERIFY(!m_validator.isValidNumber("value", 1001));
+    QVERIFY(m_validator.isValidNumber("unknown", -5));
+}
+
+void TestDataValidator::testBatchBitmap()
+{
+    QVariantList records;
+    for (int i = 0; i < 5000; ++i) {
+        records.append(QVariantMap{{"name", QStringLiteral("Item %1").arg(i)}, {"value", i % 1100}});
+    }
+
+    int invalidCount = -1;
+    const QBitArray invalid = m_validator.validateBatch(records, &invalidCount);
+    QCOMPARE(invalid.size(), records.size());
+    QCOMPARE(invalidCount, invalid.count(true));
+    for (int i = 0; i < records.size(); ++i) {
+        QCOMPARE(invalid.testBit(i), i % 1100 > 1000);
+    }
+}
+
+void TestDataValidator::testColumns()
+{
+    DataColumns columns;
+    columns.append({"1", "Good name", "", 5, true});
+    columns.append({"2", "?", "", 5, true});
+    columns.append({"3", "Good name", "", 5000, true});
+
+    int invalidCount = 0;
+    const QBitArray invalid = m_validator.validateColumns(columns, &invalidCount);
+    QCOMPARE(invalidCount, 2);
+    QVERIFY(!invalid.testBit(0));
+    QVERIFY(invalid.testBit(1));
+    QVERIFY(invalid.testBit(2));
+}
+
+void TestDataValidator::testRuleLimit()
+{
+    DataValidator validator;
+    for (int i = 0; i < DataValidator::kMaxRules; ++i) {
+        validator.addRangeRule(QStringLiteral("field%1").arg(i), 0, 10);
+    }
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("rule limit reached"));
+    validator.addRangeRule("extra", 1, 1);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("rule limit reached"));
+    validator.addTextRule("extra", 1, 1);
+    QCOMPARE(validator.ruleCount(), DataValidator::kMaxRules);
+
+    // The refused rules do not apply; the last accepted one still has its bit
+    QVariantMap record{{"extra", 5}};
+    QCOMPARE(validator.validate(record), quint64(0));
+    record.insert(QStringLiteral("field%1").arg(DataValidator::kMaxRules - 1), 11);
+    QCOMPARE(validator.validate(record), quint64(1) << (DataValidator::kMaxRules - 1));
+}
+
+void TestDataValidator::testColumnsMatchRecords_data()
+{
+    QTest::addColumn<QString>("field");
+    QTest::addColumn<bool>("text");
+
+    for (const char *field : {"id", "name", "description", "value", "enabled", "unknown"}) {
+        QTest::addRow("text %s", field) << QString::fromLatin1(field) << true;
+        QTest::addRow("range %s", field) << QString::fromLatin1(field) << false;
+    }
+}
+
+void TestDataValidator::testColumnsMatchRecords()
+{
+    QFETCH(QString, field);
+    QFETCH(bool, text);
+
+    // Covers missing fields and every kind read from every column
+    QList<DataValidator> validators(4);
+    if (text) {
+        validators[0].addTextRule(field, 0, 100);
+        validators[1].addTextRule(field, 1, 3);
+        validators[2].addTextRule(field, 0, 10, "[0-9]+");
+        validators[3].addTextRule(field, 4, 5, "true|false");
+    } else {
+        validators[0].addRangeRule(field, 0, 0);
+        validators[1].addRangeRule(field, 1, 1);
+        validators[2].addRangeRule(field, 10, 500);
+        validators[3].addRangeRule(field, -100, -1);
+    }
+
+    const QList<DataItem> items = {
+        {"1", "Good name", "", 5, true},
+        {"0000000000000abc", "42", "-7", 0, false},
+        {"x", "", "1", -3, true},
+        {"250", "abc", "description", 250, false},
+        {"", "1", "true", 1, true},
+    };
+    DataColumns columns;
+    QVariantList records;
+    for (const DataItem &item : items) {
+        columns.append(item);
+        records.append(QVariantMap{{"id", item.id}, {"name", item.name}, {"description", item.description},
+                                   {"value", item.value}, {"enabled", item.enabled}});
+    }
+
+    for (const DataValidator &validator : std::as_const(validators)) {
+        int recordFailures = -1;
+        int columnFailures = -1;
+        QCOMPARE(validator.validateColumns(columns, &columnFailures),
+                 validator.validateBatch(records, &recordFailures));
+        QCOMPARE(columnFailures, recordFailures);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestDataValidator)
+#include "test_data_validator.moc"
@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <QThread>
+#include "services/IdGenerator.h"
+
+class TestIdGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFormat();
+    void testCounterClaimsAdvance();
+    void testSnowflakeMonotonic();
+    void testRandomClaims();
+    void testClaimNearEndOfIdSpace_data();
+    void testClaimNearEndOfIdSpace();
+    void testTakeOver_data();
+    void testTakeOver();
+    void testConcurrentUniqueness_data();
+    void testConcurrentUniqueness();
+};
+
+void TestIdGenerator::testFormat()
+{
+    QCOMPARE(IdGenerator::format(0xabc), QStringLiteral("0000000000000abc"));
+    quint64 value = 0;
+    QVERIFY(IdGenerator::parse(QStringLiteral("0000000000000abc"), &value));
+    QCOMPARE(value, quint64(0xabc));
+    QVERIFY(!IdGenerator::parse(QStringLiteral("abc"), &value));
+    QVERIFY(!IdGenerator::parse(QStringLiteral("zzzzzzzzzzzzzzzz"), &value));
+}
+
+void TestIdGenerator::testCounterClaimsAdvance()
+{
+    IdGenerator generator(IdGenerator::Counter);
+    QCOMPARE(generator.next(), quint64(1));
+    QVERIFY(generator.claim(IdGenerator::format(100)));
+    QVERIFY(!generator.claim(IdGenerator::format(100)));
+    QVERIFY(generator.isTaken(IdGenerator::format(50)));
+    QCOMPARE(generator.next(), quint64(101));
+    // Foreign ids can never collide with the 16-digit format
+    QVERIFY(generator.claim(QStringLiteral("legacy-id")));
+    QVERIFY(!generator.isTaken(QStringLiteral("legacy-id")));
+}
+
+void TestIdGenerator::testSnowflakeMonotonic()
+{
+    IdGenerator generator(IdGenerator::Snowflake, 7);
+    quint64 previous = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const quint64 id = generator.next();
+        QVERIFY(id > previous);
+        QCOMPARE((id >> 12) & 0x3ff, quint64(7));
+        previous = id;
+    }
+}
+
+void TestIdGenerator::testRandomClaims()
+{
+    IdGenerator generator(IdGenerator::Random64);
+    const QString id = generator.nextId();
+    QVERIFY(generator.isTaken(id));
+    QVERIFY(!generator.claim(id));
+    QVERIFY(generator.claim(IdGenerator::format(42)));
+    QVERIFY(generator.isTaken(IdGenerator::format(42)));
+}
+
+void TestIdGenerator::testClaimNearEndOfIdSpace_data()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::newRow("counter") << int(IdGenerator::Counter);
+    QTest::newRow("snowflake") << int(IdGenerator::Snowflake);
+}
+
+void TestIdGenerator::testClaimNearEndOfIdSpace()
+{
+    QFETCH(int, strategy);
+    IdGenerator generator(IdGenerator::Strategy(strategy));
+    const quint64 first = generator.next();
+
+    // Advancing to these would wrap the next id back to the start
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Refusing to reserve id"));
+    QVERIFY(!generator.claim(IdGenerator::format(~quint64(0))));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Refusing to reserve id"));
+    QVERIFY(!generator.claim(IdGenerator::format(~quint64(0) - 5)));
+    QVERIFY(!generator.isTaken(IdGenerator::format(~quint64(0))));
+
+    const quint64 second = generator.next();
+    QVERIFY(second > first);
+    QVERIFY(second < (quint64(1) << 63));
+
+    // Far from the end is fine
+    const quint64 high = quint64(1) << 62;
+    QVERIFY(generator.claim(IdGenerator::format(high)));
+    QVERIFY(generator.next() > high);
+}
+
+void TestIdGenerator::testTakeOver_data()
+{
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("to");
+    const char *const names[] = {"counter", "snowflake", "random64"};
+    for (int from = IdGenerator::Counter; from <= IdGenerator::Random64; ++from) {
+        for (int to = IdGenerator::Counter; to <= IdGenerator::Random64; ++to) {
+            QTest::addRow("%s to %s", names[from], names[to]) << from << to;
+        }
+    }
+}
+
+void TestIdGenerator::testTakeOver()
+{
+    QFETCH(int, from);
+    QFETCH(int, to);
+
+    IdGenerator previous{IdGenerator::Strategy(from)};
+    QSet<quint64> issued;
+    for (int i = 0; i < 2000; ++i) {
+        issued.insert(previous.next());
+    }
+    // Small values are what a counter hands out first
+    for (quint64 value = 1; value <= 100; ++value) {
+        if (previous.claim(IdGenerator::format(value))) {
+            issued.insert(value);
+        }
+    }
+
+    IdGenerator successor{IdGenerator::Strategy(to)};
+    successor.takeOver(previous);
+    for (quint64 value : std::as_const(issued)) {
+        QVERIFY(successor.isTaken(IdGenerator::format(value)));
+        QVERIFY(!successor.claim(IdGenerator::format(value)));
+    }
+    for (int i = 0; i < 20000; ++i) {
+        const quint64 value = successor.next();
+        QVERIFY2(!issued.contains(value), qPrintable(IdGenerator::format(value)));
+        issued.insert(value);
+    }
+}
+
+void TestIdGenerator::testConcurrentUniqueness_data()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::newRow("counter") << int(IdGenerator::Counter);
+    QTest::newRow("snowflake") << int(IdGenerator::Snowflake);
+    QTest::newRow("random64") << int(IdGenerator::Random64);
+}
+
+void TestIdGenerator::testConcurrentUniqueness()
+{
+    QFETCH(int, strategy);
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+
+    IdGenerator generator(IdGenerator::Strategy(strategy));
+    QList<QList<quint64>> produced(kThreads);
+    QList<QThread *> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        QList<quint64> *out = &produced[t];
+        threads.append(QThread::create([&generator, out]() {
+            out->reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                out->append(generator.next());
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        thread->wait();
+        delete thread;
+    }
+
+    QSet<quint64> unique;
+    for (const QList<quint64> &ids : std::as_const(produced)) {
+        for (quint64 id : ids) {
+            unique.insert(id);
+        }
+    }
+    QCOMPARE(unique.size(), kThreads * kPerThread);
+}
+
+QTEST_GUILESS_MAIN(TestIdGenerator)
+#include "test_id_generator.moc"
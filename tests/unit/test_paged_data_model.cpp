@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryFile>
+#include "models/PagedDataModel.h"
+
+class TestPagedDataModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFetchMore();
+    void testEviction();
+    void testJsonLinesSource();
+
+private:
+    static DataSource *makeGenerator(int count);
+};
+
+DataSource *TestPagedDataModel::makeGenerator(int count)
+{
+    return new GeneratorDataSource(count, [](int row) {
+        return DataItem{QString::number(row), QString("Row %1").arg(row), QString(), row, true};
+    });
+}
+
+void TestPagedDataModel::testFetchMore()
+{
+    PagedDataModel model;
+    model.setPageSize(100);
+    model.setSource(makeGenerator(250));
+
+    QCOMPARE(model.getCount(), 250);
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    QSignalSpy rowsInsertedSpy(&model, &PagedDataModel::rowsInserted);
+    model.fetchMore(QModelIndex());
+    model.fetchMore(QModelIndex());
+    model.fetchMore(QModelIndex());
+
+    QCOMPARE(rowsInsertedSpy.count(), 3);
+    QCOMPARE(model.rowCount(), 250);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(model.data(model.index(249), DataModel::ValueRole).toInt(), 249);
+}
+
+void TestPagedDataModel::testEviction()
+{
+    PagedDataModel model;
+    model.setPageSize(10);
+    model.setMaxCachedPages(3);
+    model.setSource(makeGenerator(1000));
+
+    for (int row = 0; row < 1000; row += 10) {
+        QCOMPARE(model.getItem(row)["value"].toInt(), row);
+        QVERIFY(model.cachedPageCount() <= 3);
+    }
+
+    // Evicted pages are re-read transparently.
+    QCOMPARE(model.getItem(5)["name"].toString(), QString("Row 5"));
+}
+
+void TestPagedDataModel::testJsonLinesSource()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 600; ++i) {
+        file.write(QString("{\"name\":\"Line %1\",\"value\":%1}\n").arg(i).toUtf8());
+        if (i % 100 == 0) {
+            file.write("\n");
+        }
+    }
+    file.flush();
+
+    PagedDataModel model;
+    QVERIFY(model.openFile(file.fileName()));
+    QCOMPARE(model.getCount(), 600);
+    QCOMPARE(model.getItem(0)["value"].toInt(), 0);
+    QCOMPARE(model.getItem(257)["name"].toString(), QString("Line 257"));
+    QCOMPARE(model.getItem(599)["value"].toInt(), 599);
+    QCOMPARE(model.getItem(599)["id"].toString(), QString("599"));
+}
+
+QTEST_APPLESS_MAIN(TestPagedDataModel)
+#include "test_paged_data_model.moc"
@@ -0,0 +1,258 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include "plugin/PluginCache.h"
+
+class TestPluginCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testHit();
+    void testSizeChangeInvalidates();
+    void testModifiedTimeChangeInvalidates();
+    void testRetainDropsRemovedFiles();
+    void testSaveAndLoad();
+    void testSaveOnlyWhenChanged();
+    void testRejectsCorruptFile_data();
+    void testRejectsCorruptFile();
+    void testRejectsOtherVersion();
+    void testPluginName();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+
+    QString cachePath() const;
+    QString writeLibrary(const QString &name, const QByteArray &data);
+    static QJsonObject metaData(const QString &name);
+    static void writeFile(const QString &path, const QByteArray &data);
+};
+
+void TestPluginCache::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void TestPluginCache::cleanup()
+{
+    delete m_dir;
+}
+
+QString TestPluginCache::cachePath() const
+{
+    return m_dir->filePath("cache/plugin-cache.json");
+}
+
+QString TestPluginCache::writeLibrary(const QString &name, const QByteArray &data)
+{
+    const QString path = m_dir->filePath("plugins/" + name);
+    writeFile(path, data);
+    return path;
+}
+
+QJsonObject TestPluginCache::metaData(const QString &name)
+{
+    return QJsonObject{
+        {"IID", "com.template.test"},
+        {"MetaData", QJsonObject{{"name", name}, {"description", name + " plugin"}}},
+    };
+}
+
+void TestPluginCache::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+}
+
+void TestPluginCache::testHit()
+{
+    const QString path = writeLibrary("libalpha.so", "alpha library");
+    PluginCache cache(cachePath());
+    cache.insert(QFileInfo(path), metaData("Alpha"));
+    QCOMPARE(cache.size(), 1);
+
+    QJsonObject cached;
+    QVERIFY(cache.lookup(QFileInfo(path), &cached));
+    QCOMPARE(cached, metaData("Alpha"));
+
+    // Keyed by absolute path
+    QVERIFY(!cache.lookup(QFileInfo(writeLibrary("libbeta.so", "alpha library")), &cached));
+}
+
+void TestPluginCache::testSizeChangeInvalidates()
+{
+    const QString path = writeLibrary("libalpha.so", "alpha library");
+    PluginCache cache(cachePath());
+    cache.insert(QFileInfo(path), metaData("Alpha"));
+
+    // Keep the modification time, so only the size differs
+    const QDateTime modified = QFileInfo(path).lastModified();
+    writeFile(path, "alpha library, rebuilt");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+    file.close();
+
+    QJsonObject cached;
+    QVERIFY(!cache.lookup(QFileInfo(path), &cached));
+}
+
+void TestPluginCache::testModifiedTimeChangeInvalidates()
+{
+    const QString path = writeLibrary("libalpha.so", "alpha library");
+    PluginCache cache(cachePath());
+    cache.insert(QFileInfo(path), metaData("Alpha"));
+
+    // Same size, newer file
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QFileInfo(path).lastModified().addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+
+    QJsonObject cached;
+    QVERIFY(!cache.lookup(QFileInfo(path), &cached));
+
+    // Re-inserting records the new state
+    cache.insert(QFileInfo(path), metaData("Alpha 2"));
+    QVERIFY(cache.lookup(QFileInfo(path), &cached));
+    QCOMPARE(cached, metaData("Alpha 2"));
+}
+
+void TestPluginCache::testRetainDropsRemovedFiles()
+{
+    const QString alpha = writeLibrary("libalpha.so", "alpha");
+    const QString beta = writeLibrary("libbeta.so", "beta");
+    PluginCache cache(cachePath());
+    cache.insert(QFileInfo(alpha), metaData("Alpha"));
+    cache.insert(QFileInfo(beta), metaData("Beta"));
+    QVERIFY(cache.save());
+
+    QVERIFY(QFile::remove(beta));
+    cache.retain({QFileInfo(alpha).absoluteFilePath()});
+    QCOMPARE(cache.size(), 1);
+    QVERIFY(cache.save());
+
+    // The dropped entry is gone from the file too
+    PluginCache reloaded(cachePath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.size(), 1);
+    QJsonObject cached;
+    QVERIFY(reloaded.lookup(QFileInfo(alpha), &cached));
+    QCOMPARE(cached, metaData("Alpha"));
+}
+
+void TestPluginCache::testSaveAndLoad()
+{
+    const QString alpha = writeLibrary("libalpha.so", "alpha");
+    const QString beta = writeLibrary("libbeta.so", "beta");
+    {
+        PluginCache cache(cachePath());
+        QVERIFY(!cache.load());
+        cache.insert(QFileInfo(alpha), metaData("Alpha"));
+        cache.insert(QFileInfo(beta), metaData("Beta"));
+        QVERIFY(cache.save());
+    }
+
+    PluginCache cache(cachePath());
+    QVERIFY(cache.load());
+    QCOMPARE(cache.size(), 2);
+    QJsonObject cached;
+    QVERIFY(cache.lookup(QFileInfo(beta), &cached));
+    QCOMPARE(cached, metaData("Beta"));
+
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.save());
+    QVERIFY(cache.load());
+    QCOMPARE(cache.size(), 0);
+}
+
+void TestPluginCache::testSaveOnlyWhenChanged()
+{
+    const QString alpha = writeLibrary("libalpha.so", "alpha");
+    PluginCache cache(cachePath());
+    cache.insert(QFileInfo(alpha), metaData("Alpha"));
+    QVERIFY(cache.save());
+    QVERIFY(QFile::exists(cachePath()));
+
+    // Nothing changed since: no write
+    QVERIFY(QFile::remove(cachePath()));
+    QVERIFY(cache.save());
+    QVERIFY(!QFile::exists(cachePath()));
+
+    // Nor after a load that changed nothing
+    cache.insert(QFileInfo(alpha), metaData("Alpha"));
+    QVERIFY(cache.save());
+    QVERIFY(cache.load());
+    cache.retain({QFileInfo(alpha).absoluteFilePath()});
+    QVERIFY(QFile::remove(cachePath()));
+    QVERIFY(cache.save());
+    QVERIFY(!QFile::exists(cachePath()));
+}
+
+void TestPluginCache::testRejectsCorruptFile_data()
+{
+    QTest::addColumn<QByteArray>("contents");
+    QTest::newRow("not json") << QByteArray("not a cache at all");
+    QTest::newRow("truncated") << QByteArray("{ \"version\": 1, \"plugins\": [ { \"path\": ");
+    QTest::newRow("array") << QByteArray("[1, 2, 3]");
+}
+
+void TestPluginCache::testRejectsCorruptFile()
+{
+    QFETCH(QByteArray, contents);
+    writeFile(cachePath(), contents);
+
+    PluginCache cache(cachePath());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Ignoring unreadable plugin cache"));
+    QVERIFY(!cache.load());
+    QCOMPARE(cache.size(), 0);
+
+    // The next save replaces it with a readable one
+    cache.insert(QFileInfo(writeLibrary("libalpha.so", "alpha")), metaData("Alpha"));
+    QVERIFY(cache.save());
+    QVERIFY(PluginCache(cachePath()).load());
+}
+
+void TestPluginCache::testRejectsOtherVersion()
+{
+    const QString alpha = writeLibrary("libalpha.so", "alpha");
+    const QFileInfo info(alpha);
+    const QJsonObject entry{
+        {"path", info.absoluteFilePath()},
+        {"size", info.size()},
+        {"modified", info.lastModified().toMSecsSinceEpoch()},
+        {"metaData", metaData("Alpha")},
+    };
+    writeFile(cachePath(), QJsonDocument(QJsonObject{{"version", 2}, {"plugins", QJsonArray{entry}}}).toJson());
+
+    // Entries of another layout are not trusted, even when they would match
+    PluginCache cache(cachePath());
+    QVERIFY(!cache.load());
+    QCOMPARE(cache.size(), 0);
+    QJsonObject cached;
+    QVERIFY(!cache.lookup(info, &cached));
+
+    // The same entry under the current version is a hit
+    writeFile(cachePath(), QJsonDocument(QJsonObject{{"version", 1}, {"plugins", QJsonArray{entry}}}).toJson());
+    QVERIFY(cache.load());
+    QVERIFY(cache.lookup(info, &cached));
+}
+
+void TestPluginCache::testPluginName()
+{
+    QCOMPARE(PluginCache::pluginName(metaData("Alpha"), "fallback"), QStringLiteral("Alpha"));
+    QCOMPARE(PluginCache::pluginName(QJsonObject(), "fallback"), QStringLiteral("fallback"));
+    QCOMPARE(PluginCache::pluginData(metaData("Alpha")).value("description").toString(),
+             QStringLiteral("Alpha plugin"));
+}
+
+QTEST_GUILESS_MAIN(TestPluginCache)
+#include "test_plugin_cache.moc"
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "plugin/PluginManager.h"
+
+// loadPlugins() opens the libraries in parallel and registers them in file
+// order, against the plugins built from tests/unit/plugins.
+class TestPluginLoading : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRegistersInFileOrder();
+    void testStartupSkipsLazyAndDisabled();
+    void testDuplicateNameLoadsOnce();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    PluginManager *m_manager = nullptr;
+
+    static QString pluginDir();
+    static QString pluginPath(const QString &name);
+    void ignoreGammaWarning();
+};
+
+void TestPluginLoading::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_manager = new PluginManager();
+    m_manager->setCachePath(m_dir->filePath("plugin-cache.json"));
+}
+
+void TestPluginLoading::cleanup()
+{
+    delete m_manager;
+    delete m_dir;
+}
+
+QString TestPluginLoading::pluginDir()
+{
+    return QStringLiteral(TEST_PLUGIN_DIR);
+}
+
+QString TestPluginLoading::pluginPath(const QString &name)
+{
+    return pluginDir() + "/libtest_plugin_" + name + ".so";
+}
+
+void TestPluginLoading::ignoreGammaWarning()
+{
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("calls itself \"GammaRuntime\""));
+}
+
+void TestPluginLoading::testRegistersInFileOrder()
+{
+    QSignalSpy loadedSpy(m_manager, &PluginManager::pluginLoaded);
+    QSignalSpy errorSpy(m_manager, &PluginManager::pluginError);
+    ignoreGammaWarning();
+    QVERIFY(m_manager->loadPlugins(pluginDir()));
+
+    QStringList loaded;
+    for (const QList<QVariant> &arguments : std::as_const(loadedSpy)) {
+        loaded.append(arguments.first().toString());
+    }
+    QCOMPARE(loaded, (QStringList{"Alpha", "Beta", "Gamma"}));
+    QCOMPARE(errorSpy.count(), 0);
+
+    // A second call loads nothing new
+    QVERIFY(m_manager->loadPlugins(pluginDir()));
+    QCOMPARE(loadedSpy.count(), 3);
+    QCOMPARE(errorSpy.count(), 0);
+}
+
+void TestPluginLoading::testStartupSkipsLazyAndDisabled()
+{
+    m_manager->setDisabledPlugins({"Beta"});
+    ignoreGammaWarning();
+    QVERIFY(m_manager->loadPlugins(pluginDir()));
+
+    QVERIFY(m_manager->isPluginLoaded("Alpha"));
+    QVERIFY(m_manager->isPluginLoaded("Gamma"));
+    QVERIFY(!m_manager->isPluginLoaded("Beta"));
+    QVERIFY(!m_manager->isPluginLoaded("Lazy"));
+    QCOMPARE(m_manager->loadedPlugins().size(), 2);
+
+    const QVariantMap beta = m_manager->getPluginInfo("Beta");
+    QCOMPARE(beta.value("enabled").toBool(), false);
+    QCOMPARE(beta.value("loaded").toBool(), false);
+    QCOMPARE(m_manager->getPluginInfo("Alpha").value("loaded").toBool(), true);
+}
+
+void TestPluginLoading::testDuplicateNameLoadsOnce()
+{
+    // Two files that both call themselves "Alpha"
+    const QString dir = m_dir->filePath("duplicates");
+    QVERIFY(QDir().mkpath(dir));
+    const QString first = dir + "/libtest_plugin_alpha.so";
+    const QString second = dir + "/libtest_plugin_alpha_copy.so";
+    QVERIFY(QFile::copy(pluginPath("alpha"), first));
+    QVERIFY(QFile::copy(pluginPath("alpha"), second));
+
+    QSignalSpy loadedSpy(m_manager, &PluginManager::pluginLoaded);
+    QSignalSpy errorSpy(m_manager, &PluginManager::pluginError);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Duplicate plugin name \"Alpha\""));
+    QVERIFY(!m_manager->loadPlugins(dir));
+
+    QCOMPARE(loadedSpy.count(), 1);
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(errorSpy.first().at(0).toString(), QStringLiteral("Alpha"));
+    QCOMPARE(errorSpy.first().at(1).toString(), QStringLiteral("Duplicate plugin name"));
+    QCOMPARE(m_manager->loadedPlugins().size(), 1);
+
+    // The first file in name order won, and the other was never opened
+    QVERIFY(QPluginLoader(first).isLoaded());
+    QVERIFY(!QPluginLoader(second).isLoaded());
+}
+
+QTEST_GUILESS_MAIN(TestPluginLoading)
+#include "test_plugin_loading.moc"
@@ -0,0 +1,196 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <functional>
+#include "plugin/PluginManager.h"
+
+// Runs against the plugins built from tests/unit/plugins:
+//   Alpha  loaded at startup
+//   Beta   loaded at startup, disabled by the tests
+//   Gamma  metadata name "Gamma", name() "GammaRuntime"
+//   Lazy   "loadOnStartup": false
+class TestPluginManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testScanOpensNoLibrary();
+    void testCachedMetadataIsUsed();
+    void testLoadPluginByName();
+    void testMetadataNameIsTheKey();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    PluginManager *m_manager = nullptr;
+
+    QString cachePath() const;
+    static QString pluginDir();
+    static const QStringList &allPlugins();
+    void loadWithBetaDisabled();
+    // Rewrites Alpha's cache entry in place
+    void editAlphaEntry(const std::function<void(QJsonObject &)> &edit);
+};
+
+void TestPluginManager::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_manager = new PluginManager();
+    m_manager->setCachePath(cachePath());
+}
+
+void TestPluginManager::cleanup()
+{
+    delete m_manager;
+    delete m_dir;
+}
+
+QString TestPluginManager::cachePath() const
+{
+    return m_dir->filePath("plugin-cache.json");
+}
+
+QString TestPluginManager::pluginDir()
+{
+    return QStringLiteral(TEST_PLUGIN_DIR);
+}
+
+const QStringList &TestPluginManager::allPlugins()
+{
+    static const QStringList names{"Alpha", "Beta", "Gamma", "Lazy"};
+    return names;
+}
+
+void TestPluginManager::loadWithBetaDisabled()
+{
+    m_manager->setDisabledPlugins({"Beta"});
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("calls itself \"GammaRuntime\""));
+    QVERIFY(m_manager->loadPlugins(pluginDir()));
+}
+
+void TestPluginManager::editAlphaEntry(const std::function<void(QJsonObject &)> &edit)
+{
+    QFile file(cachePath());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    QJsonArray plugins = root.value("plugins").toArray();
+    bool found = false;
+    for (qsizetype i = 0; i < plugins.size(); ++i) {
+        QJsonObject entry = plugins.at(i).toObject();
+        if (QFileInfo(entry.value("path").toString()).baseName().contains("alpha")) {
+            edit(entry);
+            plugins[i] = entry;
+            found = true;
+        }
+    }
+    QVERIFY(found);
+    root["plugins"] = plugins;
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QJsonDocument(root).toJson());
+}
+
+void TestPluginManager::testScanOpensNoLibrary()
+{
+    QVERIFY(m_manager->scanPlugins(pluginDir()));
+    QCOMPARE(m_manager->availablePlugins(), allPlugins());
+    QVERIFY(m_manager->loadedPlugins().isEmpty());
+
+    const QVariantMap lazy = m_manager->getPluginInfo("Lazy");
+    QCOMPARE(lazy.value("name").toString(), QStringLiteral("Lazy"));
+    QCOMPARE(lazy.value("description").toString(), QStringLiteral("Loaded on demand"));
+    QCOMPARE(lazy.value("loaded").toBool(), false);
+    QVERIFY(m_manager->getPluginInfo("Missing").isEmpty());
+
+    // Every file was recorded for the next start
+    PluginCache cache(cachePath());
+    QVERIFY(cache.load());
+    QCOMPARE(cache.size(), allPlugins().size());
+}
+
+void TestPluginManager::testCachedMetadataIsUsed()
+{
+    QVERIFY(m_manager->scanPlugins(pluginDir()));
+
+    // An unchanged file is described from the cache, not the library
+    editAlphaEntry([](QJsonObject &entry) {
+        QJsonObject metaData = entry.value("metaData").toObject();
+        QJsonObject pluginData = metaData.value("MetaData").toObject();
+        pluginData["description"] = "From the cache";
+        metaData["MetaData"] = pluginData;
+        entry["metaData"] = metaData;
+    });
+    {
+        PluginManager warm;
+        warm.setCachePath(cachePath());
+        QVERIFY(warm.scanPlugins(pluginDir()));
+        QCOMPARE(warm.getPluginInfo("Alpha").value("description").toString(), QStringLiteral("From the cache"));
+    }
+
+    // An entry recorded for another modification time is read again
+    editAlphaEntry([](QJsonObject &entry) { entry["modified"] = 0; });
+    PluginManager refreshed;
+    refreshed.setCachePath(cachePath());
+    QVERIFY(refreshed.scanPlugins(pluginDir()));
+    QCOMPARE(refreshed.getPluginInfo("Alpha").value("description").toString(), QStringLiteral("Loaded at startup"));
+}
+
+void TestPluginManager::testLoadPluginByName()
+{
+    loadWithBetaDisabled();
+    QSignalSpy loadedSpy(m_manager, &PluginManager::pluginLoaded);
+
+    QVERIFY(m_manager->loadPluginByName("Lazy"));
+    QVERIFY(m_manager->isPluginLoaded("Lazy"));
+    QCOMPARE(loadedSpy.count(), 1);
+    QCOMPARE(loadedSpy.first().first().toString(), QStringLiteral("Lazy"));
+
+    // Already loaded: nothing happens
+    QVERIFY(m_manager->loadPluginByName("Lazy"));
+    QVERIFY(m_manager->loadPluginByName("Alpha"));
+    QCOMPARE(loadedSpy.count(), 1);
+
+    // Asking by name overrides the disabled list
+    QVERIFY(m_manager->loadPluginByName("Beta"));
+    QVERIFY(m_manager->isPluginLoaded("Beta"));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Plugin not found"));
+    QVERIFY(!m_manager->loadPluginByName("Missing"));
+
+    QVERIFY(m_manager->unloadPlugin("Lazy"));
+    QVERIFY(!m_manager->isPluginLoaded("Lazy"));
+    QVERIFY(m_manager->loadPluginByName("Lazy"));
+}
+
+void TestPluginManager::testMetadataNameIsTheKey()
+{
+    loadWithBetaDisabled();
+
+    IPlugin *gamma = m_manager->getPlugin("Gamma");
+    QVERIFY(gamma);
+    QCOMPARE(gamma->name(), QStringLiteral("GammaRuntime"));
+    QVERIFY(!m_manager->isPluginLoaded("GammaRuntime"));
+
+    // Loading it by name again finds the loaded instance instead of a duplicate
+    QSignalSpy errorSpy(m_manager, &PluginManager::pluginError);
+    QVERIFY(m_manager->loadPluginByName("Gamma"));
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(m_manager->availablePlugins(), allPlugins());
+
+    // Disabling goes by the same name
+    QVERIFY(m_manager->unloadAllPlugins());
+    m_manager->setDisabledPlugins({"Beta", "Gamma"});
+    QVERIFY(m_manager->loadPlugins(pluginDir()));
+    QVERIFY(!m_manager->isPluginLoaded("Gamma"));
+    QVERIFY(m_manager->isPluginLoaded("Alpha"));
+}
+
+QTEST_GUILESS_MAIN(TestPluginManager)
+#include "test_plugin_manager.moc"
@@ -0,0 +1,152 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "core/ResourceManager.h"
+
+// Plugin resources live in their own "plugin:<name>" index type each
+class TestPluginResources : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRegisterAndLookup();
+    void testReRegisterForgetsMisses();
+    void testReRegisterElsewhere();
+    void testUnregisterEvictsCachedPaths();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    ResourceManager *m_manager = nullptr;
+
+    QString pluginDir(const QString &name) const;
+    static void writeFile(const QString &path, const QByteArray &data = "x");
+};
+
+void TestPluginResources::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_manager = new ResourceManager();
+    QVERIFY(m_manager->initialize(m_dir->filePath("resources")));
+}
+
+void TestPluginResources::cleanup()
+{
+    delete m_manager;
+    delete m_dir;
+}
+
+QString TestPluginResources::pluginDir(const QString &name) const
+{
+    return m_dir->filePath("plugins/" + name);
+}
+
+void TestPluginResources::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+}
+
+void TestPluginResources::testRegisterAndLookup()
+{
+    writeFile(pluginDir("alpha") + "/qml/Panel.qml");
+    writeFile(pluginDir("beta") + "/qml/Panel.qml");
+    writeFile(pluginDir("beta") + "/icon.png");
+
+    QSignalSpy registeredSpy(m_manager, &ResourceManager::pluginResourcesRegistered);
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha")));
+    QVERIFY(m_manager->registerPluginResources("Beta", pluginDir("beta")));
+    QCOMPARE(registeredSpy.count(), 2);
+    QCOMPARE(registeredSpy.first().first().toString(), QStringLiteral("Alpha"));
+
+    const QStringList types = m_manager->getRegisteredResourceTypes();
+    QVERIFY(types.contains("plugin:Alpha"));
+    QVERIFY(types.contains("plugin:Beta"));
+
+    // The same name resolves per plugin
+    QCOMPARE(m_manager->getPluginResource("Alpha", "qml/Panel.qml"),
+             QUrl::fromLocalFile(pluginDir("alpha") + "/qml/Panel.qml"));
+    QCOMPARE(m_manager->getPluginResource("Beta", "qml/Panel.qml"),
+             QUrl::fromLocalFile(pluginDir("beta") + "/qml/Panel.qml"));
+    QCOMPARE(m_manager->getPluginResource("Beta", "icon.png"), QUrl::fromLocalFile(pluginDir("beta") + "/icon.png"));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Resource not found: \"icon.png\""));
+    QVERIFY(m_manager->getPluginResource("Alpha", "icon.png").isEmpty());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Plugin resources not registered for: \"Gamma\""));
+    QVERIFY(m_manager->getPluginResource("Gamma", "qml/Panel.qml").isEmpty());
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Invalid plugin resource path"));
+    QVERIFY(!m_manager->registerPluginResources("Gamma", "relative/path"));
+    QVERIFY(!m_manager->getRegisteredResourceTypes().contains("plugin:Gamma"));
+}
+
+void TestPluginResources::testReRegisterForgetsMisses()
+{
+    QDir().mkpath(pluginDir("alpha"));
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha")));
+
+    // The miss is remembered: a file appearing later is not seen by itself
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Resource not found: \"Late.qml\""));
+    QVERIFY(m_manager->getPluginResource("Alpha", "Late.qml").isEmpty());
+    writeFile(pluginDir("alpha") + "/Late.qml");
+    QVERIFY(m_manager->getPluginResource("Alpha", "Late.qml").isEmpty());
+
+    // Registering the plugin again scans it and forgets the miss
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha")));
+    QCOMPARE(m_manager->getPluginResource("Alpha", "Late.qml"), QUrl::fromLocalFile(pluginDir("alpha") + "/Late.qml"));
+}
+
+void TestPluginResources::testReRegisterElsewhere()
+{
+    writeFile(pluginDir("alpha-1.0") + "/Old.qml");
+    writeFile(pluginDir("alpha-1.1") + "/New.qml");
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha-1.0")));
+    QVERIFY(!m_manager->getPluginResource("Alpha", "Old.qml").isEmpty());
+
+    // The old directory is dropped rather than searched as well
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha-1.1")));
+    QCOMPARE(m_manager->getPluginResource("Alpha", "New.qml"), QUrl::fromLocalFile(pluginDir("alpha-1.1") + "/New.qml"));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Resource not found: \"Old.qml\""));
+    QVERIFY(m_manager->getPluginResource("Alpha", "Old.qml").isEmpty());
+}
+
+void TestPluginResources::testUnregisterEvictsCachedPaths()
+{
+    // "alpha" is a string prefix of "alphabet", but not a path prefix
+    const QString alphaFile = pluginDir("alpha") + "/data.json";
+    const QString alphabetFile = pluginDir("alphabet") + "/data.json";
+    writeFile(alphaFile, "alpha 1");
+    writeFile(alphabetFile, "alphabet 1");
+    QVERIFY(m_manager->registerPluginResources("Alpha", pluginDir("alpha")));
+    QVERIFY(m_manager->registerPluginResources("Alphabet", pluginDir("alphabet")));
+
+    QCOMPARE(m_manager->readBinaryResource(alphaFile), QByteArray("alpha 1"));
+    QCOMPARE(m_manager->readBinaryResource(alphabetFile), QByteArray("alphabet 1"));
+
+    // Changed behind the cache's back, without returning to the event loop
+    writeFile(alphaFile, "alpha 2");
+    writeFile(alphabetFile, "alphabet 2");
+    QCOMPARE(m_manager->readBinaryResource(alphaFile), QByteArray("alpha 1"));
+
+    QSignalSpy unregisteredSpy(m_manager, &ResourceManager::pluginResourcesUnregistered);
+    QVERIFY(m_manager->unregisterPluginResources("Alpha"));
+    QCOMPARE(unregisteredSpy.count(), 1);
+    QVERIFY(!m_manager->getRegisteredResourceTypes().contains("plugin:Alpha"));
+
+    // Only the unregistered plugin's paths left the cache
+    QCOMPARE(m_manager->readBinaryResource(alphaFile), QByteArray("alpha 2"));
+    QCOMPARE(m_manager->readBinaryResource(alphabetFile), QByteArray("alphabet 1"));
+
+    QVERIFY(!m_manager->unregisterPluginResources("Alpha"));
+    QCOMPARE(unregisteredSpy.count(), 1);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Plugin resources not registered for: \"Alpha\""));
+    QVERIFY(m_manager->getPluginResource("Alpha", "data.json").isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestPluginResources)
+#include "test_plugin_resources.moc"
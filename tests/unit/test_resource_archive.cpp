@@ -0,0 +1,312 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include "core/ResourceArchive.h"
+#include "core/ResourceManager.h"
+
+class TestResourceArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testPackAndRead();
+    void testEntryNames();
+    void testRejectsCorruptHeader();
+    void testRejectsOutOfBoundsToc();
+    void testCorruptCompressedEntry();
+    void testSizeMismatch();
+    void testMountReadUnmount();
+    void testRemountReplacesEntries();
+    void testSavedFilesOverrideArchive();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    QByteArray m_config;
+    QByteArray m_icon;
+    QByteArray m_qml;
+
+    QString sourceDir() const;
+    QString archivePath() const;
+    bool packSources(const QString &archivePath);
+    static void writeFile(const QString &path, const QByteArray &data);
+    static bool patchFile(const QString &path, qint64 offset, const QByteArray &bytes);
+};
+
+void TestResourceArchive::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+
+    m_config = "{ \"name\": \"archived\" }\n";
+    // Random bytes do not compress, so the icon is stored as is
+    m_icon.resize(4096);
+    QRandomGenerator random(27);
+    for (char &byte : m_icon) {
+        byte = char(random.bounded(256));
+    }
+    // Sorts last, so its payload ends the file
+    m_qml = QByteArray("import QtQuick\nItem { width: 100; height: 100 }\n").repeated(64);
+
+    writeFile(sourceDir() + "/config/app.json", m_config);
+    writeFile(sourceDir() + "/images/icon.png", m_icon);
+    writeFile(sourceDir() + "/qml/Main.qml", m_qml);
+}
+
+void TestResourceArchive::cleanup()
+{
+    delete m_dir;
+}
+
+QString TestResourceArchive::sourceDir() const
+{
+    return m_dir->filePath("sources");
+}
+
+QString TestResourceArchive::archivePath() const
+{
+    return m_dir->filePath("resources.pak");
+}
+
+bool TestResourceArchive::packSources(const QString &archivePath)
+{
+    QString error;
+    const bool packed = ResourceArchive::pack(sourceDir(), archivePath, ResourceArchive::PackOptions(), &error);
+    if (!packed) {
+        qWarning() << error;
+    }
+    return packed;
+}
+
+void TestResourceArchive::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), data.size());
+}
+
+bool TestResourceArchive::patchFile(const QString &path, qint64 offset, const QByteArray &bytes)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadWrite)
+           && file.seek(offset < 0 ? file.size() + offset : offset)
+           && file.write(bytes) == bytes.size();
+}
+
+void TestResourceArchive::testPackAndRead()
+{
+    QVERIFY(packSources(archivePath()));
+
+    ResourceArchive archive;
+    QVERIFY(archive.open(archivePath()));
+    QCOMPARE(archive.entryCount(), 3);
+    QVERIFY(archive.contains("qml/Main.qml"));
+    QVERIFY(!archive.contains("qml/Other.qml"));
+
+    QCOMPARE(archive.read("config/app.json"), m_config);
+    QCOMPARE(archive.read("images/icon.png"), m_icon);
+    QCOMPARE(archive.read("qml/Main.qml"), m_qml);
+    QVERIFY(archive.read("missing").isNull());
+
+    QVERIFY(archive.isCompressed("qml/Main.qml"));
+    QVERIFY(!archive.isCompressed("images/icon.png"));
+
+    archive.close();
+    QVERIFY(!archive.isOpen());
+    QCOMPARE(archive.entryCount(), 0);
+}
+
+void TestResourceArchive::testEntryNames()
+{
+    writeFile(sourceDir() + "/qml/views/List.qml", "Item {}\n");
+    writeFile(sourceDir() + "/qmlextra/Other.qml", "Item {}\n");
+    QVERIFY(packSources(archivePath()));
+
+    ResourceArchive archive;
+    QVERIFY(archive.open(archivePath()));
+    QCOMPARE(archive.entryNames("qml/"), (QStringList{"qml/Main.qml", "qml/views/List.qml"}));
+    QCOMPARE(archive.entryNames().size(), 5);
+    QVERIFY(archive.entryNames("fonts/").isEmpty());
+}
+
+void TestResourceArchive::testRejectsCorruptHeader()
+{
+    QVERIFY(packSources(archivePath()));
+    QVERIFY(patchFile(archivePath(), 0, "XXXX"));
+
+    ResourceArchive archive;
+    QVERIFY(!archive.open(archivePath()));
+    QVERIFY(!archive.isOpen());
+    QVERIFY(!archive.errorString().isEmpty());
+
+    // Shorter than a header
+    const QString truncated = m_dir->filePath("truncated.pak");
+    writeFile(truncated, "QRPK");
+    QVERIFY(!archive.open(truncated));
+}
+
+void TestResourceArchive::testRejectsOutOfBoundsToc()
+{
+    QVERIFY(packSources(archivePath()));
+
+    // An entry count far past the end of the file
+    QByteArray count(4, '\0');
+    qToLittleEndian<quint32>(0x00ffffff, count.data());
+    QVERIFY(patchFile(archivePath(), 8, count));
+
+    ResourceArchive archive;
+    QVERIFY(!archive.open(archivePath()));
+
+    // An entry whose payload runs past the end: first toc entry's stored size
+    QVERIFY(packSources(archivePath()));
+    QByteArray size(4, '\0');
+    qToLittleEndian<quint32>(0x7fffffff, size.data());
+    QVERIFY(patchFile(archivePath(), 32 + 16, size));
+    QVERIFY(!archive.open(archivePath()));
+}
+
+void TestResourceArchive::testCorruptCompressedEntry()
+{
+    QVERIFY(packSources(archivePath()));
+
+    // The format has no checksum of its own; compressed entries carry zlib's
+    // Adler-32 at the end of the stream, which ends the file here.
+    QVERIFY(patchFile(archivePath(), -2, QByteArray(2, '\x5a')));
+
+    ResourceArchive archive;
+    QVERIFY(archive.open(archivePath()));
+    QVERIFY(archive.isCompressed("qml/Main.qml"));
+    bool ok = true;
+    QVERIFY(archive.read("qml/Main.qml", &ok).isEmpty());
+    QVERIFY(!ok);
+    // Other entries are unaffected
+    QCOMPARE(archive.read("images/icon.png", &ok), m_icon);
+    QVERIFY(ok);
+}
+
+void TestResourceArchive::testSizeMismatch()
+{
+    const QString base = m_dir->filePath("app");
+    QVERIFY(packSources(base + ".pak"));
+
+    // originalSize of the toc entries for images/icon.png (stored) and qml/Main.qml (compressed)
+    QByteArray size(4, '\0');
+    qToLittleEndian<quint32>(quint32(m_icon.size() - 1), size.data());
+    QVERIFY(patchFile(base + ".pak", 32 + 32 + 20, size));
+    qToLittleEndian<quint32>(quint32(m_qml.size() + 1), size.data());
+    QVERIFY(patchFile(base + ".pak", 32 + 2 * 32 + 20, size));
+
+    ResourceArchive archive;
+    QVERIFY(archive.open(base + ".pak"));
+    bool ok = true;
+    QVERIFY(archive.read("images/icon.png", &ok).isNull());
+    QVERIFY(!ok);
+    QVERIFY(archive.read("qml/Main.qml", &ok).isNull());
+    QVERIFY(!ok);
+    QCOMPARE(archive.read("config/app.json", &ok), m_config);
+    QVERIFY(ok);
+    archive.close();
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    QSignalSpy errorSpy(&manager, &ResourceManager::resourceError);
+    QVERIFY(manager.readBinaryResource(base + "/qml/Main.qml").isEmpty());
+    QVERIFY(manager.imageData("icon.png").isEmpty());
+    QCOMPARE(errorSpy.count(), 2);
+    QCOMPARE(errorSpy.at(0).at(0).toString(), base + "/qml/Main.qml");
+    QCOMPARE(errorSpy.at(1).at(0).toString(), base + "/images/icon.png");
+}
+
+void TestResourceArchive::testMountReadUnmount()
+{
+    const QString base = m_dir->filePath("app");
+    QVERIFY(packSources(base + ".pak"));
+
+    // initialize() mounts "<base>.pak" when present; nothing of it exists on disk
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    QVERIFY(manager.hasArchive());
+
+    QVERIFY(manager.resourceExists(base + "/config/app.json"));
+    QCOMPARE(manager.readBinaryResource(base + "/config/app.json"), m_config);
+    QCOMPARE(manager.readBinaryResource(base + "/qml/Main.qml"), m_qml);
+    QVERIFY(manager.getAvailableQmlResources().contains("Main.qml"));
+    QCOMPARE(manager.getResourcePath("qml", "Main.qml"), base + "/qml/Main.qml");
+
+    // Bytes handed out stay valid after the mapping is gone
+    const QByteArray icon = manager.imageData("icon.png");
+    const QByteArray stored = manager.readBinaryResource(base + "/images/icon.png");
+    QCOMPARE(icon, m_icon);
+
+    manager.unmountArchive();
+    QVERIFY(!manager.hasArchive());
+    QCOMPARE(icon, m_icon);
+    QCOMPARE(stored, m_icon);
+
+    QVERIFY(!manager.resourceExists(base + "/config/app.json"));
+    QVERIFY(manager.imageData("icon.png").isEmpty());
+    QVERIFY(!manager.getAvailableQmlResources().contains("Main.qml"));
+}
+
+void TestResourceArchive::testRemountReplacesEntries()
+{
+    const QString base = m_dir->filePath("app");
+    QVERIFY(packSources(base + ".pak"));
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    QCOMPARE(manager.readBinaryResource(base + "/qml/Main.qml"), m_qml);
+
+    // The compressed entry was cached; a new archive must not serve it
+    const QByteArray updated = QByteArray("import QtQuick\nRectangle {}\n").repeated(64);
+    writeFile(sourceDir() + "/qml/Main.qml", updated);
+    const QString second = m_dir->filePath("second.pak");
+    QVERIFY(packSources(second));
+
+    QVERIFY(manager.mountArchive(second));
+    QCOMPARE(manager.readBinaryResource(base + "/qml/Main.qml"), updated);
+
+    // A broken archive leaves the mounted one in place
+    writeFile(m_dir->filePath("broken.pak"), "not an archive at all, but long enough");
+    QVERIFY(!manager.mountArchive(m_dir->filePath("broken.pak")));
+    QVERIFY(manager.hasArchive());
+    QCOMPARE(manager.readBinaryResource(base + "/qml/Main.qml"), updated);
+}
+
+void TestResourceArchive::testSavedFilesOverrideArchive()
+{
+    const QString base = m_dir->filePath("app");
+    QVERIFY(packSources(base + ".pak"));
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    QCOMPARE(manager.loadConfig("app").value("name").toString(), QStringLiteral("archived"));
+
+    // Saving over an archived config writes a loose file that later reads prefer
+    QVERIFY(manager.saveConfig("app", {{"name", "saved"}}));
+    QVERIFY(manager.flush());
+    QVERIFY(QFile::exists(base + "/config/app.json"));
+    manager.clearCache();
+    QCOMPARE(manager.loadConfig("app").value("name").toString(), QStringLiteral("saved"));
+
+    const QByteArray icon("loose icon");
+    QVERIFY(manager.saveResource(base + "/images/icon.png", icon));
+    QVERIFY(manager.flush());
+    QCOMPARE(manager.imageData("icon.png"), icon);
+
+    // A fresh start over the same archive still finds the loose files first
+    ResourceManager restarted;
+    QVERIFY(restarted.initialize(base));
+    QVERIFY(restarted.hasArchive());
+    QCOMPARE(restarted.loadConfig("app").value("name").toString(), QStringLiteral("saved"));
+    QCOMPARE(restarted.readBinaryResource(base + "/images/icon.png"), icon);
+    QCOMPARE(restarted.imageData("icon.png"), icon);
+    QCOMPARE(restarted.readBinaryResource(base + "/qml/Main.qml"), m_qml);
+}
+
+QTEST_GUILESS_MAIN(TestResourceArchive)
+#include "test_resource_archive.moc"
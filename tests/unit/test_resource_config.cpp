@@ -0,0 +1,137 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "core/ResourceManager.h"
+
+class TestResourceConfig : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testSaveThenReload();
+    void testWriteBehindSaveIsReadBack();
+    void testKeyPaths();
+    void testDiskEditIsSeen();
+    void testInvalidateDropsParsedConfig();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    ResourceManager *m_manager = nullptr;
+
+    QString basePath() const;
+    QString configPath() const;
+    static QVariantMap sampleConfig();
+    static void writeFile(const QString &path, const QByteArray &data);
+};
+
+void TestResourceConfig::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    // saveConfig() writes configs the index already knows
+    writeFile(configPath(), "{}");
+
+    m_manager = new ResourceManager();
+    QVERIFY(m_manager->initialize(basePath()));
+}
+
+void TestResourceConfig::cleanup()
+{
+    delete m_manager;
+    delete m_dir;
+}
+
+QString TestResourceConfig::basePath() const
+{
+    return m_dir->filePath("resources");
+}
+
+QString TestResourceConfig::configPath() const
+{
+    return basePath() + "/config/app.json";
+}
+
+QVariantMap TestResourceConfig::sampleConfig()
+{
+    return {
+        {"name", "sample"},
+        {"network", QVariantMap{{"timeoutMs", 5000}, {"hosts", QVariantList{"a.example", "b.example"}}}},
+    };
+}
+
+void TestResourceConfig::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+}
+
+void TestResourceConfig::testSaveThenReload()
+{
+    m_manager->setWriteBehindEnabled(false);
+    QVERIFY(m_manager->saveConfig("app", sampleConfig()));
+    QCOMPARE(m_manager->loadConfig("app"), sampleConfig());
+
+    // A fresh manager reads what reached the disk
+    ResourceManager reloaded;
+    QVERIFY(reloaded.initialize(basePath()));
+    QCOMPARE(reloaded.loadConfig("app"), sampleConfig());
+    QCOMPARE(reloaded.config("app", "network.timeoutMs").toInt(), 5000);
+}
+
+void TestResourceConfig::testWriteBehindSaveIsReadBack()
+{
+    m_manager->setWriteDebounceInterval(60000);
+    QVERIFY(m_manager->saveConfig("app", sampleConfig()));
+
+    // Served before the write happens
+    QCOMPARE(m_manager->loadConfig("app"), sampleConfig());
+
+    QVERIFY(m_manager->flush());
+    ResourceManager reloaded;
+    QVERIFY(reloaded.initialize(basePath()));
+    QCOMPARE(reloaded.loadConfig("app"), sampleConfig());
+}
+
+void TestResourceConfig::testKeyPaths()
+{
+    m_manager->setWriteBehindEnabled(false);
+    QVERIFY(m_manager->saveConfig("app", sampleConfig()));
+
+    QCOMPARE(m_manager->config("app", "name").toString(), QStringLiteral("sample"));
+    QCOMPARE(m_manager->config("app", "network.hosts.1").toString(), QStringLiteral("b.example"));
+    QCOMPARE(m_manager->configAs<int>("app", "network.timeoutMs"), 5000);
+    QCOMPARE(m_manager->config("app", "network.missing", 7).toInt(), 7);
+    QCOMPARE(m_manager->config("app", "network.hosts.5", "none").toString(), QStringLiteral("none"));
+    QVERIFY(m_manager->configValue("app", "name.deeper").isUndefined());
+    QVERIFY(m_manager->loadConfig("missing").isEmpty());
+}
+
+void TestResourceConfig::testDiskEditIsSeen()
+{
+    m_manager->setWriteBehindEnabled(false);
+    QVERIFY(m_manager->saveConfig("app", sampleConfig()));
+    QCOMPARE(m_manager->config("app", "name").toString(), QStringLiteral("sample"));
+
+    // The saved config is watched like a loaded one: an outside edit evicts it
+    writeFile(configPath(), "{ \"name\": \"edited on disk\" }");
+    QTRY_COMPARE_WITH_TIMEOUT(m_manager->config("app", "name").toString(),
+                              QStringLiteral("edited on disk"), 5000);
+}
+
+void TestResourceConfig::testInvalidateDropsParsedConfig()
+{
+    m_manager->setWriteBehindEnabled(false);
+    QCOMPARE(m_manager->loadConfig("app"), QVariantMap());
+
+    // Without a watcher event, invalidation alone must drop the parsed form
+    writeFile(configPath(), "{ \"name\": \"rewritten\" }");
+    m_manager->invalidateResource(configPath());
+    QCOMPARE(m_manager->config("app", "name").toString(), QStringLiteral("rewritten"));
+}
+
+QTEST_GUILESS_MAIN(TestResourceConfig)
+#include "test_resource_config.moc"
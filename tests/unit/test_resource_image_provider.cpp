@@ -0,0 +1,150 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QImage>
+#include <QColor>
+#include <QQuickImageResponse>
+#include <QQuickTextureFactory>
+#include "core/ResourceManager.h"
+#include "core/ResourceImageProvider.h"
+
+class TestResourceImageProvider : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testDecode();
+    void testScaledDecode();
+    void testRepeatedRequestHitsCache();
+    void testChangedFileIsDecodedAgain();
+    void testClearCache();
+    void testMissingImage();
+
+private:
+    QTemporaryDir m_dir;
+    ResourceImageProvider *m_provider = nullptr;
+
+    QString imagePath(const QString &name) const;
+    static void writeImage(const QString &path, const QSize &size, const QColor &color);
+    // Decoded image and error of one request
+    QImage request(const QString &id, const QSize &requestedSize = QSize(), QString *error = nullptr);
+};
+
+void TestResourceImageProvider::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    // Written before the index is built, so lookups find it without waiting for the watcher
+    QVERIFY(QDir().mkpath(m_dir.filePath("resources/images")));
+    writeImage(imagePath("red.png"), QSize(64, 32), Qt::red);
+    // The provider resolves images through the application-wide manager
+    QVERIFY(ResourceManager::instance()->initialize(m_dir.filePath("resources")));
+}
+
+void TestResourceImageProvider::init()
+{
+    writeImage(imagePath("red.png"), QSize(64, 32), Qt::red);
+    m_provider = new ResourceImageProvider();
+}
+
+void TestResourceImageProvider::cleanup()
+{
+    delete m_provider;
+}
+
+QString TestResourceImageProvider::imagePath(const QString &name) const
+{
+    return m_dir.filePath("resources/images/" + name);
+}
+
+void TestResourceImageProvider::writeImage(const QString &path, const QSize &size, const QColor &color)
+{
+    // Opaque RGB32, which PNG decodes back to without conversion
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(color);
+    QVERIFY(image.save(path, "PNG"));
+    ResourceManager::instance()->invalidateResource(path);
+}
+
+QImage TestResourceImageProvider::request(const QString &id, const QSize &requestedSize, QString *error)
+{
+    QScopedPointer<QQuickImageResponse> response(m_provider->requestImageResponse(id, requestedSize));
+    QSignalSpy finishedSpy(response.data(), &QQuickImageResponse::finished);
+    if (!finishedSpy.wait(5000)) {
+        return QImage();
+    }
+    if (error) {
+        *error = response->errorString();
+    }
+    QScopedPointer<QQuickTextureFactory> factory(response->textureFactory());
+    return factory ? factory->image() : QImage();
+}
+
+void TestResourceImageProvider::testDecode()
+{
+    QString error;
+    const QImage image = request("red.png", QSize(), &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(image.size(), QSize(64, 32));
+    QCOMPARE(image.pixelColor(10, 10), QColor(Qt::red));
+}
+
+void TestResourceImageProvider::testScaledDecode()
+{
+    // Scaled at decode time, keeping the aspect ratio
+    QCOMPARE(request("red.png", QSize(32, 32)).size(), QSize(32, 16));
+    QCOMPARE(request("red.png", QSize(16, 0)).size(), QSize(16, 8));
+    QCOMPARE(request("red.png", QSize(0, 8)).size(), QSize(16, 8));
+}
+
+void TestResourceImageProvider::testRepeatedRequestHitsCache()
+{
+    const QImage first = request("red.png");
+    const QImage second = request("red.png");
+    QVERIFY(!first.isNull());
+    // A cache hit hands out the same decoded pixels, not a second decode
+    QCOMPARE(second.cacheKey(), first.cacheKey());
+
+    // Another size is another entry
+    QVERIFY(request("red.png", QSize(32, 16)).cacheKey() != first.cacheKey());
+}
+
+void TestResourceImageProvider::testChangedFileIsDecodedAgain()
+{
+    const QImage before = request("red.png");
+    QCOMPARE(before.pixelColor(0, 0), QColor(Qt::red));
+
+    writeImage(imagePath("red.png"), QSize(48, 48), Qt::green);
+    const QImage after = request("red.png");
+    QCOMPARE(after.size(), QSize(48, 48));
+    QCOMPARE(after.pixelColor(0, 0), QColor(Qt::green));
+    QVERIFY(after.cacheKey() != before.cacheKey());
+}
+
+void TestResourceImageProvider::testClearCache()
+{
+    const QImage first = request("red.png");
+    m_provider->clearCache();
+    const QImage second = request("red.png");
+    QVERIFY(second.cacheKey() != first.cacheKey());
+    QCOMPARE(second, first);
+
+    // With no budget nothing is kept
+    m_provider->setCacheBudget(0);
+    QCOMPARE(m_provider->cacheBudget(), qint64(0));
+    QVERIFY(request("red.png").cacheKey() != request("red.png").cacheKey());
+}
+
+void TestResourceImageProvider::testMissingImage()
+{
+    QString error;
+    const QImage image = request("missing.png", QSize(), &error);
+    QVERIFY(image.isNull());
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestResourceImageProvider)
+#include "test_resource_image_provider.moc"
@@ -0,0 +1,219 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "core/ResourceIndex.h"
+#include "core/ResourceManager.h"
+
+class TestResourceIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testScanAndLookup();
+    void testEarlierDirectoryWins();
+    void testRefreshEntry();
+    void testRemoveType();
+    void testDebouncedRebuild();
+    void testRebuildFollowsRenamesAndNewDirectories();
+    void testRebuildClearsMissingResources();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+
+    QString path(const QString &relativePath) const;
+    static void writeFile(const QString &path, const QByteArray &data = "x");
+};
+
+void TestResourceIndex::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void TestResourceIndex::cleanup()
+{
+    delete m_dir;
+}
+
+QString TestResourceIndex::path(const QString &relativePath) const
+{
+    return m_dir->filePath(relativePath);
+}
+
+void TestResourceIndex::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+}
+
+void TestResourceIndex::testScanAndLookup()
+{
+    writeFile(path("qml/Main.qml"), "Item {}");
+    writeFile(path("qml/about.qml"));
+    writeFile(path("qml/views/List.qml"));
+    writeFile(path("qml/notes.txt"));
+
+    ResourceIndex index;
+    index.setNameFilters("qml", {"*.qml"});
+    index.addDirectory("qml", path("qml"));
+
+    // Nested files are found by their relative name, in any spelling of it
+    QCOMPARE(index.lookup("qml", "Main.qml"), path("qml/Main.qml"));
+    QCOMPARE(index.lookup("qml", "views/List.qml"), path("qml/views/List.qml"));
+    QCOMPARE(index.lookup("qml", "/views/./List.qml"), path("qml/views/List.qml"));
+    QVERIFY(index.contains("qml", "notes.txt"));
+    QVERIFY(!index.contains("qml", "Missing.qml"));
+    QVERIFY(!index.contains("images", "Main.qml"));
+
+    const ResourceEntry entry = index.entry("qml", "Main.qml");
+    QCOMPARE(entry.size, 7);
+    QVERIFY(entry.lastModified.isValid());
+
+    // Listings hold top-level matches only, sorted without regard to case
+    QCOMPARE(index.listing("qml"), (QStringList{"about.qml", "Main.qml"}));
+    QCOMPARE(index.types(), QStringList{"qml"});
+
+    QString name;
+    QCOMPARE(index.typeForPath(path("qml/views/List.qml"), &name), QStringLiteral("qml"));
+    QCOMPARE(name, QStringLiteral("views/List.qml"));
+    QVERIFY(index.typeForPath(path("qmlextra/Other.qml")).isEmpty());
+}
+
+void TestResourceIndex::testEarlierDirectoryWins()
+{
+    writeFile(path("app/Main.qml"), "app");
+    writeFile(path("plugin/Main.qml"), "plugin");
+    writeFile(path("plugin/Extra.qml"));
+
+    ResourceIndex index;
+    index.addDirectory("qml", path("app"));
+    index.addDirectory("qml", path("plugin"));
+    index.addDirectory("qml", path("app"));
+
+    QCOMPARE(index.directories("qml"), (QStringList{path("app"), path("plugin")}));
+    QCOMPARE(index.lookup("qml", "Main.qml"), path("app/Main.qml"));
+    QCOMPARE(index.lookup("qml", "Extra.qml"), path("plugin/Extra.qml"));
+}
+
+void TestResourceIndex::testRefreshEntry()
+{
+    QDir().mkpath(path("config"));
+    ResourceIndex index;
+    index.addDirectory("config", path("config"));
+    QVERIFY(index.listing("config").isEmpty());
+
+    // Added
+    writeFile(path("config/app.json"), "{}");
+    index.refreshEntry("config", "app.json");
+    QCOMPARE(index.lookup("config", "app.json"), path("config/app.json"));
+    QCOMPARE(index.listing("config"), QStringList{"app.json"});
+
+    // Rewritten
+    writeFile(path("config/app.json"), "{ \"changed\": true }");
+    index.refreshEntry("config", "app.json");
+    QCOMPARE(index.entry("config", "app.json").size, 19);
+
+    // Renamed
+    QVERIFY(QFile::rename(path("config/app.json"), path("config/settings.json")));
+    index.refreshEntry("config", "app.json");
+    index.refreshEntry("config", "settings.json");
+    QVERIFY(!index.contains("config", "app.json"));
+    QCOMPARE(index.lookup("config", "settings.json"), path("config/settings.json"));
+    QCOMPARE(index.listing("config"), QStringList{"settings.json"});
+
+    // Deleted
+    QVERIFY(QFile::remove(path("config/settings.json")));
+    index.refreshEntry("config", "settings.json");
+    QVERIFY(!index.contains("config", "settings.json"));
+    QVERIFY(index.listing("config").isEmpty());
+
+    // Unknown types are left alone
+    index.refreshEntry("images", "icon.png");
+    QVERIFY(!index.types().contains("images"));
+}
+
+void TestResourceIndex::testRemoveType()
+{
+    writeFile(path("images/icon.png"));
+    ResourceIndex index;
+    index.addDirectory("images", path("images"));
+    QVERIFY(index.contains("images", "icon.png"));
+
+    index.removeType("images");
+    QVERIFY(!index.contains("images", "icon.png"));
+    QVERIFY(index.directories("images").isEmpty());
+    QVERIFY(index.typeForPath(path("images/icon.png")).isEmpty());
+
+    // A removed type's directory changes no longer rebuild anything
+    QSignalSpy rebuiltSpy(&index, &ResourceIndex::typeRebuilt);
+    writeFile(path("images/other.png"));
+    QTest::qWait(300);
+    QCOMPARE(rebuiltSpy.count(), 0);
+}
+
+void TestResourceIndex::testDebouncedRebuild()
+{
+    QDir().mkpath(path("qml"));
+    ResourceIndex index;
+    index.addDirectory("qml", path("qml"));
+    QSignalSpy rebuiltSpy(&index, &ResourceIndex::typeRebuilt);
+
+    // Changes in quick succession are picked up by one rebuild, after a delay
+    writeFile(path("qml/A.qml"));
+    writeFile(path("qml/B.qml"));
+    writeFile(path("qml/C.qml"));
+    QVERIFY(!index.contains("qml", "A.qml"));
+    QCOMPARE(rebuiltSpy.count(), 0);
+
+    QTRY_COMPARE(rebuiltSpy.count(), 1);
+    QCOMPARE(rebuiltSpy.first().first().toString(), QStringLiteral("qml"));
+    QCOMPARE(index.listing("qml"), (QStringList{"A.qml", "B.qml", "C.qml"}));
+
+    QVERIFY(QFile::remove(path("qml/B.qml")));
+    QTRY_COMPARE(rebuiltSpy.count(), 2);
+    QCOMPARE(index.listing("qml"), (QStringList{"A.qml", "C.qml"}));
+}
+
+void TestResourceIndex::testRebuildFollowsRenamesAndNewDirectories()
+{
+    writeFile(path("qml/views/List.qml"));
+    ResourceIndex index;
+    index.addDirectory("qml", path("qml"));
+
+    // Subdirectories are watched too
+    QVERIFY(QFile::rename(path("qml/views/List.qml"), path("qml/views/Grid.qml")));
+    QTRY_VERIFY(index.contains("qml", "views/Grid.qml"));
+    QVERIFY(!index.contains("qml", "views/List.qml"));
+
+    // A directory created later is watched once the rebuild has seen it
+    QSignalSpy rebuiltSpy(&index, &ResourceIndex::typeRebuilt);
+    QVERIFY(QDir().mkpath(path("qml/dialogs")));
+    QTRY_COMPARE(rebuiltSpy.count(), 1);
+    writeFile(path("qml/dialogs/Confirm.qml"));
+    QTRY_VERIFY(index.contains("qml", "dialogs/Confirm.qml"));
+}
+
+void TestResourceIndex::testRebuildClearsMissingResources()
+{
+    const QString base = path("resources");
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+
+    // The miss is remembered, so asking again neither scans nor warns
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Resource not found: \"Late.qml\""));
+    QVERIFY(manager.getResourcePath("qml", "Late.qml").isEmpty());
+    QVERIFY(manager.getResourcePath("qml", "Late.qml").isEmpty());
+
+    // Until the type is rebuilt after the file appears
+    writeFile(base + "/qml/Late.qml");
+    QTRY_COMPARE(manager.getResourcePath("qml", "Late.qml"), base + "/qml/Late.qml");
+    QVERIFY(manager.getAvailableQmlResources().contains("Late.qml"));
+}
+
+QTEST_GUILESS_MAIN(TestResourceIndex)
+#include "test_resource_index.moc"
@@ -0,0 +1,243 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include "core/ResourceStats.h"
+#include "core/ResourceManager.h"
+
+class TestResourceStats : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCountersBySource();
+    void testLatencyHistogram();
+    void testSlowestPaths();
+    void testErrors();
+    void testReset();
+    void testTrackedPathsAreBounded();
+    void testManagerCountsCacheHits();
+    void testManagerRecordsImages();
+    void testManagerStatisticsDisabled();
+
+private:
+    static void writeFile(const QString &path, const QByteArray &data);
+    static QVariantMap typeStats(const ResourceManager &manager, const QString &type);
+};
+
+void TestResourceStats::writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), data.size());
+}
+
+QVariantMap TestResourceStats::typeStats(const ResourceManager &manager, const QString &type)
+{
+    return manager.resourceStatistics().value("types").toMap().value(type).toMap();
+}
+
+void TestResourceStats::testCountersBySource()
+{
+    ResourceStats stats;
+    stats.recordRead("qml", "/r/qml/Main.qml", 100, 2000, ResourceStats::Disk);
+    stats.recordRead("qml", "/r/qml/Other.qml", 50, 3000, ResourceStats::Archive);
+    stats.recordRead("qml", "/r/qml/Main.qml", 100, 10, ResourceStats::Cache);
+    stats.recordRead("qml", "/r/qml/Main.qml", 100, 10, ResourceStats::Pending);
+    stats.recordRead("", "/elsewhere/file.bin", 8, 1000, ResourceStats::Disk);
+
+    const QJsonObject types = stats.toJson()["types"].toObject();
+    const QJsonObject qml = types["qml"].toObject();
+    QCOMPARE(qml["reads"].toInt(), 4);
+    QCOMPARE(qml["bytes"].toInt(), 350);
+    QCOMPARE(qml["diskReads"].toInt(), 1);
+    QCOMPARE(qml["archiveReads"].toInt(), 1);
+    // Pending writes are served from memory, like the cache
+    QCOMPARE(qml["cacheHits"].toInt(), 2);
+    QCOMPARE(qml["cacheMisses"].toInt(), 2);
+    QCOMPARE(qml["diskTimeMs"].toDouble(), 0.002);
+
+    // Paths outside every type directory are reported as "other"
+    QCOMPARE(types["other"].toObject()["reads"].toInt(), 1);
+}
+
+void TestResourceStats::testLatencyHistogram()
+{
+    ResourceStats stats;
+    stats.recordRead("qml", "a", 0, 500, ResourceStats::Disk);             // under 1 us
+    stats.recordRead("qml", "b", 0, 1500 * 1000, ResourceStats::Disk);     // 1.5 ms
+    stats.recordRead("qml", "c", 0, qint64(1) << 50, ResourceStats::Disk); // past the last bucket
+    stats.recordRead("qml", "a", 0, 0, ResourceStats::Cache);              // hits are not timed
+
+    const QJsonArray latency = stats.toJson()["types"].toObject()["qml"].toObject()["latencyHistogramLog2Us"].toArray();
+    QCOMPARE(latency.size(), ResourceStats::kLatencyBuckets);
+    QCOMPARE(latency.at(0).toInt(), 1);
+    QCOMPARE(latency.at(10).toInt(), 1);
+    QCOMPARE(latency.at(ResourceStats::kLatencyBuckets - 1).toInt(), 1);
+
+    int total = 0;
+    for (const QJsonValue &count : latency) {
+        total += count.toInt();
+    }
+    QCOMPARE(total, 3);
+}
+
+void TestResourceStats::testSlowestPaths()
+{
+    ResourceStats stats;
+    stats.recordRead("qml", "fast", 0, 1000, ResourceStats::Disk);
+    stats.recordRead("qml", "slow", 0, 9000000, ResourceStats::Disk);
+    stats.recordRead("images", "medium", 0, 4000000, ResourceStats::Archive);
+    stats.recordRead("qml", "fast", 0, 2000000, ResourceStats::Disk);
+    stats.recordRead("qml", "cached", 0, 50000000, ResourceStats::Cache);
+
+    const QJsonArray slowest = stats.toJson(10)["slowestPaths"].toArray();
+    QCOMPARE(slowest.size(), 3);
+    QCOMPARE(slowest.at(0).toObject()["path"].toString(), QStringLiteral("slow"));
+    QCOMPARE(slowest.at(1).toObject()["path"].toString(), QStringLiteral("medium"));
+    QCOMPARE(slowest.at(1).toObject()["type"].toString(), QStringLiteral("images"));
+
+    const QJsonObject fast = slowest.at(2).toObject();
+    QCOMPARE(fast["path"].toString(), QStringLiteral("fast"));
+    QCOMPARE(fast["loads"].toInt(), 2);
+    QCOMPARE(fast["maxMs"].toDouble(), 2.0);
+    QCOMPARE(fast["totalMs"].toDouble(), 2.001);
+
+    QCOMPARE(stats.toJson(1)["slowestPaths"].toArray().size(), 1);
+    QVERIFY(stats.toJson(0)["slowestPaths"].toArray().isEmpty());
+    QVERIFY(stats.toJson(-1)["slowestPaths"].toArray().isEmpty());
+}
+
+void TestResourceStats::testErrors()
+{
+    ResourceStats stats;
+    stats.recordError("config", "/r/config/missing.json");
+    stats.recordError("config", "/r/config/missing.json");
+
+    const QJsonObject result = stats.toJson();
+    const QJsonObject config = result["types"].toObject()["config"].toObject();
+    QCOMPARE(config["errors"].toInt(), 2);
+    QCOMPARE(config["reads"].toInt(), 0);
+    QCOMPARE(result["trackedPaths"].toInt(), 0);
+}
+
+void TestResourceStats::testReset()
+{
+    ResourceStats stats;
+    for (int i = 0; i < ResourceStats::kMaxTrackedPaths + 1; ++i) {
+        stats.recordRead("qml", QString::number(i), 1, i, ResourceStats::Disk);
+    }
+    QVERIFY(stats.toJson()["droppedPaths"].toInt() > 0);
+
+    stats.reset();
+    const QJsonObject result = stats.toJson();
+    QVERIFY(result["types"].toObject().isEmpty());
+    QVERIFY(result["slowestPaths"].toArray().isEmpty());
+    QCOMPARE(result["trackedPaths"].toInt(), 0);
+    QCOMPARE(result["droppedPaths"].toInt(), 0);
+}
+
+void TestResourceStats::testTrackedPathsAreBounded()
+{
+    ResourceStats stats;
+    const int paths = ResourceStats::kMaxTrackedPaths * 4;
+    // Every eighth path is slow: never more than a prune keeps
+    for (int i = 0; i < paths; ++i) {
+        const qint64 elapsedNs = i % 8 == 0 ? 1000000 + i : i;
+        stats.recordRead("qml", QStringLiteral("path%1").arg(i), 1, elapsedNs, ResourceStats::Disk);
+    }
+
+    const QJsonObject result = stats.toJson(paths);
+    const int tracked = result["trackedPaths"].toInt();
+    QVERIFY(tracked <= ResourceStats::kMaxTrackedPaths);
+    QCOMPARE(tracked + result["droppedPaths"].toInt(), paths);
+
+    // Per-type counters are not affected by the cap
+    QCOMPARE(result["types"].toObject()["qml"].toObject()["reads"].toInt(), paths);
+
+    // The slow paths all survive, slowest first
+    const QJsonArray slowest = result["slowestPaths"].toArray();
+    QCOMPARE(slowest.size(), tracked);
+    QCOMPARE(slowest.at(0).toObject()["path"].toString(), QStringLiteral("path%1").arg(paths - 8));
+    for (int i = 0; i < paths / 8; ++i) {
+        QVERIFY(slowest.at(i).toObject()["maxMs"].toDouble() >= 1.0);
+    }
+
+    // A tracked path keeps accumulating without pruning
+    const int dropped = result["droppedPaths"].toInt();
+    stats.recordRead("qml", "path0", 1, 5, ResourceStats::Disk);
+    QCOMPARE(stats.toJson()["droppedPaths"].toInt(), dropped);
+}
+
+void TestResourceStats::testManagerCountsCacheHits()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString base = dir.filePath("resources");
+    const QString configPath = base + "/config/app.json";
+    writeFile(configPath, "{ \"name\": \"stats\" }");
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    manager.resetStatistics();
+
+    QVERIFY(!manager.readBinaryResource(configPath).isEmpty());
+    QVERIFY(!manager.readBinaryResource(configPath).isEmpty());
+
+    const QVariantMap config = typeStats(manager, "config");
+    QCOMPARE(config.value("reads").toInt(), 2);
+    QCOMPARE(config.value("diskReads").toInt(), 1);
+    QCOMPARE(config.value("cacheHits").toInt(), 1);
+
+    const QVariantList slowest = manager.resourceStatistics().value("slowestPaths").toList();
+    QCOMPARE(slowest.size(), 1);
+    QCOMPARE(slowest.first().toMap().value("path").toString(), configPath);
+    QCOMPARE(slowest.first().toMap().value("loads").toInt(), 1);
+}
+
+void TestResourceStats::testManagerRecordsImages()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString base = dir.filePath("resources");
+    writeFile(base + "/images/icon.png", QByteArray(256, 'x'));
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    manager.resetStatistics();
+
+    QCOMPARE(manager.imageData("icon.png").size(), 256);
+    QVERIFY(manager.imageData("missing.png").isEmpty());
+
+    const QVariantMap images = typeStats(manager, "images");
+    QCOMPARE(images.value("reads").toInt(), 1);
+    QCOMPARE(images.value("bytes").toInt(), 256);
+    QCOMPARE(images.value("diskReads").toInt(), 1);
+    QCOMPARE(images.value("errors").toInt(), 1);
+
+    const QVariantList slowest = manager.resourceStatistics().value("slowestPaths").toList();
+    QCOMPARE(slowest.size(), 1);
+    QCOMPARE(slowest.first().toMap().value("path").toString(), base + "/images/icon.png");
+}
+
+void TestResourceStats::testManagerStatisticsDisabled()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString base = dir.filePath("resources");
+    writeFile(base + "/config/app.json", "{}");
+    writeFile(base + "/images/icon.png", QByteArray(16, 'x'));
+
+    ResourceManager manager;
+    QVERIFY(manager.initialize(base));
+    manager.resetStatistics();
+    manager.setStatisticsEnabled(false);
+
+    QVERIFY(!manager.readBinaryResource(base + "/config/app.json").isEmpty());
+    QVERIFY(!manager.imageData("icon.png").isEmpty());
+    QVERIFY(manager.imageData("missing.png").isEmpty());
+    QVERIFY(manager.resourceStatistics().value("types").toMap().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestResourceStats)
+#include "test_resource_stats.moc"
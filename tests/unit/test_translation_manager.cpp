@@ -0,0 +1,259 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDataStream>
+#include "core/TranslationManager.h"
+
+class TestTranslationManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testLoadAndActivate();
+    void testSwitchKeepsCatalogs();
+    void testUnloadOneSource();
+    void testUnloadLocale();
+    void testSourceLoadedOnce();
+    void testLoadData();
+    void testRejectsInvalidCatalog();
+    void testLocaleFromFileName_data();
+    void testLocaleFromFileName();
+
+private:
+    QTemporaryDir *m_dir = nullptr;
+    TranslationManager *m_manager = nullptr;
+
+    QString writeCatalog(const QString &fileName, const QByteArray &sourceText, const QString &translation);
+    static QByteArray catalog(const QByteArray &sourceText, const QString &translation);
+    static QString translated(const char *sourceText);
+};
+
+namespace {
+const char kContext[] = "TestTranslationManager";
+
+// ELF hash of the source text, as QTranslator looks messages up by it
+quint32 elfHash(const QByteArray &text)
+{
+    quint32 h = 0;
+    for (const char c : text) {
+        h = (h << 4) + uchar(c);
+        const quint32 g = h & 0xf0000000;
+        if (g != 0) {
+            h ^= g >> 24;
+        }
+        h &= ~g;
+    }
+    return h != 0 ? h : 1;
+}
+}
+
+void TestTranslationManager::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_manager = new TranslationManager();
+}
+
+void TestTranslationManager::cleanup()
+{
+    delete m_manager;
+    delete m_dir;
+}
+
+// A one-message .qm: magic, then a hash block and a message block
+QByteArray TestTranslationManager::catalog(const QByteArray &sourceText, const QString &translation)
+{
+    static const uchar magic[16] = {0x3c, 0xb8, 0x64, 0x18, 0xca, 0xef, 0x9c, 0x95,
+                                    0xcd, 0x21, 0x1c, 0xbf, 0x60, 0xa1, 0xbd, 0xdd};
+    const QByteArray context(kContext);
+
+    QByteArray message;
+    {
+        QDataStream out(&message, QIODevice::WriteOnly);
+        out << quint8(0x03) << quint32(translation.size() * 2);
+        for (const QChar c : translation) {
+            out << quint16(c.unicode());
+        }
+        out << quint8(0x06) << quint32(sourceText.size());
+        out.writeRawData(sourceText.constData(), int(sourceText.size()));
+        out << quint8(0x07) << quint32(context.size());
+        out.writeRawData(context.constData(), int(context.size()));
+        out << quint8(0x01);
+    }
+
+    QByteArray data(reinterpret_cast<const char *>(magic), sizeof(magic));
+    QDataStream out(&data, QIODevice::WriteOnly | QIODevice::Append);
+    out << quint8(0x42) << quint32(8) << elfHash(sourceText) << quint32(0);
+    out << quint8(0x69) << quint32(message.size());
+    out.writeRawData(message.constData(), int(message.size()));
+    return data;
+}
+
+QString TestTranslationManager::writeCatalog(const QString &fileName, const QByteArray &sourceText,
+                                             const QString &translation)
+{
+    const QString path = m_dir->filePath(fileName);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(catalog(sourceText, translation));
+    return path;
+}
+
+QString TestTranslationManager::translated(const char *sourceText)
+{
+    return QCoreApplication::translate(kContext, sourceText);
+}
+
+void TestTranslationManager::testLoadAndActivate()
+{
+    QVERIFY(m_manager->loadFile("de", writeCatalog("app_de.qm", "Hello", "Hallo")));
+    QVERIFY(m_manager->loadFile("de", writeCatalog("plugin_de.qm", "Goodbye", "Auf Wiedersehen")));
+    QVERIFY(m_manager->isLoaded("de"));
+
+    // Loading does not install anything
+    QCOMPARE(translated("Hello"), QStringLiteral("Hello"));
+
+    QSignalSpy localeSpy(m_manager, &TranslationManager::localeChanged);
+    QVERIFY(m_manager->activate("de"));
+    QCOMPARE(localeSpy.count(), 1);
+    QCOMPARE(m_manager->currentLocale(), QStringLiteral("de"));
+    // Every catalog of the locale is installed
+    QCOMPARE(translated("Hello"), QStringLiteral("Hallo"));
+    QCOMPARE(translated("Goodbye"), QStringLiteral("Auf Wiedersehen"));
+
+    QVERIFY(m_manager->activate("de"));
+    QCOMPARE(localeSpy.count(), 1);
+    QVERIFY(!m_manager->activate("fr"));
+    QCOMPARE(m_manager->currentLocale(), QStringLiteral("de"));
+}
+
+void TestTranslationManager::testSwitchKeepsCatalogs()
+{
+    QVERIFY(m_manager->loadFile("de", writeCatalog("app_de.qm", "Hello", "Hallo")));
+    QVERIFY(m_manager->loadFile("fr", writeCatalog("app_fr.qm", "Hello", "Bonjour")));
+
+    QVERIFY(m_manager->activate("de"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Hallo"));
+    QVERIFY(m_manager->activate("fr"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Bonjour"));
+
+    // Switching back reuses the loaded catalogs
+    QVERIFY(m_manager->activate("de"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Hallo"));
+    QCOMPARE(m_manager->loadedLocales().size(), 2);
+}
+
+void TestTranslationManager::testUnloadOneSource()
+{
+    const QString app = writeCatalog("app_de.qm", "Hello", "Hallo");
+    const QString plugin = writeCatalog("plugin_de.qm", "Goodbye", "Auf Wiedersehen");
+    QVERIFY(m_manager->loadFile("de", app));
+    QVERIFY(m_manager->activate("de"));
+
+    // A catalog added to the active locale applies at once
+    QVERIFY(m_manager->loadFile("de", plugin));
+    QCOMPARE(translated("Goodbye"), QStringLiteral("Auf Wiedersehen"));
+
+    m_manager->unload("de", plugin);
+    QVERIFY(!m_manager->isLoaded("de", plugin));
+    QVERIFY(m_manager->isLoaded("de", app));
+    QCOMPARE(translated("Goodbye"), QStringLiteral("Goodbye"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Hallo"));
+    QCOMPARE(m_manager->currentLocale(), QStringLiteral("de"));
+
+    // The last catalog takes the locale with it
+    m_manager->unload("de", app);
+    QVERIFY(!m_manager->isLoaded("de"));
+    QVERIFY(m_manager->currentLocale().isEmpty());
+    QCOMPARE(translated("Hello"), QStringLiteral("Hello"));
+}
+
+void TestTranslationManager::testUnloadLocale()
+{
+    QVERIFY(m_manager->loadFile("de", writeCatalog("app_de.qm", "Hello", "Hallo")));
+    QVERIFY(m_manager->loadFile("fr", writeCatalog("app_fr.qm", "Hello", "Bonjour")));
+    QVERIFY(m_manager->activate("de"));
+
+    // Unloading another locale leaves the active one alone
+    m_manager->unload("fr");
+    QVERIFY(!m_manager->isLoaded("fr"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Hallo"));
+
+    m_manager->unload("de");
+    QVERIFY(m_manager->loadedLocales().isEmpty());
+    QVERIFY(m_manager->currentLocale().isEmpty());
+    QCOMPARE(translated("Hello"), QStringLiteral("Hello"));
+}
+
+void TestTranslationManager::testSourceLoadedOnce()
+{
+    const QString app = writeCatalog("app_de.qm", "Hello", "Hallo");
+    QVERIFY(m_manager->loadFile("de", app));
+    QVERIFY(m_manager->loadFile("de", app));
+
+    // One catalog, so one unload removes it
+    m_manager->unload("de", app);
+    QVERIFY(!m_manager->isLoaded("de"));
+
+    // The same source may serve two locales
+    QVERIFY(m_manager->loadFile("de", app));
+    QVERIFY(m_manager->loadFile("de_AT", app));
+    QVERIFY(m_manager->isLoaded("de_AT", app));
+}
+
+void TestTranslationManager::testLoadData()
+{
+    {
+        // The manager keeps the buffer QTranslator reads from
+        const QByteArray data = catalog("Hello", "Hola");
+        QVERIFY(m_manager->loadData("es", data, "memory:app_es"));
+    }
+    QVERIFY(m_manager->isLoaded("es", "memory:app_es"));
+    QVERIFY(m_manager->activate("es"));
+    QCOMPARE(translated("Hello"), QStringLiteral("Hola"));
+}
+
+void TestTranslationManager::testRejectsInvalidCatalog()
+{
+    const QString path = m_dir->filePath("broken_de.qm");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a catalog");
+    file.close();
+
+    QVERIFY(!m_manager->loadFile("de", path));
+    QVERIFY(!m_manager->loadData("de", "not a catalog", "memory:broken"));
+    QVERIFY(!m_manager->isLoaded("de"));
+    QVERIFY(!m_manager->activate("de"));
+}
+
+void TestTranslationManager::testLocaleFromFileName_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("locale");
+
+    QTest::newRow("language") << "app_de.qm" << "de";
+    QTest::newRow("region") << "app_zh_CN.qm" << "zh_CN";
+    QTest::newRow("script and region") << "app_sr_Latn_RS.qm" << "sr_Latn_RS";
+    QTest::newRow("numeric region") << "app_es_419.qm" << "es_419";
+    QTest::newRow("underscored prefix") << "my_app_de.qm" << "de";
+    QTest::newRow("underscored prefix and region") << "my_app_pt_BR.qm" << "pt_BR";
+    QTest::newRow("path") << "/opt/app/translations/app_fr.qm" << "fr";
+    QTest::newRow("no suffix") << "translations.qm" << "";
+    QTest::newRow("region only") << "settings_CN.qm" << "";
+}
+
+void TestTranslationManager::testLocaleFromFileName()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QString, locale);
+    QCOMPARE(TranslationManager::localeFromFileName(fileName), locale);
+}
+
+QTEST_GUILESS_MAIN(TestTranslationManager)
+#include "test_translation_manager.moc"
@@ -0,0 +1,51 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include "ResourceArchive.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("pack-resources");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Packs a resource directory into a single memory-mappable archive.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("source", "Resource directory to pack (e.g. resources/).");
+    parser.addPositionalArgument("output", "Archive file to write (e.g. resources.pak).");
+
+    QCommandLineOption noCompressOption("no-compress", "Store every entry uncompressed.");
+    QCommandLineOption levelOption("level", "zlib compression level (0-9, -1 for default).", "level", "-1");
+    QCommandLineOption ratioOption("max-ratio",
+                                   "Keep an entry compressed only if it shrinks to at most this fraction.",
+                                   "ratio", "0.9");
+    QCommandLineOption filterOption("filter", "Only pack files matching this wildcard (repeatable).", "pattern");
+    parser.addOption(noCompressOption);
+    parser.addOption(levelOption);
+    parser.addOption(ratioOption);
+    parser.addOption(filterOption);
+
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+
+    ResourceArchive::PackOptions options;
+    options.compress = !parser.isSet(noCompressOption);
+    options.compressionLevel = parser.value(levelOption).toInt();
+    options.maxCompressionRatio = parser.value(ratioOption).toDouble();
+    options.nameFilters = parser.values(filterOption);
+
+    QString errorString;
+    if (!ResourceArchive::pack(arguments.at(0), arguments.at(1), options, &errorString)) {
+        QTextStream(stderr) << "pack-resources: " << errorString << Qt::endl;
+        return 1;
+    }
+
+    return 0;
+}